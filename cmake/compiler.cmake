@@ -50,3 +50,7 @@ endif()
 if (GALERA_GU_DEBUG_MUTEX)
   add_definitions(-DGU_DEBUG_MUTEX)
 endif()
+
+if (GALERA_EVS_INPUT_MAP_RING)
+  add_definitions(-DGCOMM_EVS_INPUT_MAP_RING)
+endif()
@@ -8,6 +8,7 @@
 #include "gu_lock.hpp"
 #include "gu_throw.hpp"
 
+#include <cstring> // strerror
 #include <map>
 #include <algorithm> // std::for_each
 
@@ -20,11 +21,31 @@ static const bool cert_debug_on(false);
 
 #define CERT_PARAM_LOG_CONFLICTS galera::Certification::PARAM_LOG_CONFLICTS
 #define CERT_PARAM_OPTIMISTIC_PA galera::Certification::PARAM_OPTIMISTIC_PA
+#define CERT_PARAM_PIPELINE      galera::Certification::PARAM_PIPELINE
+#define CERT_PARAM_INDEX_IMPL    galera::Certification::PARAM_INDEX_IMPL
+#define CERT_PARAM_PURGE_KEYS_THRESHOLD \
+    galera::Certification::PARAM_PURGE_KEYS_THRESHOLD
+#define CERT_PARAM_PURGE_BYTES_THRESHOLD \
+    galera::Certification::PARAM_PURGE_BYTES_THRESHOLD
+#define CERT_PARAM_PURGE_TRXS_THRESHOLD \
+    galera::Certification::PARAM_PURGE_TRXS_THRESHOLD
+#define CERT_PARAM_PURGE_STEP_KEYS \
+    galera::Certification::PARAM_PURGE_STEP_KEYS
 
 static std::string const CERT_PARAM_PREFIX("cert.");
 
 std::string const CERT_PARAM_LOG_CONFLICTS(CERT_PARAM_PREFIX + "log_conflicts");
 std::string const CERT_PARAM_OPTIMISTIC_PA(CERT_PARAM_PREFIX + "optimistic_pa");
+std::string const CERT_PARAM_PIPELINE     (CERT_PARAM_PREFIX + "pipeline");
+std::string const CERT_PARAM_INDEX_IMPL   (CERT_PARAM_PREFIX + "index_impl");
+std::string const CERT_PARAM_PURGE_KEYS_THRESHOLD (CERT_PARAM_PREFIX +
+                                                   "purge_keys_threshold");
+std::string const CERT_PARAM_PURGE_BYTES_THRESHOLD(CERT_PARAM_PREFIX +
+                                                   "purge_bytes_threshold");
+std::string const CERT_PARAM_PURGE_TRXS_THRESHOLD (CERT_PARAM_PREFIX +
+                                                   "purge_trxs_threshold");
+std::string const CERT_PARAM_PURGE_STEP_KEYS      (CERT_PARAM_PREFIX +
+                                                   "purge_step_keys");
 
 static std::string const CERT_PARAM_MAX_LENGTH   (CERT_PARAM_PREFIX +
                                                   "max_length");
@@ -33,6 +54,16 @@ static std::string const CERT_PARAM_LENGTH_CHECK (CERT_PARAM_PREFIX +
 
 static std::string const CERT_PARAM_LOG_CONFLICTS_DEFAULT("no");
 static std::string const CERT_PARAM_OPTIMISTIC_PA_DEFAULT("yes");
+static std::string const CERT_PARAM_PIPELINE_DEFAULT     ("no");
+static std::string const CERT_PARAM_INDEX_IMPL_DEFAULT   ("hash");
+static std::string const CERT_PARAM_PURGE_KEYS_THRESHOLD_DEFAULT ("1024");
+static std::string const CERT_PARAM_PURGE_BYTES_THRESHOLD_DEFAULT("128M");
+static std::string const CERT_PARAM_PURGE_TRXS_THRESHOLD_DEFAULT ("127");
+static std::string const CERT_PARAM_PURGE_STEP_KEYS_DEFAULT      ("0");
+
+/* index purge step latency histogram bins, seconds */
+static std::string const CERT_PURGE_LATENCY_BINS
+("0.0,0.0001,0.0005,0.001,0.005,0.01,0.05,0.1,0.5,1.");
 
 /*** It is EXTREMELY important that these constants are the same on all nodes.
  *** Don't change them ever!!! ***/
@@ -44,6 +75,15 @@ galera::Certification::register_params(gu::Config& cnf)
 {
     cnf.add(CERT_PARAM_LOG_CONFLICTS, CERT_PARAM_LOG_CONFLICTS_DEFAULT);
     cnf.add(CERT_PARAM_OPTIMISTIC_PA, CERT_PARAM_OPTIMISTIC_PA_DEFAULT);
+    cnf.add(CERT_PARAM_PIPELINE,      CERT_PARAM_PIPELINE_DEFAULT);
+    cnf.add(CERT_PARAM_INDEX_IMPL,    CERT_PARAM_INDEX_IMPL_DEFAULT);
+    cnf.add(CERT_PARAM_PURGE_KEYS_THRESHOLD,
+            CERT_PARAM_PURGE_KEYS_THRESHOLD_DEFAULT);
+    cnf.add(CERT_PARAM_PURGE_BYTES_THRESHOLD,
+            CERT_PARAM_PURGE_BYTES_THRESHOLD_DEFAULT);
+    cnf.add(CERT_PARAM_PURGE_TRXS_THRESHOLD,
+            CERT_PARAM_PURGE_TRXS_THRESHOLD_DEFAULT);
+    cnf.add(CERT_PARAM_PURGE_STEP_KEYS, CERT_PARAM_PURGE_STEP_KEYS_DEFAULT);
     /* The defaults below are deliberately not reflected in conf: people
      * should not know about these dangerous setting unless they read RTFM. */
     cnf.add(CERT_PARAM_MAX_LENGTH);
@@ -70,6 +110,20 @@ length_check(const gu::Config& conf)
         return gu::Config::from_config<int>(CERT_PARAM_LENGTH_CHECK_DEFAULT);
 }
 
+/* returns true if open addressing v3+ index implementation is configured */
+static bool
+index_impl_flat(const gu::Config& conf)
+{
+    std::string const impl(conf.get(CERT_PARAM_INDEX_IMPL));
+
+    if (impl == "flat") return true;
+    if (impl == "hash") return false;
+
+    gu_throw_error(EINVAL) << "Unrecognized value '" << impl << "' for '"
+                           << CERT_PARAM_INDEX_IMPL
+                           << "', expected 'hash' or 'flat'";
+}
+
 void
 galera::Certification::purge_for_trx_v1to2(TrxHandle* trx)
 {
@@ -112,28 +166,56 @@ galera::Certification::purge_for_trx_v1to2(TrxHandle* trx)
     }
 }
 
+void
+galera::Certification::prepare_keys_v3(TrxHandle* trx)
+{
+    const KeySetIn&         key_set(trx->write_set_in().keyset());
+    TrxHandle::CertKeysNG&  keys(trx->cert_keys_ng_);
+    size_t const            key_count(key_set.count());
+
+    if (keys.size() == key_count) return; // already prepared
+
+    assert(keys.empty());
+    keys.reserve(key_count);
+
+    key_set.rewind();
+    for (size_t i(0); i < key_count; ++i)
+    {
+        keys.push_back(key_set.next());
+    }
+}
+
+void
+galera::Certification::prepare(TrxHandle* trx) const
+{
+    if (pipeline_ && trx->new_version() && !trx->preordered())
+    {
+        prepare_keys_v3(trx);
+    }
+}
+
 void
 galera::Certification::purge_for_trx_v3(TrxHandle* trx)
 {
-    const KeySetIn& keys(trx->write_set_in().keyset());
-    keys.rewind();
+    TrxKeys keys(trx);
 
     // Unref all referenced and remove if was referenced only by us
     for (long i = 0; i < keys.count(); ++i)
     {
-        const KeySet::KeyPart& kp(keys.next());
+        const KeySet::KeyPart  kp(keys.next());
+        CertIndexShard&        sh(shard(kp));
+        gu::Lock               lock(sh.mutex);
 
         KeyEntryNG ke(kp);
-        CertIndexNG::iterator const ci(cert_index_ng_.find(&ke));
+        KeyEntryNG* const kep(sh.find(ke));
 
-//        assert(ci != cert_index_ng_.end());
-        if (gu_unlikely(cert_index_ng_.end() == ci))
+//        assert(kep != NULL);
+        if (gu_unlikely(NULL == kep))
         {
             log_warn << "Missing key";
             continue;
         }
 
-        KeyEntryNG* const kep(*ci);
         assert(kep->referenced());
 
         wsrep_key_type_t const p(kp.wsrep_type(trx->version()));
@@ -144,7 +226,7 @@ galera::Certification::purge_for_trx_v3(TrxHandle* trx)
 
             if (kep->referenced() == false)
             {
-                cert_index_ng_.erase(ci);
+                sh.erase(kep);
                 delete kep;
             }
         }
@@ -588,23 +670,28 @@ certify_and_depend_v3to4(const galera::KeyEntryNG*   const found,
     }
 }
 
-/* returns true on collision, false otherwise */
+/* returns true on collision, false otherwise. Matching index entry
+ * (found or created) is returned in entry, NULL if there is none.
+ * cert_index_ng is the index shard of the key, it must be locked. */
 static bool
-certify_v3to4(galera::Certification::CertIndexNG& cert_index_ng,
-              const galera::KeySet::KeyPart&      key,
-              galera::TrxHandle*                  trx,
-              bool const                          store_keys,
-              bool const                          log_conflicts)
+certify_v3to4(galera::Certification::CertIndexShard& cert_index_ng,
+              const galera::KeySet::KeyPart&         key,
+              galera::TrxHandle*                     trx,
+              bool const                             store_keys,
+              bool const                             log_conflicts,
+              galera::KeyEntryNG*&                   entry)
 {
     galera::KeyEntryNG ke(key);
-    galera::Certification::CertIndexNG::iterator ci(cert_index_ng.find(&ke));
+    galera::KeyEntryNG* const kep(cert_index_ng.find(ke));
 
-    if (cert_index_ng.end() == ci)
+    if (NULL == kep)
     {
+        entry = 0;
+
         if (store_keys)
         {
-            galera::KeyEntryNG* const kep(new galera::KeyEntryNG(ke));
-            ci = cert_index_ng.insert(kep).first;
+            entry = new galera::KeyEntryNG(ke);
+            cert_index_ng.insert(entry);
 
             cert_debug << "created new entry";
         }
@@ -614,7 +701,7 @@ certify_v3to4(galera::Certification::CertIndexNG& cert_index_ng,
     {
         cert_debug << "found existing entry";
 
-        galera::KeyEntryNG* const kep(*ci);
+        entry = kep;
         // Note: For we skip certification for isolated trxs, only
         // cert index and key_list is populated.
         return (!trx->is_toi() &&
@@ -633,17 +720,24 @@ galera::Certification::do_test_v3to4(TrxHandle* trx, bool store_keys)
     size_t prev_cert_index_size(cert_index_.size());
 #endif // NDEBUG
 
-    const KeySetIn& key_set(trx->write_set_in().keyset());
-    long const      key_count(key_set.count());
+    /* keys parsed in advance by prepare() are used if cert.pipeline is on,
+     * otherwise the key set is walked directly */
+    TrxKeys         keys(trx);
+    long const      key_count(keys.count());
     long            processed(0);
 
-    key_set.rewind();
+    /* tests are serialized by mutex_, shards are locked only against
+     * purge, which must not delete entries matched below */
+    ShardsLock const shards_lock(*this, keys);
+
+    matched_entries_.resize(key_count);
 
     for (; processed < key_count; ++processed)
     {
-        const KeySet::KeyPart& key(key_set.next());
+        const KeySet::KeyPart key(keys.next());
 
-        if (certify_v3to4(cert_index_ng_, key, trx, store_keys, log_conflicts_))
+        if (certify_v3to4(shard(key), key, trx, store_keys,
+                          log_conflicts_, matched_entries_[processed]))
         {
             goto cert_fail;
         }
@@ -655,23 +749,18 @@ galera::Certification::do_test_v3to4(TrxHandle* trx, bool store_keys)
     {
         assert (key_count == processed);
 
-        key_set.rewind();
+        /* no need to look the keys up again: entries matched or created
+         * in the loop above are still in the index */
+        keys.rewind();
         for (long i(0); i < key_count; ++i)
         {
-            const KeySet::KeyPart& k(key_set.next());
-            KeyEntryNG ke(k);
-            CertIndexNG::const_iterator ci(cert_index_ng_.find(&ke));
-
-            if (ci == cert_index_ng_.end())
-            {
-                gu_throw_fatal << "could not find key '" << k
-                               << "' from cert index";
-            }
+            const KeySet::KeyPart  k(keys.next());
+            KeyEntryNG* const kep(matched_entries_[i]);
 
-            KeyEntryNG* const kep(*ci);
+            assert(kep != 0);
+            assert(shard(k).find(*kep) == kep);
 
             kep->ref(k.wsrep_type(trx->version()), k, trx);
-
         }
 
         if (trx->pa_unsafe()) last_pa_unsafe_ = trx->global_seqno();
@@ -690,26 +779,26 @@ cert_fail:
     if (store_keys == true)
     {
         /* Clean up key entries allocated for this trx */
-        key_set.rewind();
+        keys.rewind();
 
         /* 'strictly less' comparison is essential in the following loop:
          * processed key failed cert and was not added to index */
         for (long i(0); i < processed; ++i)
         {
-            KeyEntryNG ke(key_set.next());
+            const KeySet::KeyPart kp(keys.next());
+            KeyEntryNG            ke(kp);
+            CertIndexShard&       sh(shard(kp));
 
             // Clean up cert_index_ from entries which were added by this trx
-            CertIndexNG::iterator ci(cert_index_ng_.find(&ke));
+            KeyEntryNG* const kep(sh.find(ke));
 
-            if (gu_likely(ci != cert_index_ng_.end()))
+            if (gu_likely(kep != NULL))
             {
-                KeyEntryNG* kep(*ci);
-
                 if (kep->referenced() == false)
                 {
                     // kel was added to cert_index_ by this trx -
                     // remove from cert_index_ and fall through to delete
-                    cert_index_ng_.erase(ci);
+                    sh.erase(kep);
                 }
                 else continue;
 
@@ -817,6 +906,7 @@ galera::Certification::do_test(TrxHandle* trx, bool store_keys)
         break;
     case 3:
     case 4:
+    case 5:
         res = do_test_v3to4(trx, store_keys);
         break;
     default:
@@ -827,11 +917,12 @@ galera::Certification::do_test(TrxHandle* trx, bool store_keys)
     if (store_keys == true && res == TEST_OK)
     {
         ++trx_count_;
+        size_t const index_size(cert_index_.size() + index_ng_size());
         gu::Lock lock(stats_mutex_);
         ++n_certified_;
         deps_dist_ += (trx->global_seqno() - trx->depends_seqno());
         cert_interval_ += (trx->global_seqno() - trx->last_seen_seqno() - 1);
-        index_size_ = (cert_index_.size() + cert_index_ng_.size());
+        index_size_ = index_size;
     }
 
     byte_count_ += trx->size();
@@ -887,6 +978,8 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     trx_map_               (),
     cert_index_            (),
     cert_index_ng_         (),
+    index_ng_entries_      (0),
+    matched_entries_       (),
     deps_set_              (),
     service_thd_           (thd),
     gcache_                (gcache),
@@ -895,6 +988,7 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
 #else
     mutex_                 (),
 #endif /* HAVE_PSI_INTERFACE */
+    purge_mutex_           (),
     trx_size_warn_count_   (0),
     initial_position_      (-1),
     position_              (-1),
@@ -918,8 +1012,29 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     max_length_            (max_length(conf)),
     max_length_check_      (length_check(conf)),
     log_conflicts_         (conf.get<bool>(CERT_PARAM_LOG_CONFLICTS)),
-    optimistic_pa_         (conf.get<bool>(CERT_PARAM_OPTIMISTIC_PA))
-{}
+    optimistic_pa_         (conf.get<bool>(CERT_PARAM_OPTIMISTIC_PA)),
+    pipeline_              (conf.get<bool>(CERT_PARAM_PIPELINE)),
+    purge_keys_threshold_  (conf.get<size_t>(CERT_PARAM_PURGE_KEYS_THRESHOLD)),
+    purge_bytes_threshold_ (conf.get<size_t>(CERT_PARAM_PURGE_BYTES_THRESHOLD)),
+    purge_trxs_threshold_  (conf.get<size_t>(CERT_PARAM_PURGE_TRXS_THRESHOLD)),
+    purge_step_keys_       (conf.get<size_t>(CERT_PARAM_PURGE_STEP_KEYS)),
+    purge_target_          (-1),
+    purge_pos_             (-1),
+    purge_exit_            (false),
+    purge_cond_            (),
+    purge_done_            (),
+    purge_thd_             (),
+    purge_thd_running_     (false),
+    purge_latency_         (CERT_PURGE_LATENCY_BINS)
+{
+    bool const flat(index_impl_flat(conf));
+
+    for (size_t i(0); i < CERT_INDEX_SHARDS; ++i)
+    {
+        cert_index_ng_[i].set_flat(flat);
+        cert_index_ng_[i].set_entries_counter(&index_ng_entries_);
+    }
+}
 
 
 galera::Certification::~Certification()
@@ -936,6 +1051,16 @@ galera::Certification::~Certification()
     log_debug << "avg cert interval "          << avg_cert_interval;
     log_debug << "cert index size "            << index_size;
 
+    bool purge_thd_running;
+    {
+        gu::Lock lock(mutex_);
+        purge_exit_ = true;
+        purge_cond_.signal();
+        purge_thd_running = purge_thd_running_;
+    }
+    if (purge_thd_running) gu_thread_join(purge_thd_, NULL);
+
+    gu::Lock purge_lock(purge_mutex_);
     gu::Lock lock(mutex_);
 
     for_each(trx_map_.begin(), trx_map_.end(), PurgeAndDiscard(*this));
@@ -956,19 +1081,21 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
     case 2:
     case 3:
     case 4:
+    case 5:
         break;
     default:
         gu_throw_fatal << "certification/trx version "
                        << version << " not supported";
     }
 
+    gu::Lock purge_lock(purge_mutex_);
     gu::Lock lock(mutex_);
 
     if (seqno >= position_)
     {
         std::for_each(trx_map_.begin(), trx_map_.end(), PurgeAndDiscard(*this));
         assert(cert_index_.size() == 0);
-        assert(cert_index_ng_.size() == 0);
+        assert(index_ng_size() == 0);
     }
     else
     {
@@ -976,12 +1103,15 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
                  << seqno;
         std::for_each(cert_index_.begin(), cert_index_.end(),
                       gu::DeleteObject());
-        std::for_each(cert_index_ng_.begin(), cert_index_ng_.end(),
-                      gu::DeleteObject());
+        for (size_t i(0); i < CERT_INDEX_SHARDS; ++i)
+        {
+            CertIndexShard& sh(cert_index_ng_[i]);
+            gu::Lock shard_lock(sh.mutex);
+            sh.clear();
+        }
         std::for_each(trx_map_.begin(), trx_map_.end(),
                       Unref2nd<TrxMap::value_type>());
         cert_index_.clear();
-        cert_index_ng_.clear();
     }
 
     trx_map_.clear();
@@ -989,6 +1119,10 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
     log_info << "Assign initial position for certification: " << seqno
              << ", protocol version: " << version;
 
+    purge_target_          = seqno; // cancel scheduled background purge
+    purge_pos_             = seqno;
+    purge_done_.broadcast();
+
     initial_position_      = seqno;
     position_              = seqno;
     safe_to_discard_seqno_ = seqno;
@@ -1063,12 +1197,277 @@ galera::Certification::purge_trxs_upto_(wsrep_seqno_t const seqno,
 }
 
 
+wsrep_seqno_t
+galera::Certification::purge_trxs_upto(wsrep_seqno_t const seqno,
+                                       bool const          handle_gcache)
+{
+    if (handle_gcache)
+    {
+        gu::Lock lock(mutex_);
+
+        if (version_ >= 3 && purge_step_keys_ > 0 && start_purge_thd())
+        {
+            /* leave it to background purge thread */
+            wsrep_seqno_t const purge_seqno
+                (std::min(seqno, get_safe_to_discard_seqno_()));
+
+            if (purge_seqno > purge_target_)
+            {
+                purge_target_ = purge_seqno;
+                purge_cond_.signal();
+            }
+
+            return purge_seqno;
+        }
+    }
+
+    gu::datetime::Date const start(gu::datetime::Date::monotonic());
+    gu::Lock purge_lock(purge_mutex_);
+
+    TrxMap        purged;
+    wsrep_seqno_t purge_seqno;
+    {
+        gu::Lock lock(mutex_);
+
+        const wsrep_seqno_t stds(get_safe_to_discard_seqno_());
+        // assert(seqno <= get_safe_to_discard_seqno());
+        // Note: setting trx committed is not done in total order so
+        // safe to discard seqno may decrease. Enable assertion above when
+        // this issue is fixed.
+        purge_seqno = std::min(seqno, stds);
+
+        /* old style index is not sharded, purge it under mutex_ */
+        if (version_ < 3) return purge_trxs_upto_(purge_seqno, handle_gcache);
+
+        assert (purge_seqno > 0);
+
+        TrxMap::iterator purge_bound(trx_map_.upper_bound(purge_seqno));
+        purged.insert(trx_map_.begin(), purge_bound);
+        trx_map_.erase(trx_map_.begin(), purge_bound);
+    }
+
+    log_debug << "purging index up to " << purge_seqno << ", "
+              << purged.size() << " trxs";
+
+    /* index shards are locked one at a time in purge_for_trx_v3(), so
+     * certification of keys from other shards may proceed meanwhile */
+    for_each(purged.begin(), purged.end(), PurgeAndDiscard(*this));
+
+    /* write sets must stay in gcache while their keys are in the index */
+    if (handle_gcache)
+    {
+        log_debug << "releasing seqno from gcache " << purge_seqno;
+        service_thd_.release_seqno(purge_seqno);
+    }
+
+    record_purge_latency(start);
+
+    return purge_seqno;
+}
+
+
+void
+galera::Certification::purge_step()
+{
+    gu::datetime::Date const start(gu::datetime::Date::monotonic());
+    /* assign_initial_position() takes purge_mutex_ too, so no outdated
+     * seqno can be released to gcache after it has returned */
+    gu::Lock purge_lock(purge_mutex_);
+
+    TrxMap        purged;
+    wsrep_seqno_t release_seqno;
+    {
+        gu::Lock lock(mutex_);
+
+        if (purge_pos_ >= purge_target_) return; // canceled
+
+        wsrep_seqno_t const purge_seqno
+            (std::min(purge_target_, get_safe_to_discard_seqno_()));
+
+        /* take trxs holding up to purge_step_keys_ keys, at least one */
+        TrxMap::iterator purge_bound(trx_map_.begin());
+        size_t           keys(0);
+        while (purge_bound != trx_map_.end() &&
+               purge_bound->first <= purge_seqno &&
+               (0 == keys || keys < purge_step_keys_))
+        {
+            keys += purge_bound->second->write_set_in().keyset().count();
+            ++purge_bound;
+        }
+
+        purged.insert(trx_map_.begin(), purge_bound);
+        trx_map_.erase(trx_map_.begin(), purge_bound);
+
+        if (purge_bound == trx_map_.end() || purge_bound->first > purge_seqno)
+        {
+            release_seqno = purge_seqno;
+            purge_pos_    = purge_target_;
+            purge_done_.broadcast();
+        }
+        else
+        {
+            release_seqno = purged.rbegin()->first;
+            purge_pos_    = release_seqno;
+        }
+    }
+
+    for_each(purged.begin(), purged.end(), PurgeAndDiscard(*this));
+
+    if (release_seqno > 0) service_thd_.release_seqno(release_seqno);
+
+    record_purge_latency(start);
+}
+
+
+bool
+galera::Certification::start_purge_thd()
+{
+    if (gu_likely(purge_thd_running_)) return true;
+
+    int const err(gu_thread_create(&purge_thd_, NULL, purge_thd_func, this));
+    if (err != 0)
+    {
+        log_warn << "Failed to create cert index purge thread: " << err
+                 << " (" << strerror(err) << "), purging synchronously";
+        return false;
+    }
+
+    purge_thd_running_ = true;
+    return true;
+}
+
+
+void*
+galera::Certification::purge_thd_func(void* arg)
+{
+    Certification* const cert(static_cast<Certification*>(arg));
+
+    while (true)
+    {
+        {
+            gu::Lock lock(cert->mutex_);
+
+            while (!cert->purge_exit_ &&
+                   cert->purge_pos_ >= cert->purge_target_)
+            {
+                lock.wait(cert->purge_cond_);
+            }
+
+            if (cert->purge_exit_) break;
+        }
+
+        try
+        {
+            cert->purge_step();
+        }
+        catch (std::exception& e)
+        {
+            log_error << "Background certification index purge failed: "
+                      << e.what();
+
+            gu::Lock lock(cert->mutex_);
+            cert->purge_pos_ = cert->purge_target_;
+            cert->purge_done_.broadcast();
+        }
+    }
+
+    return 0;
+}
+
+
+void
+galera::Certification::purge_flush()
+{
+    {
+        gu::Lock lock(mutex_);
+        while (purge_pos_ < purge_target_) lock.wait(purge_done_);
+    }
+
+    /* wait for the last step to finish */
+    gu::Lock purge_lock(purge_mutex_);
+}
+
+
+void
+galera::Certification::record_purge_latency(const gu::datetime::Date& start)
+{
+    double const latency((gu::datetime::Date::monotonic().get_utc() -
+                          start.get_utc()) * 1.0e-9);
+
+    gu::Lock lock(stats_mutex_);
+    purge_latency_.insert(latency);
+}
+
+
+galera::Certification::ShardsLock::ShardsLock(Certification& cert,
+                                              TrxKeys&       keys)
+    :
+    shards_(cert.cert_index_ng_),
+    mask_  (0)
+{
+    GU_COMPILE_ASSERT(CERT_INDEX_SHARDS <= sizeof(mask_) * 8, mask_too_short);
+
+    for (long i(0); i < keys.count(); ++i)
+    {
+        mask_ |= (1U << shard_idx(keys.next()));
+    }
+    keys.rewind();
+
+    for (size_t i(0); i < CERT_INDEX_SHARDS; ++i)
+    {
+        if (mask_ & (1U << i))
+        {
+            int const err(shards_[i].mutex.lock());
+            if (gu_unlikely(err != 0))
+            {
+                /* unlock what has been locked so far */
+                for (size_t j(0); j < i; ++j)
+                {
+                    if (mask_ & (1U << j)) shards_[j].mutex.unlock();
+                }
+                gu_throw_error(err) << "Failed to lock cert index shard " << i;
+            }
+        }
+    }
+}
+
+
+galera::Certification::ShardsLock::~ShardsLock()
+{
+    for (size_t i(0); i < CERT_INDEX_SHARDS; ++i)
+    {
+        if (mask_ & (1U << i)) shards_[i].mutex.unlock();
+    }
+}
+
+
+size_t
+galera::Certification::bucket_count()
+{
+    size_t ret(0);
+    {
+        gu::Lock lock(mutex_);
+        ret += cert_index_.bucket_count();
+    }
+
+    for (size_t i(0); i < CERT_INDEX_SHARDS; ++i)
+    {
+        gu::Lock lock(cert_index_ng_[i].mutex);
+        ret += cert_index_ng_[i].bucket_count();
+    }
+
+    return ret;
+}
+
+
 galera::Certification::TestResult
 galera::Certification::append_trx(TrxHandle* trx)
 {
     assert(trx->global_seqno() >= 0 && trx->local_seqno() >= 0);
     assert(trx->global_seqno() > position_);
 
+    wsrep_seqno_t trim_seqno(-1);
+
     trx->ref();
     {
         gu::Lock lock(mutex_);
@@ -1097,8 +1496,9 @@ galera::Certification::append_trx(TrxHandle* trx)
             log_debug << "trx map size: " << trx_map_.size()
                       << " - check if status.last_committed is incrementing";
 
-            wsrep_seqno_t       trim_seqno(position_ - max_length_);
-            wsrep_seqno_t const stds      (get_safe_to_discard_seqno_());
+            wsrep_seqno_t const stds(get_safe_to_discard_seqno_());
+
+            trim_seqno = position_ - max_length_;
 
             if (trim_seqno > stds)
             {
@@ -1110,11 +1510,12 @@ galera::Certification::append_trx(TrxHandle* trx)
             {
                 cert_debug << "purging index up to " << trim_seqno;
             }
-
-            purge_trxs_upto_(trim_seqno, true);
         }
     }
 
+    /* purge_trxs_upto() takes purge_mutex_ before mutex_ */
+    if (trim_seqno > 0) purge_trxs_upto(trim_seqno, true);
+
     const TestResult retval(test(trx));
 
     {
@@ -1215,6 +1616,42 @@ galera::Certification::param_set(const std::string& key,
         set_boolean_parameter(optimistic_pa_, value, CERT_PARAM_OPTIMISTIC_PA,
                               "\"optimistic\" parallel applying.");
     }
+    else if (key == Certification::PARAM_PIPELINE)
+    {
+        set_boolean_parameter(pipeline_, value, CERT_PARAM_PIPELINE,
+                              "pipelined certification key preparation.");
+    }
+    else if (key == Certification::PARAM_INDEX_IMPL)
+    {
+        log_error << "setting '" << key << "' during runtime not allowed";
+        gu_throw_error(EPERM)
+            << "setting '" << key << "' during runtime not allowed";
+    }
+    else if (key == Certification::PARAM_PURGE_KEYS_THRESHOLD)
+    {
+        size_t const val(gu::Config::from_config<size_t>(value));
+        gu::Lock lock(mutex_);
+        purge_keys_threshold_ = val;
+    }
+    else if (key == Certification::PARAM_PURGE_BYTES_THRESHOLD)
+    {
+        size_t const val(gu::Config::from_config<size_t>(value));
+        gu::Lock lock(mutex_);
+        purge_bytes_threshold_ = val;
+    }
+    else if (key == Certification::PARAM_PURGE_TRXS_THRESHOLD)
+    {
+        size_t const val(gu::Config::from_config<size_t>(value));
+        gu::Lock lock(mutex_);
+        purge_trxs_threshold_ = val;
+    }
+    else if (key == Certification::PARAM_PURGE_STEP_KEYS)
+    {
+        size_t const val(gu::Config::from_config<size_t>(value));
+        gu::Lock lock(mutex_);
+        purge_step_keys_ = val;
+        /* scheduled purge is still carried out in the background */
+    }
     else
     {
         throw gu::NotFound();
@@ -7,15 +7,22 @@
 
 #include "trx_handle.hpp"
 #include "key_entry_ng.hpp"
+#include "key_entry_table_ng.hpp"
 #include "galera_service_thd.hpp"
 
 #include "gu_unordered.hpp"
+#include "gu_atomic.hpp"
 #include "gu_lock.hpp"
 #include "gu_config.hpp"
+#include "gu_utils.hpp"
+#include "gu_histogram.hpp"
+#include "gu_datetime.hpp"
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <list>
+#include <vector>
 
 namespace galera
 {
@@ -25,6 +32,12 @@ namespace galera
 
         static std::string const PARAM_LOG_CONFLICTS;
         static std::string const PARAM_OPTIMISTIC_PA;
+        static std::string const PARAM_PIPELINE;
+        static std::string const PARAM_INDEX_IMPL;
+        static std::string const PARAM_PURGE_KEYS_THRESHOLD;
+        static std::string const PARAM_PURGE_BYTES_THRESHOLD;
+        static std::string const PARAM_PURGE_TRXS_THRESHOLD;
+        static std::string const PARAM_PURGE_STEP_KEYS;
 
         static void register_params(gu::Config&);
 
@@ -35,6 +48,90 @@ namespace galera
                                  KeyEntryPtrHashNG, KeyEntryPtrEqualNG>
         CertIndexNG;
 
+        /* One shard of v3+ certification index. Depending on cert.index_impl
+         * entries are kept either in CertIndexNG ("hash") or in open
+         * addressing KeyEntryTableNG ("flat"). */
+        class CertIndexShard
+        {
+        public:
+            CertIndexShard()
+                : index_(), table_(), flat_(false), entries_(NULL), mutex() { }
+
+            void set_flat(bool const flat)
+            {
+                assert(size() == 0);
+                flat_ = flat;
+            }
+
+            /* entries counter shared by all shards of the index, optional */
+            void set_entries_counter(gu::Atomic<size_t>* const entries)
+            {
+                assert(size() == 0);
+                entries_ = entries;
+            }
+
+            /* returns matching entry or NULL */
+            KeyEntryNG* find(KeyEntryNG& ke)
+            {
+                if (flat_) return table_.find(ke);
+
+                CertIndexNG::iterator const ci(index_.find(&ke));
+                return (index_.end() == ci ? NULL : *ci);
+            }
+
+            void insert(KeyEntryNG* const kep)
+            {
+                if (flat_) table_.insert(kep); else index_.insert_unique(kep);
+                if (entries_) ++(*entries_);
+            }
+
+            void erase(KeyEntryNG* const kep)
+            {
+                if (flat_) table_.erase(kep); else index_.erase(index_.find(kep));
+                if (entries_) --(*entries_);
+            }
+
+            size_t size() const
+            {
+                return (flat_ ? table_.size() : index_.size());
+            }
+
+            size_t bucket_count()
+            {
+                return (flat_ ? table_.bucket_count() : index_.bucket_count());
+            }
+
+            /* deletes all entries */
+            void clear()
+            {
+                if (entries_) entries_->sub_and_fetch(size());
+
+                if (flat_)
+                {
+                    table_.for_each(gu::DeleteObject());
+                    table_.clear();
+                }
+                else
+                {
+                    std::for_each(index_.begin(), index_.end(),
+                                  gu::DeleteObject());
+                    index_.clear();
+                }
+            }
+
+        private:
+            CertIndexShard(const CertIndexShard&);
+            void operator=(const CertIndexShard&);
+
+            CertIndexNG     index_;
+            KeyEntryTableNG table_;
+            bool            flat_;
+            gu::Atomic<size_t>* entries_;
+
+        public:
+            gu::Mutex       mutex;
+        };
+
     private:
 
         typedef std::multiset<wsrep_seqno_t>        DepsSet;
@@ -53,6 +150,12 @@ namespace galera
         ~Certification();
 
         void assign_initial_position(wsrep_seqno_t seqno, int versiono);
+
+        // Parse trx keys ahead of total order if pipelining is enabled.
+        // Does not touch certification index and can be called concurrently
+        // for different trxs, before entering local monitor.
+        void prepare(TrxHandle*) const;
+
         TestResult append_trx(TrxHandle*);
         TestResult test(TrxHandle*, bool = true);
         wsrep_seqno_t position() const { return position_; }
@@ -64,17 +167,18 @@ namespace galera
             return get_safe_to_discard_seqno_();
         }
 
+        // Purge trxs and their index entries up to min(seqno, safe to
+        // discard seqno). For v3+ index the trxs are only detached from
+        // trx map under mutex_, index entries are removed shard by shard
+        // concurrently with certification.
+        // If cert.purge_step_keys is set and handle_gcache is true, v3+
+        // purge is only scheduled here and is carried out incrementally
+        // by the background purge thread.
         wsrep_seqno_t
-        purge_trxs_upto(wsrep_seqno_t const seqno, bool const handle_gcache)
-        {
-            gu::Lock lock(mutex_);
-            const wsrep_seqno_t stds(get_safe_to_discard_seqno_());
-            // assert(seqno <= get_safe_to_discard_seqno());
-            // Note: setting trx committed is not done in total order so
-            // safe to discard seqno may decrease. Enable assertion above when
-            // this issue is fixed.
-            return purge_trxs_upto_(std::min(seqno, stds), handle_gcache);
-        }
+        purge_trxs_upto(wsrep_seqno_t seqno, bool handle_gcache);
+
+        // Wait until background purge scheduled so far is complete
+        void purge_flush();
 
         // Set trx corresponding to handle committed. Return purge seqno if
         // index purge is required, -1 otherwise.
@@ -104,18 +208,93 @@ namespace galera
             deps_dist_ = 0;
             n_certified_ = 0;
             index_size_ = 0;
+            purge_latency_.clear();
         }
 
-        size_t bucket_count ()
+        // index purge step latency histogram (seconds)
+        std::string purge_latency() const
         {
-            return cert_index_.bucket_count() +
-                cert_index_ng_.bucket_count();
+            gu::Lock lock(stats_mutex_);
+            return purge_latency_.to_string();
         }
 
+        size_t bucket_count ();
+
         void param_set(const std::string& key, const std::string& value);
 
     private:
 
+        /* v3+ certification index is split into shards by key hash, each
+         * protected by its own mutex, so that purge can remove entries
+         * without holding mutex_. Index lookups are still done by the
+         * certification test under mutex_. Lock order is purge_mutex_ ->
+         * mutex_ -> shard mutexes in ascending order. */
+        static size_t const CERT_INDEX_SHARDS = 16;
+
+        static size_t shard_idx(const KeySet::KeyPart& kp)
+        {
+            return kp.hash() % CERT_INDEX_SHARDS;
+        }
+
+        CertIndexShard& shard(const KeySet::KeyPart& kp)
+        {
+            return cert_index_ng_[shard_idx(kp)];
+        }
+
+        /* Walks v3+ trx keys: the ones parsed in advance by prepare() if
+         * any, otherwise directly the write set key set, without a copy. */
+        class TrxKeys
+        {
+        public:
+            explicit TrxKeys(TrxHandle* trx)
+                :
+                key_set_ (trx->write_set_in().keyset()),
+                prepared_(trx->cert_keys_ng()),
+                count_   (key_set_.count()),
+                pos_     (0)
+            {
+                key_set_.rewind();
+            }
+
+            long count() const { return count_; }
+
+            void rewind() { pos_ = 0; key_set_.rewind(); }
+
+            KeySet::KeyPart next()
+            {
+                if (prepared_.empty()) return key_set_.next();
+                return prepared_[pos_++];
+            }
+
+        private:
+            TrxKeys(const TrxKeys&);
+            void operator=(const TrxKeys&);
+
+            const KeySetIn&              key_set_;
+            const TrxHandle::CertKeysNG& prepared_;
+            long const                   count_;
+            long                         pos_;
+        };
+
+        /* Locks all shards touched by trx keys (in ascending order),
+         * leaves keys rewound */
+        class ShardsLock
+        {
+        public:
+            ShardsLock(Certification& cert, TrxKeys& keys);
+            ~ShardsLock();
+
+        private:
+            ShardsLock(const ShardsLock&);
+            void operator=(const ShardsLock&);
+
+            CertIndexShard* const shards_;
+            uint32_t              mask_;
+        };
+
+        /* number of entries in all shards, does not lock shards */
+        size_t index_ng_size() const { return index_ng_entries_(); }
+
         TestResult do_test(TrxHandle*, bool);
         TestResult do_test_v1to2(TrxHandle*, bool);
         TestResult do_test_v3to4(TrxHandle*, bool);
@@ -123,22 +302,25 @@ namespace galera
         void purge_for_trx(TrxHandle*);
         void purge_for_trx_v1to2(TrxHandle*);
         void purge_for_trx_v3(TrxHandle*);
+        static void prepare_keys_v3(TrxHandle*);
 
         // unprotected variants for internal use
         wsrep_seqno_t get_safe_to_discard_seqno_() const;
         wsrep_seqno_t purge_trxs_upto_(wsrep_seqno_t, bool sync);
 
+        // background purge
+        bool start_purge_thd(); // must be called under mutex_
+        static void* purge_thd_func(void*);
+        void purge_step();
+        void record_purge_latency(const gu::datetime::Date& start);
+
         bool index_purge_required()
         {
-            static unsigned int const KEYS_THRESHOLD (1   << 10); // 1K
-            static unsigned int const BYTES_THRESHOLD(128 << 20); // 128M
-            static unsigned int const TRXS_THRESHOLD (127);
-
             /* if either key count, byte count or trx count exceed their
              * threshold, zero up counts and return true. */
-            return ((key_count_  > KEYS_THRESHOLD  ||
-                     byte_count_ > BYTES_THRESHOLD ||
-                     trx_count_  > TRXS_THRESHOLD)
+            return ((key_count_  > purge_keys_threshold_  ||
+                     byte_count_ > purge_bytes_threshold_ ||
+                     trx_count_  > purge_trxs_threshold_)
                      &&
                      (key_count_ = 0, byte_count_ = 0, trx_count_ = 0, true));
         }
@@ -188,7 +370,10 @@ namespace galera
         gu::Config&   conf_;
         TrxMap        trx_map_;
         CertIndex     cert_index_;
-        CertIndexNG   cert_index_ng_;
+        CertIndexShard cert_index_ng_[CERT_INDEX_SHARDS];
+        gu::Atomic<size_t> index_ng_entries_; // updated by shards
+        std::vector<KeyEntryNG*>
+                      matched_entries_; // index entries for trx under test
         DepsSet       deps_set_;
         ServiceThd&   service_thd_;
         gcache::GCache& gcache_;
@@ -198,6 +383,7 @@ namespace galera
 #else
         gu::Mutex     mutex_;
 #endif /* HAVE_PSI_INTERFACE */
+        gu::Mutex     purge_mutex_; // serializes purges and gcache release
         size_t        trx_size_warn_count_;
         wsrep_seqno_t initial_position_;
         wsrep_seqno_t position_;
@@ -231,6 +417,24 @@ namespace galera
 
         bool               log_conflicts_;
         bool               optimistic_pa_;
+        bool               pipeline_;
+
+        /* index purge thresholds, see index_purge_required() */
+        size_t        purge_keys_threshold_;
+        size_t        purge_bytes_threshold_;
+        size_t        purge_trxs_threshold_;
+
+        /* background purge, protected by mutex_ */
+        size_t        purge_step_keys_; // 0 - no background purge
+        wsrep_seqno_t purge_target_;    // purge scheduled up to this seqno
+        wsrep_seqno_t purge_pos_;       // purge taken up to this seqno
+        bool          purge_exit_;
+        gu::Cond      purge_cond_;      // purge scheduled or exit
+        gu::Cond      purge_done_;      // purge completed
+        gu_thread_t   purge_thd_;
+        bool          purge_thd_running_; // started on first use
+
+        gu::Histogram purge_latency_; // protected by stats_mutex_
     };
 }
 
@@ -0,0 +1,270 @@
+//
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+//
+
+#include "checksum_pool.hpp"
+#include "write_set_ng.hpp"
+
+#include "gu_logger.hpp"
+
+#include <gu_time.h>
+
+#include <gu_atomic.h>
+
+#include <algorithm>
+#include <cstring>
+
+static std::string const CHECKSUM_LATENCY_BINS
+("0.0,0.0001,0.0005,0.001,0.005,0.01,0.05,0.1,0.5,1.");
+
+galera::ChecksumPool&
+galera::ChecksumPool::instance()
+{
+    static ChecksumPool pool;
+    return pool;
+}
+
+galera::ChecksumPool::ChecksumPool()
+    :
+    resize_mutex_(),
+    mutex_       (),
+    cond_        (),
+    done_        (),
+    queue_       (),
+    thds_        (),
+    n_thds_      (DEFAULT_THREADS),
+    exit_        (false),
+    latency_     (CHECKSUM_LATENCY_BINS)
+{}
+
+galera::ChecksumPool::~ChecksumPool()
+{
+    set_threads(0);
+}
+
+void
+galera::ChecksumPool::stop()
+{
+    {
+        gu::Lock lock(mutex_);
+        exit_ = true;
+        cond_.broadcast();
+    }
+
+    for (size_t i(0); i < thds_.size(); ++i)
+    {
+        gu_thread_join(thds_[i], NULL);
+    }
+
+    gu::Lock lock(mutex_);
+    thds_.clear();
+    exit_ = false;
+}
+
+void
+galera::ChecksumPool::set_threads(size_t const n)
+{
+    gu::Lock resize_lock(resize_mutex_);
+
+    {
+        gu::Lock lock(mutex_);
+        n_thds_ = n;
+    }
+
+    /* threads will be restarted on demand, queued jobs are finished by the
+     * old ones before they exit */
+    stop();
+}
+
+bool
+galera::ChecksumPool::start()
+{
+    /* thds_ is being joined by stop() */
+    if (gu_unlikely(exit_)) return false;
+
+    while (thds_.size() < n_thds_)
+    {
+        gu_thread_t thd;
+        int const err(gu_thread_create(&thd, NULL, thd_func, this));
+
+        if (gu_unlikely(0 != err))
+        {
+            log_warn << "Starting checksum thread failed: " << err
+                     << '(' << ::strerror(err) << ')';
+            break;
+        }
+
+        thds_.push_back(thd);
+    }
+
+    return !thds_.empty();
+}
+
+bool
+galera::ChecksumPool::submit(WriteSetIn& ws)
+{
+    gu::Lock lock(mutex_);
+
+    if (gu_unlikely(!start())) return false;
+
+    ws.check_done_ = false;
+
+    Job const job = { &ws, NULL, gu_time_monotonic() };
+    queue_.push_back(job);
+    cond_.signal();
+
+    return true;
+}
+
+void
+galera::ChecksumPool::wait(const WriteSetIn& ws) const
+{
+    gu::Lock lock(mutex_);
+    while (!ws.check_done_) lock.wait(done_);
+}
+
+void
+galera::ChecksumPool::process(Chunks& chunks)
+{
+    int i;
+    while ((i = gu_atomic_fetch_and_add(&chunks.next_, 1)) < chunks.count_)
+    {
+        chunks.digests_[i] = chunks.rs_->checksum_chunk(i);
+    }
+}
+
+void
+galera::ChecksumPool::checksum(const gu::RecordSetInBase& rs)
+{
+    int const count(rs.check_chunks());
+
+    if (count < 2)
+    {
+        rs.checksum();
+        return;
+    }
+
+    std::vector<uint64_t> digests(count);
+    Chunks chunks = { &rs, &digests[0], count, 0, 0 };
+
+    {
+        gu::Lock lock(mutex_);
+
+        if (start())
+        {
+            Job const job = { NULL, &chunks, gu_time_monotonic() };
+            size_t const helpers(std::min(thds_.size(), size_t(count - 1)));
+
+            for (size_t i(0); i < helpers; ++i) queue_.push_back(job);
+            cond_.broadcast();
+        }
+    }
+
+    /* don't wait for helpers, they may be busy with other writesets */
+    process(chunks);
+
+    {
+        gu::Lock lock(mutex_);
+
+        for (std::deque<Job>::iterator i(queue_.begin()); i != queue_.end();)
+        {
+            if (i->chunks_ == &chunks)
+                i = queue_.erase(i);
+            else
+                ++i;
+        }
+
+        while (chunks.helpers_ > 0) lock.wait(done_);
+    }
+
+    rs.checksum(&digests[0]);
+}
+
+void
+galera::ChecksumPool::finish(const Job& job)
+{
+    job.ws_->check_done_ = true;
+    latency_.insert((gu_time_monotonic() - job.submitted_) * 1.0e-9);
+    done_.broadcast();
+}
+
+void
+galera::ChecksumPool::run()
+{
+    while (true)
+    {
+        Job job;
+
+        {
+            gu::Lock lock(mutex_);
+
+            while (!exit_ && queue_.empty()) lock.wait(cond_);
+
+            /* drain the queue before exiting, nobody else will take it */
+            if (queue_.empty()) break;
+
+            job = queue_.front();
+            queue_.pop_front();
+
+            if (job.chunks_) ++job.chunks_->helpers_;
+        }
+
+        if (job.chunks_)
+        {
+            process(*job.chunks_);
+
+            gu::Lock lock(mutex_);
+            --job.chunks_->helpers_;
+            done_.broadcast();
+            continue;
+        }
+
+        job.ws_->checksum(); /* does not throw */
+
+        gu::Lock lock(mutex_);
+        finish(job);
+    }
+}
+
+void*
+galera::ChecksumPool::thd_func(void* arg)
+{
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_INIT,
+                       WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    static_cast<ChecksumPool*>(arg)->run();
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_DESTROY,
+                       WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    return NULL;
+}
+
+long long
+galera::ChecksumPool::queue_len() const
+{
+    gu::Lock lock(mutex_);
+    return queue_.size();
+}
+
+std::string
+galera::ChecksumPool::latency() const
+{
+    gu::Lock lock(mutex_);
+    return latency_.to_string();
+}
+
+void
+galera::ChecksumPool::stats_reset()
+{
+    gu::Lock lock(mutex_);
+    latency_.clear();
+}
@@ -0,0 +1,107 @@
+//
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+//
+
+/*
+ * Persistent pool of threads checksumming big incoming writesets in the
+ * background, so that it can be overlapped with certification. Record sets
+ * with chunked checksum are additionally checksummed by several threads.
+ */
+
+#ifndef GALERA_CHECKSUM_POOL_HPP
+#define GALERA_CHECKSUM_POOL_HPP
+
+#include "gu_lock.hpp"
+#include "gu_histogram.hpp"
+#include "gu_rset.hpp"
+
+#include <gu_threads.h>
+
+#include <deque>
+#include <vector>
+#include <string>
+
+namespace galera
+{
+    class WriteSetIn;
+
+    class ChecksumPool
+    {
+    public:
+
+        static size_t const DEFAULT_THREADS = 2;
+
+        /* process-wide instance, threads are started on first use */
+        static ChecksumPool& instance();
+
+        ~ChecksumPool();
+
+        /* waits for the queued jobs to finish and changes the number of
+         * threads, 0 makes WriteSetIn checksum in foreground */
+        void set_threads(size_t n);
+
+        /* queues writeset for checksumming, returns false if there are no
+         * threads to do it */
+        bool submit(WriteSetIn& ws);
+
+        /* waits until checksumming of the submitted writeset is done */
+        void wait(const WriteSetIn& ws) const;
+
+        /* checksums record set, spreading chunks over idle threads if
+         * record set checksum allows it, throws if checksum fails */
+        void checksum(const gu::RecordSetInBase& rs);
+
+        /* number of writesets waiting for a thread */
+        long long queue_len() const;
+
+        /* submit to completion latency histogram (seconds) */
+        std::string latency() const;
+
+        void stats_reset();
+
+    private:
+
+        /* chunks of a single record set checksummed by several threads */
+        struct Chunks
+        {
+            const gu::RecordSetInBase* rs_;
+            uint64_t*                  digests_;
+            int                        count_;
+            int                        next_;    // next chunk to take
+            int                        helpers_; // threads working on it
+        };
+
+        struct Job
+        {
+            WriteSetIn* ws_;     // either the whole writeset
+            Chunks*     chunks_; // or a helping hand with the chunks
+            long long   submitted_;
+        };
+
+        gu::Mutex                resize_mutex_; // serializes set_threads()
+        gu::Mutex                mutex_;
+        gu::Cond                 cond_;         // job queued or exit
+        gu::Cond mutable         done_;         // job done
+        std::deque<Job>          queue_;
+        std::vector<gu_thread_t> thds_;
+        size_t                   n_thds_;       // configured number of threads
+        bool                     exit_;
+        gu::Histogram            latency_;
+
+        ChecksumPool();
+
+        void stop();
+        bool start(); // must be called under mutex_
+        void run();
+        void finish(const Job& job); // must be called under mutex_
+
+        static void  process(Chunks& chunks);
+        static void* thd_func(void* arg);
+
+        ChecksumPool(const ChecksumPool&);
+        ChecksumPool& operator=(const ChecksumPool&);
+    };
+
+} /* namespace galera */
+
+#endif // GALERA_CHECKSUM_POOL_HPP
@@ -15,11 +15,19 @@
 #include <boost/bind.hpp>
 #include <fstream>
 #include <algorithm>
+#include <memory>
 
 namespace
 {
     static std::string const CONF_KEEP_KEYS     ("ist.keep_keys");
     static bool        const CONF_KEEP_KEYS_DEFAULT (true);
+    static std::string const CONF_RECV_QUEUE_DEFAULT("64");
+    static std::string const CONF_RECV_STREAMS_DEFAULT("1");
+    static std::string const CONF_RECV_GCACHE_DEFAULT("no");
+    static std::string const CONF_SEND_BATCH    ("ist.send_batch");
+    static std::string const CONF_SEND_BATCH_DEFAULT("1M");
+    static std::string const CONF_COMPRESS      ("ist.compress");
+    static std::string const CONF_COMPRESS_DEFAULT("no");
 }
 
 
@@ -75,16 +83,28 @@ std::string const
 galera::ist::Receiver::RECV_ADDR("ist.recv_addr");
 std::string const
 galera::ist::Receiver::RECV_BIND("ist.recv_bind");
+std::string const
+galera::ist::Receiver::RECV_QUEUE("ist.recv_queue");
+std::string const
+galera::ist::Receiver::RECV_STREAMS("ist.recv_streams");
+std::string const
+galera::ist::Receiver::RECV_GCACHE("ist.recv_gcache");
 
 void
 galera::ist::register_params(gu::Config& conf)
 {
     conf.add(Receiver::RECV_ADDR);
     conf.add(Receiver::RECV_BIND);
+    conf.add(Receiver::RECV_QUEUE, CONF_RECV_QUEUE_DEFAULT);
+    conf.add(Receiver::RECV_STREAMS, CONF_RECV_STREAMS_DEFAULT);
+    conf.add(Receiver::RECV_GCACHE, CONF_RECV_GCACHE_DEFAULT);
     conf.add(CONF_KEEP_KEYS);
+    conf.add(CONF_SEND_BATCH, CONF_SEND_BATCH_DEFAULT);
+    conf.add(CONF_COMPRESS, CONF_COMPRESS_DEFAULT);
 }
 
 galera::ist::Receiver::Receiver(gu::Config&           conf,
+                                gcache::GCache&       gc,
                                 TrxHandle::SlavePool& sp,
                                 const char*           addr)
     :
@@ -100,16 +120,29 @@ galera::ist::Receiver::Receiver(gu::Config&           conf,
     mutex_        (),
     cond_         (),
 #endif /* HAVE_PSI_INTERFACE */
-    consumers_    (),
+#ifdef HAVE_PSI_INTERFACE
+    consumer_cond_(WSREP_PFS_INSTR_TAG_IST_CONSUMER_CONDVAR),
+#else
+    consumer_cond_(),
+#endif /* HAVE_PSI_INTERFACE */
+    queue_        (),
+    queue_max_    (1),
+    streams_      (),
+    streams_max_  (1),
+    streams_done_ (0),
+    streams_error_(0),
+    progress_     (0),
     current_seqno_(-1),
     first_seqno_  (-1),
     last_seqno_   (-1),
     conf_         (conf),
+    gcache_       (gc),
     trx_pool_     (sp),
     thread_       (),
     error_code_   (0),
     version_      (-1),
     use_ssl_      (false),
+    use_gcache_   (false),
     running_      (false),
     interrupted_  (false),
     ready_        (false)
@@ -302,7 +335,14 @@ galera::ist::Receiver::prepare(wsrep_seqno_t first_seqno,
                                int           version)
 {
     ready_ = false;
+    interrupted_ = false;
+    error_code_ = 0;
     version_ = version;
+    queue_max_ = std::max(conf_.get<size_t>(RECV_QUEUE), size_t(1));
+    streams_max_ = std::min(std::max(conf_.get<size_t>(RECV_STREAMS),
+                                     size_t(1)),
+                            size_t(Proto::MAX_STREAMS));
+    use_gcache_ = conf_.get<bool>(RECV_GCACHE);
     recv_addr_ = IST_determine_recv_addr(conf_);
     try
     {
@@ -376,23 +416,148 @@ galera::ist::Receiver::prepare(wsrep_seqno_t first_seqno,
 }
 
 
-void galera::ist::Receiver::run()
+/*
+ * Connection from sender
+ */
+class galera::ist::Receiver::Stream
 {
-    asio::ip::tcp::socket socket(io_service_);
-    asio::ssl::stream<asio::ip::tcp::socket> ssl_stream(io_service_, ssl_ctx_);
-    try
+public:
+
+    explicit Stream(Receiver& receiver)
+        :
+        waiting_   (-1),
+        done_      (false),
+        receiver_  (receiver),
+        socket_    (receiver.io_service_),
+        ssl_stream_(receiver.io_service_, receiver.ssl_ctx_),
+        proto_     (receiver.trx_pool_, receiver.version_,
+                    receiver.conf_.get(CONF_KEEP_KEYS,
+                                       CONF_KEEP_KEYS_DEFAULT)),
+        thd_       (),
+        error_     (0)
     {
-        if (use_ssl_ == true)
+        proto_.set_compress(true); // whether to use is decided by sender
+        if (receiver.use_gcache_) proto_.set_gcache(&receiver.gcache_);
+    }
+
+    void accept(asio::ip::tcp::acceptor& acceptor)
+    {
+        if (receiver_.use_ssl_ == true)
         {
-            acceptor_.accept(ssl_stream.lowest_layer());
-            gu::set_fd_options(ssl_stream.lowest_layer());
-            ssl_stream.handshake(asio::ssl::stream<asio::ip::tcp::socket>::server);
+            acceptor.accept(ssl_stream_.lowest_layer());
+            gu::set_fd_options(ssl_stream_.lowest_layer());
+            ssl_stream_.handshake(
+                asio::ssl::stream<asio::ip::tcp::socket>::server);
         }
         else
         {
-            acceptor_.accept(socket);
-            gu::set_fd_options(socket);
+            acceptor.accept(socket_);
+            gu::set_fd_options(socket_);
+        }
+    }
+
+    void handshake(size_t const streams)
+    {
+        proto_.set_streams(streams);
+
+        if (receiver_.use_ssl_ == true)
+        {
+            proto_.send_handshake(ssl_stream_);
+            proto_.recv_handshake_response(ssl_stream_);
+            proto_.send_ctrl(ssl_stream_, Ctrl::C_OK);
         }
+        else
+        {
+            proto_.send_handshake(socket_);
+            proto_.recv_handshake_response(socket_);
+            proto_.send_ctrl(socket_, Ctrl::C_OK);
+        }
+    }
+
+    TrxHandle* recv_trx()
+    {
+        if (receiver_.use_ssl_ == true)
+        {
+            return proto_.recv_trx(ssl_stream_);
+        }
+        else
+        {
+            return proto_.recv_trx(socket_);
+        }
+    }
+
+    /* unblocks reads from other threads */
+    void shutdown()
+    {
+        asio::error_code ec;
+        lowest_layer().shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+    }
+
+    void close()
+    {
+        asio::error_code ec;
+        lowest_layer().close(ec);
+    }
+
+    void start()
+    {
+        int const err(gu_thread_create(&thd_, NULL, run_stream, this));
+        if (err != 0)
+        {
+            gu_throw_error(err) << "Failed to create IST receiver stream "
+                                << "thread";
+        }
+    }
+
+    int join()
+    {
+        gu_thread_join(thd_, NULL);
+        return error_;
+    }
+
+    Proto& proto() { return proto_; }
+
+    wsrep_seqno_t waiting_; // seqno waiting for its turn or -1
+    bool          done_;    // got EOF
+
+private:
+
+    asio::ip::tcp::socket::lowest_layer_type& lowest_layer()
+    {
+        return (receiver_.use_ssl_ ? ssl_stream_.lowest_layer() : socket_);
+    }
+
+    static void* run_stream(void* arg)
+    {
+        Stream* const s(static_cast<Stream*>(arg));
+        s->error_ = s->receiver_.receive(*s);
+        return 0;
+    }
+
+    Receiver&                                receiver_;
+    asio::ip::tcp::socket                    socket_;
+    asio::ssl::stream<asio::ip::tcp::socket> ssl_stream_;
+    Proto                                    proto_;
+    gu_thread_t                              thd_;
+    int                                      error_;
+
+    Stream(const Stream&);
+    void operator=(const Stream&);
+};
+
+
+void galera::ist::Receiver::run()
+{
+    {
+        gu::Lock lock(mutex_);
+        streams_.push_back(new Stream(*this));
+        streams_done_  = 0;
+        streams_error_ = 0;
+    }
+
+    try
+    {
+        streams_[0]->accept(acceptor_);
     }
     catch (asio::system_error& e)
     {
@@ -401,24 +566,47 @@ void galera::ist::Receiver::run()
                                          << e.what() << "': "
                                          << gu::extra_error_info(e.code());
     }
-    acceptor_.close();
     int ec(0);
     try
     {
-        Proto p(trx_pool_, version_,
-                conf_.get(CONF_KEEP_KEYS, CONF_KEEP_KEYS_DEFAULT));
+        streams_[0]->handshake(streams_max_);
 
-        if (use_ssl_ == true)
+        /* sender tells in the first handshake how many streams it uses,
+         * the rest connect one after another */
+        size_t const n_streams(streams_[0]->proto().streams());
+
+        if (n_streams > streams_max_)
         {
-            p.send_handshake(ssl_stream);
-            p.recv_handshake_response(ssl_stream);
-            p.send_ctrl(ssl_stream, Ctrl::C_OK);
+            gu_throw_error(EPROTO) << "sender wants " << n_streams
+                                   << " streams, maximum is " << streams_max_;
         }
-        else
+
+        for (size_t i(1); i < n_streams; ++i)
         {
-            p.send_handshake(socket);
-            p.recv_handshake_response(socket);
-            p.send_ctrl(socket, Ctrl::C_OK);
+            Stream* const s(new Stream(*this));
+            {
+                gu::Lock lock(mutex_);
+                streams_.push_back(s);
+            }
+            s->accept(acceptor_);
+            s->handshake(n_streams);
+
+            if (s->proto().stream() != int(i) ||
+                s->proto().streams() != n_streams)
+            {
+                gu_throw_error(EPROTO) << "unexpected stream "
+                                       << s->proto().stream() << " of "
+                                       << s->proto().streams()
+                                       << ", expected " << i << " of "
+                                       << n_streams;
+            }
+        }
+
+        acceptor_.close();
+
+        if (n_streams > 1)
+        {
+            log_info << "IST receiving over " << n_streams << " streams";
         }
 
         /* wait for ready signal from the STR thread */
@@ -441,53 +629,38 @@ void galera::ist::Receiver::run()
             /* The following means reporting progress NO MORE frequently than
              * once per BOTH 10 seconds (default) and 16 events */
             16);
+        progress_ = &progress;
 
-        while (true)
+        size_t started(1);
+        try
         {
-            TrxHandle* trx;
-            if (use_ssl_ == true)
+            for (; started < streams_.size(); ++started)
             {
-                trx = p.recv_trx(ssl_stream);
+                streams_[started]->start();
             }
-            else
-            {
-                trx = p.recv_trx(socket);
-            }
-            if (trx != 0)
-            {
-                if (trx->global_seqno() != current_seqno_)
-                {
-                    log_error << "unexpected trx seqno: " << trx->global_seqno()
-                              << " expected: " << current_seqno_;
-                    ec = EINVAL;
-                    goto err;
-                }
-                ++current_seqno_;
 
-                progress.update(1);
-            }
+            ec = receive(*streams_[0]);
+        }
+        catch (gu::Exception& e) // failed to start stream thread
+        {
+            ec = e.get_errno();
+            log_error << e.what();
+
             gu::Lock lock(mutex_);
-            assert(ready_ || interrupted_);
-            while (consumers_.empty())
-            {
-                if (interrupted_)
-                {
-                    goto Intrrupted;
-                }
-                lock.wait(cond_);
-            }
-            Consumer* cons(consumers_.top());
-            consumers_.pop();
-            cons->trx(trx);
-            cons->cond().signal();
-            if (trx == 0)
-            {
-                log_debug << "eof received, closing socket";
-                break;
-            }
+            streams_error_ = ec;
+            cond_.broadcast();
+            shutdown_streams();
+        }
+
+        for (size_t i(1); i < started; ++i)
+        {
+            int const err(streams_[i]->join());
+            if (0 == ec || EINTR == ec) ec = err ? err : ec;
         }
 
-        progress.finish();
+        progress_ = 0;
+
+        if (0 == ec) progress.finish();
     }
     catch (asio::system_error& e)
     {
@@ -504,17 +677,16 @@ void galera::ist::Receiver::run()
     }
 
 Intrrupted:
-err:
     gu::Lock lock(mutex_);
-    if (use_ssl_ == true)
-    {
-        ssl_stream.lowest_layer().close();
-        // ssl_stream.shutdown();
-    }
-    else
+
+    acceptor_.close();
+
+    for (size_t i(0); i < streams_.size(); ++i)
     {
-        socket.close();
+        streams_[i]->close();
+        delete streams_[i];
     }
+    streams_.clear();
 
     running_ = false;
     if (ec != EINTR && current_seqno_ - 1 < last_seqno_)
@@ -527,11 +699,125 @@ err:
     {
         error_code_ = ec;
     }
-    while (consumers_.empty() == false)
+    consumer_cond_.broadcast();
+}
+
+
+/*
+ * Receives write sets from the stream into queue_ in total order: each
+ * stream delivers its own write sets in order, so a write set waits until
+ * it is the next one. Returns error code.
+ */
+int galera::ist::Receiver::receive(Stream& s)
+{
+    int ec(0);
+
+    try
+    {
+        while (true)
+        {
+            TrxHandle* const trx(s.recv_trx());
+
+            gu::Lock lock(mutex_);
+
+            if (0 == trx)
+            {
+                log_debug << "eof received on stream " << s.proto().stream();
+                s.done_ = true;
+                ++streams_done_;
+                cond_.broadcast();
+                break;
+            }
+
+            wsrep_seqno_t const seqno(trx->global_seqno());
+
+            s.waiting_ = seqno;
+
+            while (!interrupted_ && 0 == streams_error_ &&
+                   (seqno != current_seqno_ || queue_.size() >= queue_max_))
+            {
+                if (seqno < current_seqno_ || stripes_stuck())
+                {
+                    log_error << "unexpected trx seqno: " << seqno
+                              << " expected: " << current_seqno_;
+                    ec = EINVAL;
+                    break;
+                }
+                lock.wait(cond_);
+            }
+
+            s.waiting_ = -1;
+
+            if (ec != 0 || interrupted_ || streams_error_ != 0)
+            {
+                discard(trx);
+                if (0 == ec) ec = EINTR;
+                break;
+            }
+
+            queue_.push_back(trx);
+            ++current_seqno_;
+            if (progress_) progress_->update(1);
+            consumer_cond_.signal();
+            if (streams_.size() > 1) cond_.broadcast();
+        }
+    }
+    catch (asio::system_error& e)
+    {
+        log_error << "got error while reading ist stream: " << e.code();
+        ec = e.code().value();
+    }
+    catch (gu::Exception& e)
+    {
+        ec = e.get_errno();
+        if (ec != EINTR)
+        {
+            log_error << "got exception while reading ist stream: " << e.what();
+        }
+    }
+
+    if (ec != 0 && ec != EINTR)
     {
-        consumers_.top()->cond().signal();
-        consumers_.pop();
+        gu::Lock lock(mutex_);
+        if (0 == streams_error_) streams_error_ = ec;
+        cond_.broadcast();
+        shutdown_streams();
     }
+
+    return ec;
+}
+
+
+/* true if no stream can deliver the next write set: all are either done or
+ * hold later write sets. Must be called under mutex_. */
+bool galera::ist::Receiver::stripes_stuck() const
+{
+    for (size_t i(0); i < streams_.size(); ++i)
+    {
+        const Stream& s(*streams_[i]);
+        if (!s.done_ && (s.waiting_ < 0 || s.waiting_ == current_seqno_))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* Drops write set which won't be consumed. Its gcache buffer, if any, was
+ * not assigned a seqno yet, so it is freed here. */
+void galera::ist::Receiver::discard(TrxHandle* const trx)
+{
+    if (trx->action()) gcache_.free(const_cast<void*>(trx->action()));
+    trx->unref();
+}
+
+
+/* unblocks all streams, must be called under mutex_ */
+void galera::ist::Receiver::shutdown_streams()
+{
+    for (size_t i(0); i < streams_.size(); ++i) streams_[i]->shutdown();
 }
 
 
@@ -544,29 +830,27 @@ void galera::ist::Receiver::ready()
 
 int galera::ist::Receiver::recv(TrxHandle** trx)
 {
-    Consumer cons;
     gu::Lock lock(mutex_);
-    if (running_ == false)
+    while (true)
     {
         if (error_code_ != 0)
         {
             gu_throw_error(error_code_) << "IST receiver reported error";
         }
-        return EINTR;
-    }
-    consumers_.push(&cons);
-    cond_.signal();
-    lock.wait(cons.cond());
-    if (cons.trx() == 0)
-    {
-        if (error_code_ != 0)
+        if (queue_.empty() == false)
         {
-            gu_throw_error(error_code_) << "IST receiver reported error";
+            *trx = queue_.front();
+            queue_.pop_front();
+            // receiver streams may be waiting for room in the queue
+            cond_.broadcast();
+            return 0;
         }
-        return EINTR;
+        if (running_ == false)
+        {
+            return EINTR;
+        }
+        lock.wait(consumer_cond_);
     }
-    *trx = cons.trx();
-    return 0;
 }
 
 
@@ -581,12 +865,11 @@ wsrep_seqno_t galera::ist::Receiver::finished()
         interrupt();
 
         // It is necessary to push the loop in the run() method
-        // ahead - if now it awaiting the signal:
-        if (!ready_)
+        // ahead - if now it awaiting the signal or room in the queue:
         {
             gu::Lock local_lock(mutex_);
             interrupted_ = true;
-            cond_.signal();
+            cond_.broadcast();
         }
 
         int err;
@@ -601,10 +884,13 @@ wsrep_seqno_t galera::ist::Receiver::finished()
 
         running_ = false;
 
-        while (consumers_.empty() == false)
+        consumer_cond_.broadcast();
+
+        // write sets which were received but not consumed
+        while (queue_.empty() == false)
         {
-            consumers_.top()->cond().signal();
-            consumers_.pop();
+            discard(queue_.front());
+            queue_.pop_front();
         }
 
         recv_addr_ = "";
@@ -679,8 +965,11 @@ galera::ist::Sender::Sender(const gu::Config&  conf,
     ssl_stream_(0),
     conf_      (conf),
     gcache_    (gcache),
+    peer_      (peer),
     version_   (version),
-    use_ssl_   (false)
+    use_ssl_   (false),
+    streams_mutex_(),
+    streams_   ()
 {
     gu::URI uri(peer);
     try
@@ -720,6 +1009,142 @@ galera::ist::Sender::Sender(const gu::Config&  conf,
 }
 
 
+/*
+ * Double buffered writer: the caller fills buffer() and submits it while
+ * the previously submitted one is being written by the writer thread.
+ */
+class galera::ist::Sender::BlockWriter
+{
+public:
+
+    explicit BlockWriter(Sender& sender)
+        :
+        sender_ (sender),
+        mutex_  (),
+        cond_   (),
+        cur_    (0),
+        pending_(0),
+        error_  (0),
+        exit_   (false),
+        thd_    ()
+    {
+        int const err(gu_thread_create(&thd_, NULL, run_block_writer, this));
+        if (err != 0)
+        {
+            gu_throw_error(err) << "Failed to create IST block writer thread";
+        }
+    }
+
+    ~BlockWriter()
+    {
+        {
+            gu::Lock lock(mutex_);
+            exit_ = true;
+            cond_.broadcast();
+        }
+        gu_thread_join(thd_, NULL);
+    }
+
+    /* buffer to fill with the next block */
+    std::vector<gu::byte_t>& buffer() { return bufs_[cur_]; }
+
+    /* hands buffer() over to writer thread, blocks while the previous
+     * block is being written */
+    void submit()
+    {
+        gu::Lock lock(mutex_);
+        wait_idle(lock);
+        pending_ = &bufs_[cur_];
+        cur_ ^= 1;
+        cond_.broadcast();
+    }
+
+    /* waits until all submitted blocks are written */
+    void flush()
+    {
+        gu::Lock lock(mutex_);
+        wait_idle(lock);
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            const std::vector<gu::byte_t>* block;
+            {
+                gu::Lock lock(mutex_);
+                while (0 == pending_ && !exit_) lock.wait(cond_);
+                if (0 == pending_) break;
+                block = pending_;
+            }
+
+            int err(0);
+            try
+            {
+                sender_.write_block(*block);
+            }
+            catch (asio::system_error& e)
+            {
+                err = e.code().value();
+            }
+            catch (gu::Exception& e)
+            {
+                err = e.get_errno();
+            }
+
+            gu::Lock lock(mutex_);
+            pending_ = 0;
+            if (err) error_ = err;
+            cond_.broadcast();
+        }
+    }
+
+private:
+
+    void wait_idle(gu::Lock& lock)
+    {
+        while (pending_ != 0 && 0 == error_) lock.wait(cond_);
+
+        if (error_)
+        {
+            gu_throw_error(error_) << "ist send failed";
+        }
+    }
+
+    static void* run_block_writer(void* arg)
+    {
+        static_cast<BlockWriter*>(arg)->run();
+        return 0;
+    }
+
+    Sender&                        sender_;
+    gu::Mutex                      mutex_;
+    gu::Cond                       cond_;
+    std::vector<gu::byte_t>        bufs_[2];
+    int                            cur_;
+    const std::vector<gu::byte_t>* pending_;
+    int                            error_;
+    bool                           exit_;
+    gu_thread_t                    thd_;
+
+    BlockWriter(const BlockWriter&);
+    void operator=(const BlockWriter&);
+};
+
+
+void galera::ist::Sender::write_block(const std::vector<gu::byte_t>& block)
+{
+    if (use_ssl_ == true)
+    {
+        asio::write(*ssl_stream_, asio::buffer(block));
+    }
+    else
+    {
+        asio::write(socket_, asio::buffer(block));
+    }
+}
+
+
 galera::ist::Sender::~Sender()
 {
     if (use_ssl_ == true)
@@ -734,6 +1159,100 @@ galera::ist::Sender::~Sender()
     gcache_.seqno_unlock();
 }
 
+/*
+ * Additional connection to receiver, sends its stripes in own thread
+ */
+class galera::ist::Sender::Stream
+{
+public:
+
+    /* parent must hold gcache lock at first */
+    Stream(Sender& parent, int const index, size_t const streams,
+           wsrep_seqno_t const first, wsrep_seqno_t const last)
+        :
+        sender_(parent.conf_, parent.gcache_, parent.peer_, parent.version_),
+        pool_  (1, 0, ""),
+        proto_ (pool_, parent.version_,
+                parent.conf_.get(CONF_KEEP_KEYS, CONF_KEEP_KEYS_DEFAULT)),
+        first_ (first),
+        last_  (last),
+        error_ (0),
+        thd_   (),
+        started_(false)
+    {
+        parent.gcache_.seqno_lock(first); // released in sender_ dtor
+        proto_.set_compress(parent.conf_.get<bool>(CONF_COMPRESS));
+        sender_.handshake(proto_, index, streams);
+    }
+
+    void start()
+    {
+        int const err(gu_thread_create(&thd_, NULL, run_stream, this));
+        if (err != 0)
+        {
+            gu_throw_error(err) << "Failed to create IST sender stream thread";
+        }
+        started_ = true;
+    }
+
+    /* returns error code of the stream */
+    int join()
+    {
+        if (started_) gu_thread_join(thd_, NULL);
+        return error_;
+    }
+
+    void cancel() { sender_.cancel(); }
+
+private:
+
+    void run()
+    {
+        try
+        {
+            sender_.send_stripes(proto_, first_, last_);
+        }
+        catch (asio::system_error& e)
+        {
+            log_error << "IST sender stream " << proto_.stream()
+                      << " failed: " << e.what();
+            error_ = e.code().value();
+        }
+        catch (gu::Exception& e)
+        {
+            log_error << "IST sender stream " << proto_.stream()
+                      << " failed: " << e.what();
+            error_ = e.get_errno();
+        }
+    }
+
+    static void* run_stream(void* arg)
+    {
+        static_cast<Stream*>(arg)->run();
+        return 0;
+    }
+
+    Sender               sender_;
+    TrxHandle::SlavePool pool_; // unused
+    Proto                proto_;
+    wsrep_seqno_t const  first_;
+    wsrep_seqno_t const  last_;
+    int                  error_;
+    gu_thread_t          thd_;
+    bool                 started_;
+
+    Stream(const Stream&);
+    void operator=(const Stream&);
+};
+
+
+namespace
+{
+    // write sets in a stripe which streams take in turns
+    static wsrep_seqno_t const SEND_STRIPE(1024);
+}
+
+
 void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
 {
     if (first > last)
@@ -741,102 +1260,246 @@ void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
         gu_throw_error(EINVAL) << "sender send first greater than last: "
                                << first << " > " << last ;
     }
+
     try
     {
         TrxHandle::SlavePool unused(1, 0, "");
         Proto p(unused, version_,
                 conf_.get(CONF_KEEP_KEYS, CONF_KEEP_KEYS_DEFAULT));
-        int32_t ctrl;
+        p.set_compress(conf_.get<bool>(CONF_COMPRESS));
 
-        if (use_ssl_ == true)
-        {
-            p.recv_handshake(*ssl_stream_);
-            p.send_handshake_response(*ssl_stream_);
-            ctrl = p.recv_ctrl(*ssl_stream_);
-        }
-        else
-        {
-            p.recv_handshake(socket_);
-            p.send_handshake_response(socket_);
-            ctrl = p.recv_ctrl(socket_);
-        }
-        if (ctrl < 0)
-        {
-            gu_throw_error(EPROTO)
-                << "ist send failed, peer reported error: " << ctrl;
-        }
+        // no more streams than stripes
+        handshake(p, 0, (last - first) / SEND_STRIPE + 1);
 
-        std::vector<gcache::GCache::Buffer> buf_vec(
-            std::min(static_cast<size_t>(last - first + 1),
-                     static_cast<size_t>(1024)));
-        ssize_t n_read;
-        while ((n_read = gcache_.seqno_get_buffers(buf_vec, first)) > 0)
+        if (p.streams() > 1)
         {
-            GU_DBUG_SYNC_WAIT("ist_sender_send_after_get_buffers")
-            //log_info << "read " << first << " + " << n_read << " from gcache";
-            for (wsrep_seqno_t i(0); i < n_read; ++i)
-            {
-                // log_info << "sending " << buf_vec[i].seqno_g();
-                if (use_ssl_ == true)
-                {
-                    p.send_trx(*ssl_stream_, buf_vec[i]);
-                }
-                else
-                {
-                    p.send_trx(socket_, buf_vec[i]);
-                }
+            log_info << "IST sending over " << p.streams() << " streams";
 
-                if (buf_vec[i].seqno_g() == last)
-                {
-                    if (use_ssl_ == true)
-                    {
-                        p.send_ctrl(*ssl_stream_, Ctrl::C_EOF);
-                    }
-                    else
-                    {
-                        p.send_ctrl(socket_, Ctrl::C_EOF);
-                    }
-                    // wait until receiver closes the connection
-                    try
-                    {
-                        gu::byte_t b;
-                        size_t n;
-                        if (use_ssl_ == true)
-                        {
-                            n = asio::read(*ssl_stream_, asio::buffer(&b, 1));
-                        }
-                        else
-                        {
-                            n = asio::read(socket_, asio::buffer(&b, 1));
-                        }
-                        if (n > 0)
-                        {
-                            log_warn << "received " << n
-                                     << " bytes, expected none";
-                        }
-                    }
-                    catch (asio::system_error& e)
-                    { }
-                    return;
-                }
-            }
-            first += n_read;
-            // resize buf_vec to avoid scanning gcache past last
-            size_t next_size(std::min(static_cast<size_t>(last - first + 1),
-                                      static_cast<size_t>(1024)));
-
-            if (buf_vec.size() != next_size)
+            for (size_t i(1); i < p.streams(); ++i)
             {
-                buf_vec.resize(next_size);
+                Stream* const s(new Stream(*this, i, p.streams(),
+                                           first, last));
+                gu::Lock lock(streams_mutex_);
+                streams_.push_back(s);
             }
+
+            for (size_t i(0); i < streams_.size(); ++i) streams_[i]->start();
         }
+
+        send_stripes(p, first, last);
     }
     catch (asio::system_error& e)
     {
+        cancel_streams();
+        join_streams();
         gu_throw_error(e.code().value()) << "ist send failed: " << e.code()
                                          << "', asio error '" << e.what()
                                          << "'";
     }
+    catch (...)
+    {
+        cancel_streams();
+        join_streams();
+        throw;
+    }
+
+    int const err(join_streams());
+    if (err != 0)
+    {
+        gu_throw_error(err) << "ist send failed in parallel stream";
+    }
+}
+
+
+void galera::ist::Sender::cancel_streams()
+{
+    gu::Lock lock(streams_mutex_);
+    for (size_t i(0); i < streams_.size(); ++i) streams_[i]->cancel();
+}
+
+
+int galera::ist::Sender::join_streams()
+{
+    int err(0);
+
+    for (size_t i(0); i < streams_.size(); ++i)
+    {
+        int const stream_err(streams_[i]->join());
+        if (0 == err) err = stream_err;
+    }
+
+    gu::Lock lock(streams_mutex_);
+    for (size_t i(0); i < streams_.size(); ++i) delete streams_[i];
+    streams_.clear();
+
+    return err;
+}
+
+
+void galera::ist::Sender::cancel()
+{
+    if (use_ssl_ == true)
+    {
+        ssl_stream_->lowest_layer().close();
+    }
+    else
+    {
+        socket_.close();
+    }
+
+    gu::Lock lock(streams_mutex_);
+    for (size_t i(0); i < streams_.size(); ++i) streams_[i]->cancel();
+}
+
+
+void galera::ist::Sender::handshake(Proto& p, int const index,
+                                    size_t const streams)
+{
+    int32_t ctrl;
+
+    if (use_ssl_ == true)
+    {
+        p.recv_handshake(*ssl_stream_);
+    }
+    else
+    {
+        p.recv_handshake(socket_);
+    }
+
+    // receiver told its maximum
+    p.set_streams(std::min(std::min(p.streams(), streams),
+                           size_t(Proto::MAX_STREAMS)));
+    p.set_stream(index);
+
+    if (use_ssl_ == true)
+    {
+        p.send_handshake_response(*ssl_stream_);
+        ctrl = p.recv_ctrl(*ssl_stream_);
+    }
+    else
+    {
+        p.send_handshake_response(socket_);
+        ctrl = p.recv_ctrl(socket_);
+    }
+
+    if (ctrl < 0)
+    {
+        gu_throw_error(EPROTO)
+            << "ist send failed, peer reported error: " << ctrl;
+    }
+}
+
+
+/* Stream i sends stripes i, i + streams, i + 2*streams, ... */
+void galera::ist::Sender::send_stripes(Proto&              p,
+                                       wsrep_seqno_t const first,
+                                       wsrep_seqno_t const last)
+{
+    size_t const batch_size(conf_.get<size_t>(CONF_SEND_BATCH));
+
+    /* compressed batches are written by a separate thread, so that
+     * compression of the next batch overlaps with sending */
+    std::auto_ptr<BlockWriter> writer(p.compress() ?
+                                      new BlockWriter(*this) : 0);
+    if (writer.get() && 0 == p.stream())
+    {
+        log_info << "IST stream is compressed";
+    }
+
+    wsrep_seqno_t const step(SEND_STRIPE * p.streams());
+    std::vector<gcache::GCache::Buffer> buf_vec;
+
+    for (wsrep_seqno_t stripe(first + SEND_STRIPE * p.stream());
+         stripe <= last; stripe += step)
+    {
+        wsrep_seqno_t const stripe_last(std::min(stripe + SEND_STRIPE - 1,
+                                                 last));
+
+        for (wsrep_seqno_t seqno(stripe); seqno <= stripe_last; )
+        {
+            // size buf_vec to avoid scanning gcache past stripe end
+            buf_vec.resize(stripe_last - seqno + 1);
+
+            ssize_t const n_read(gcache_.seqno_get_buffers(buf_vec, seqno));
+            if (n_read <= 0) return;
+
+            GU_DBUG_SYNC_WAIT("ist_sender_send_after_get_buffers")
+            //log_info << "read " << seqno << " + " << n_read << " from gcache";
+            send_buffers(p, writer.get(), buf_vec, n_read, batch_size);
+            seqno += n_read;
+        }
+    }
+
+    if (writer.get())
+    {
+        writer->flush();
+        writer.reset();
+    }
+
+    send_eof(p);
+}
+
+
+void galera::ist::Sender::send_buffers(
+    Proto&                                     p,
+    BlockWriter* const                         writer,
+    const std::vector<gcache::GCache::Buffer>& bufs,
+    size_t const                               n,
+    size_t const                               batch_size)
+{
+    if (writer)
+    {
+        for (size_t i(0); i < n; )
+        {
+            size_t bytes;
+            i = p.next_batch(bufs, i, n, batch_size, bytes);
+            p.compress_batch(bytes, writer->buffer());
+            writer->submit();
+        }
+    }
+    else if (use_ssl_ == true)
+    {
+        p.send_trxs(*ssl_stream_, bufs, n, batch_size, true);
+    }
+    else
+    {
+        p.send_trxs(socket_, bufs, n, batch_size, false);
+    }
+}
+
+
+void galera::ist::Sender::send_eof(Proto& p)
+{
+    if (use_ssl_ == true)
+    {
+        p.send_ctrl(*ssl_stream_, Ctrl::C_EOF);
+    }
+    else
+    {
+        p.send_ctrl(socket_, Ctrl::C_EOF);
+    }
+
+    // wait until receiver closes the connection
+    try
+    {
+        gu::byte_t b;
+        size_t n;
+        if (use_ssl_ == true)
+        {
+            n = asio::read(*ssl_stream_, asio::buffer(&b, 1));
+        }
+        else
+        {
+            n = asio::read(socket_, asio::buffer(&b, 1));
+        }
+        if (n > 0)
+        {
+            log_warn << "received " << n
+                     << " bytes, expected none";
+        }
+    }
+    catch (asio::system_error& e)
+    { }
 }
 
 
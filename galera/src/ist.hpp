@@ -13,9 +13,11 @@
 #include "gu_lock.hpp"
 #include "gu_monitor.hpp"
 #include "gu_asio.hpp"
+#include "gu_progress.hpp"
 
-#include <stack>
+#include <deque>
 #include <set>
+#include <vector>
 
 namespace gcache
 {
@@ -28,6 +30,8 @@ namespace galera
 
     namespace ist
     {
+        class Proto;
+
         void register_params(gu::Config& conf);
 
         class Receiver
@@ -35,8 +39,12 @@ namespace galera
         public:
             static std::string const RECV_ADDR;
             static std::string const RECV_BIND;
+            static std::string const RECV_QUEUE;
+            static std::string const RECV_STREAMS;
+            static std::string const RECV_GCACHE;
 
-            Receiver(gu::Config& conf, TrxHandle::SlavePool&, const char* addr);
+            Receiver(gu::Config& conf, gcache::GCache&, TrxHandle::SlavePool&,
+                     const char* addr);
             ~Receiver();
 
             std::string   prepare(wsrep_seqno_t, wsrep_seqno_t, int);
@@ -52,7 +60,13 @@ namespace galera
 
         private:
 
+            class Stream; // connection from sender
+
+            int  receive(Stream&);
+            bool stripes_stuck() const;
+            void shutdown_streams();
             void interrupt();
+            void discard(TrxHandle*);
 
             std::string                                   recv_addr_;
             std::string                                   recv_bind_;
@@ -67,53 +81,36 @@ namespace galera
             gu::Cond                                      cond_;
 #endif /* HAVE_PSI_INTERFACE */
 
-            class Consumer
-            {
-            public:
-
-#ifdef HAVE_PSI_INTERFACE
-                Consumer()
-                    :
-                    cond_(WSREP_PFS_INSTR_TAG_IST_CONSUMER_CONDVAR),
-                    trx_(0)
-                { }
-#else
-                Consumer() : cond_(), trx_(0) { }
-#endif
-                ~Consumer() { }
-
-#ifdef HAVE_PSI_INTERFACE
-                gu::CondWithPFS&  cond()        { return cond_; }
-#else
-                gu::Cond&  cond()              { return cond_; }
-#endif /* HAVE_PSI_INTERFACE */
-                void       trx(TrxHandle* trx) { trx_ = trx;   }
-                TrxHandle* trx() const         { return trx_;  }
-
-            private:
-
-                // Non-copyable
-                Consumer(const Consumer&);
-                Consumer& operator=(const Consumer&);
-
+            // consumers wait here for write sets in the queue
 #ifdef HAVE_PSI_INTERFACE
-                gu::CondWithPFS   cond_;
+            gu::CondWithPFS                               consumer_cond_;
 #else
-                gu::Cond   cond_;
+            gu::Cond                                      consumer_cond_;
 #endif /* HAVE_PSI_INTERFACE */
-                TrxHandle* trx_;
-            };
-
-            std::stack<Consumer*> consumers_;
+            // write sets received ahead of consumers, bounded by
+            // ist.recv_queue, so that receiving and parsing pipelines with
+            // applying
+            std::deque<TrxHandle*> queue_;
+            size_t                queue_max_;
+            // parallel connections, each delivering its stripes of write
+            // sets into queue_ in total order
+            std::vector<Stream*>  streams_;
+            size_t                streams_max_;
+            size_t                streams_done_;
+            int                   streams_error_;
+            gu::Progress<wsrep_seqno_t>* progress_;
             wsrep_seqno_t         current_seqno_;
             wsrep_seqno_t         first_seqno_;
             wsrep_seqno_t         last_seqno_;
             gu::Config&           conf_;
+            gcache::GCache&       gcache_;
             TrxHandle::SlavePool& trx_pool_;
             gu_thread_t           thread_;
             int                   error_code_;
             int                   version_;
             bool                  use_ssl_;
+            // store received write sets in gcache, ist.recv_gcache
+            bool                  use_gcache_;
             bool                  running_;
             bool                  interrupted_;
             bool                  ready_;
@@ -135,28 +132,35 @@ namespace galera
 
             void send(wsrep_seqno_t first, wsrep_seqno_t last);
 
-            void cancel()
-            {
-                if (use_ssl_ == true)
-                {
-                    ssl_stream_->lowest_layer().close();
-                }
-                else
-                {
-                    socket_.close();
-                }
-            }
+            void cancel();
 
         private:
 
+            class BlockWriter; // writes compressed stream in background
+            class Stream;      // additional connection to receiver
+
+            void handshake(Proto& p, int index, size_t streams);
+            void cancel_streams();
+            int  join_streams();
+            void send_stripes(Proto& p, wsrep_seqno_t first,
+                              wsrep_seqno_t last);
+            void send_buffers(Proto& p, BlockWriter* writer,
+                              const std::vector<gcache::GCache::Buffer>& bufs,
+                              size_t n, size_t batch_size);
+            void send_eof(Proto& p);
+            void write_block(const std::vector<gu::byte_t>& block);
+
             asio::io_service                          io_service_;
             asio::ip::tcp::socket                     socket_;
             asio::ssl::context                        ssl_ctx_;
             asio::ssl::stream<asio::ip::tcp::socket>* ssl_stream_;
             const gu::Config&                         conf_;
             gcache::GCache&                           gcache_;
+            std::string const                         peer_;
             int                                       version_;
             bool                                      use_ssl_;
+            gu::Mutex                                 streams_mutex_;
+            std::vector<Stream*>                      streams_;
 
             Sender(const Sender&);
             void operator=(const Sender&);
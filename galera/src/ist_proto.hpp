@@ -13,6 +13,10 @@
 #include "gu_serialize.hpp"
 #include "gu_vector.hpp"
 #include "gu_array.hpp"
+#include "gu_lz.hpp"
+
+#include <algorithm>
+#include <vector>
 
 //
 // Message class must have non-virtual destructor until
@@ -32,7 +36,7 @@
 //                          <-----   send_handshake()
 // send_handshake_response() ----->
 //                          <-----   send_ctrl(OK)
-// send_trx()                ----->
+// send_trxs()               ----->
 //                           ----->
 // send_ctrl(EOF)            ----->
 //                          <-----   close()
@@ -59,9 +63,17 @@ namespace galera
                 T_HANDSHAKE = 1,
                 T_HANDSHAKE_RESPONSE = 2,
                 T_CTRL = 3,
-                T_TRX = 4
+                T_TRX = 4,
+                T_COMPRESSED = 5 // block of compressed messages
             } Type;
 
+            enum
+            {
+                // handshake: receiver can decompress,
+                // handshake response: stream will be compressed
+                F_COMPRESS = 1 << 0
+            };
+
             Message(int       version = -1,
                     Type      type    = T_NONE,
                     uint8_t   flags   = 0,
@@ -192,21 +204,28 @@ namespace galera
             uint64_t len_;
         };
 
+        // len field carries maximum number of streams receiver accepts,
+        // 0 from older versions means 1
         class Handshake : public Message
         {
         public:
-            Handshake(int version = -1)
+            Handshake(int version = -1, uint8_t flags = 0,
+                      uint64_t streams = 0)
                 :
-                Message(version, Message::T_HANDSHAKE, 0, 0, 0)
+                Message(version, Message::T_HANDSHAKE, flags, 0, streams)
             { }
         };
 
+        // ctrl field carries index of the stream being set up, len field
+        // the number of streams sender is going to use, 0 means 1
         class HandshakeResponse : public Message
         {
         public:
-            HandshakeResponse(int version = -1)
+            HandshakeResponse(int version = -1, uint8_t flags = 0,
+                              int8_t stream = 0, uint64_t streams = 0)
                 :
-                Message(version, Message::T_HANDSHAKE_RESPONSE, 0, 0, 0)
+                Message(version, Message::T_HANDSHAKE_RESPONSE, flags,
+                        stream, streams)
             { }
         };
 
@@ -239,13 +258,30 @@ namespace galera
         {
         public:
 
+            // stream index is sent in 1 byte ctrl field
+            static size_t const MAX_STREAMS = 64;
+
             Proto(TrxHandle::SlavePool& sp, int version, bool keep_keys)
                 :
                 trx_pool_ (sp),
+                gcache_   (0),
                 raw_sent_ (0),
                 real_sent_(0),
                 version_  (version),
-                keep_keys_(keep_keys)
+                keep_keys_(keep_keys),
+                compress_ (false),
+                stream_   (0),
+                streams_  (1),
+                arena_    (),
+                segs_     (),
+                cbs_      (),
+                linear_   (),
+                zbuf_     (),
+                zpos_     (0),
+                hdr_      (),
+                rbuf_     (),
+                rpos_     (0),
+                rend_     (0)
             { }
 
             ~Proto()
@@ -265,7 +301,8 @@ namespace galera
             template <class ST>
             void send_handshake(ST& socket)
             {
-                Handshake  hs(version_);
+                Handshake  hs(version_, compress_ ? Message::F_COMPRESS : 0,
+                              streams_);
                 gu::Buffer buf(hs.serial_size());
                 size_t offset(hs.serialize(&buf[0], buf.size(), 0));
                 size_t n(asio::write(socket, asio::buffer(&buf[0],
@@ -319,12 +356,17 @@ namespace galera
                                            << version_;
                 }
                 // TODO: Figure out protocol versions to use
+
+                compress_ = compress_ && (msg.flags() & Message::F_COMPRESS);
+                streams_  = std::max<uint64_t>(msg.len(), 1);
             }
 
             template <class ST>
             void send_handshake_response(ST& socket)
             {
-                HandshakeResponse hsr(version_);
+                HandshakeResponse hsr(version_,
+                                      compress_ ? Message::F_COMPRESS : 0,
+                                      stream_, streams_);
                 gu::Buffer buf(hsr.serial_size());
                 size_t offset(hsr.serialize(&buf[0], buf.size(), 0));
                 size_t n(asio::write(socket, asio::buffer(&buf[0], buf.size())));
@@ -356,6 +398,9 @@ namespace galera
                 switch (msg.type())
                 {
                 case Message::T_HANDSHAKE_RESPONSE:
+                    compress_ = (msg.flags() & Message::F_COMPRESS);
+                    stream_   = msg.ctrl();
+                    streams_  = std::max<uint64_t>(msg.len(), 1);
                     break;
                 case Message::T_CTRL:
                     switch (msg.ctrl())
@@ -414,86 +459,137 @@ namespace galera
             }
 
 
+            /*
+             * Sends write sets from buffers[0, n) in batches of about
+             * batch_size bytes, one gathering write per batch. Message
+             * headers are serialized into a common arena and payloads are
+             * sent directly from gcache memory. If linearize is set, batch
+             * is copied into a contiguous buffer first: this is for streams
+             * which write one buffer at a time (SSL), to produce full size
+             * records. Compressed stream is sent with compress_batch().
+             */
             template <class ST>
-            void send_trx(ST&                           socket,
-                          const gcache::GCache::Buffer& buffer)
+            void send_trxs(ST&                                        socket,
+                           const std::vector<gcache::GCache::Buffer>& buffers,
+                           size_t const                               n,
+                           size_t const                               batch_size,
+                           bool const                                 linearize)
             {
-                const bool rolled_back(buffer.seqno_d() == -1);
-
-                galera::WriteSetIn ws;
-                gu::array<asio::const_buffer, 3>::type cbs;
-                size_t      payload_size; /* size of the 2nd cbs buffer */
-                size_t      sent;
+                assert(!compress_);
 
-                if (gu_unlikely(rolled_back))
-                {
-                    payload_size = 0;
-                }
-                else
+                size_t i(0);
+                while (i < n)
                 {
-                    if (keep_keys_ || version_ < WS_NG_VERSION)
-                    {
-                        payload_size = buffer.size();
-                        const void* const ptr(buffer.ptr());
-                        cbs[1] = asio::const_buffer(ptr, payload_size);
-                        cbs[2] = asio::const_buffer(ptr, 0);
-                    }
-                    else
-                    {
-                        gu::Buf tmp = { buffer.ptr(), buffer.size() };
-                        ws.read_buf (tmp, 0);
+                    size_t batch;
+                    i = next_batch(buffers, i, n, batch_size, batch);
 
-                        WriteSetIn::GatherVector out;
-                        payload_size = ws.gather (out, false, false);
-                        assert (2 == out->size());
-                        cbs[1] = asio::const_buffer(out[0].ptr, out[0].size);
-                        cbs[2] = asio::const_buffer(out[1].ptr, out[1].size);
-                    }
-                }
+                    size_t const sent(write_batch(socket, batch, linearize));
 
-                size_t const trx_meta_size(
-                    8 /* serial_size(buffer.seqno_g()) */ +
-                    8 /* serial_size(buffer.seqno_d()) */
-                    );
-
-                Trx trx_msg(version_, trx_meta_size + payload_size);
+                    log_debug << "sent " << sent << " bytes";
+                }
+            }
 
-                gu::Buffer buf(trx_msg.serial_size() + trx_meta_size);
-                size_t  offset(trx_msg.serialize(&buf[0], buf.size(), 0));
+            /*
+             * Makes the next send batch of about batch_size bytes from
+             * buffers[begin, n). Returns index of the first buffer not
+             * included, batch size in bytes is returned in bytes.
+             */
+            size_t next_batch(const std::vector<gcache::GCache::Buffer>& buffers,
+                              size_t const begin,
+                              size_t const n,
+                              size_t const batch_size,
+                              size_t&      bytes)
+            {
+                assert(begin < n);
+                assert(n <= buffers.size());
 
-                offset = gu::serialize8(buffer.seqno_g(),
-                                        &buf[0], buf.size(), offset);
-                offset = gu::serialize8(buffer.seqno_d(),
-                                        &buf[0], buf.size(), offset);
-                cbs[0] = asio::const_buffer(&buf[0], buf.size());
+                arena_.clear();
+                segs_.clear();
 
-                if (gu_likely(payload_size))
-                {
-                    sent = asio::write(socket, cbs);
-                }
-                else
+                size_t i(begin);
+                bytes = 0;
+                do
                 {
-                    sent = asio::write(socket, asio::buffer(cbs[0]));
+                    bytes += append_trx(buffers[i]);
+                    ++i;
                 }
+                while (i < n && bytes < batch_size);
 
-                log_debug << "sent " << sent << " bytes";
+                return i;
             }
 
+            /*
+             * Compresses the current batch of bytes into a T_COMPRESSED
+             * message in block. The message carries uncompressed size
+             * followed by gu::lz compressed batch.
+             */
+            void compress_batch(size_t const bytes,
+                                std::vector<gu::byte_t>& block)
+            {
+                assert(compress_);
+
+                linearize(bytes);
+
+                size_t const hdr_size(Message(version_).serial_size() + 8);
+                block.resize(hdr_size + gu::lz::bound(bytes));
+
+                size_t const zsize(gu::lz::compress(&linear_[0], bytes,
+                                                    &block[hdr_size]));
+
+                Message const msg(version_, Message::T_COMPRESSED, 0, 0,
+                                  8 + zsize);
+                size_t offset(msg.serialize(&block[0], block.size(), 0));
+                offset = gu::serialize8(uint64_t(bytes),
+                                        &block[0], block.size(), offset);
+                assert(offset == hdr_size);
 
+                block.resize(hdr_size + zsize);
+
+                raw_sent_  += bytes;
+                real_sent_ += block.size();
+            }
+
+            /* requests compression (sender) or announces decompression
+             * support (receiver), must be called before handshake */
+            void set_compress(bool const val) { compress_ = val; }
+
+            /* whether the stream is compressed, valid after handshake */
+            bool compress() const { return compress_; }
+
+            /* Number of parallel streams: before handshake maximum
+             * acceptable (receiver) or to be used (sender), after handshake
+             * maximum acceptable to peer (sender) or used (receiver). */
+            void   set_streams(size_t const val) { streams_ = val; }
+            size_t streams() const { return streams_; }
+
+            /* index of this stream, sent in handshake response */
+            void set_stream(int const val) { stream_ = val; }
+            int  stream() const { return stream_; }
+
+            /* if set, received write sets are stored in gcache buffers
+             * (receiver), see recv_trx() */
+            void set_gcache(gcache::GCache* const val) { gcache_ = val; }
+
+            /*
+             * Receives next write set of the stream. Stream is read in
+             * large chunks into a receive buffer (see recv_stream()), so
+             * that message headers, seqno meta data and small write sets
+             * of many messages are parsed out of a single read.
+             */
             template <class ST>
             galera::TrxHandle*
             recv_trx(ST& socket)
             {
                 Message    msg(version_);
-                gu::Buffer buf(msg.serial_size());
-                size_t n(asio::read(socket, asio::buffer(&buf[0], buf.size())));
+                hdr_.resize(msg.serial_size());
+                size_t n(recv_stream(socket, &hdr_[0], hdr_.size()));
 
-                if (n != buf.size())
+                if (n != hdr_.size())
                 {
                     gu_throw_error(EPROTO) << "error receiving trx header";
                 }
 
-                (void)msg.unserialize(&buf[0], buf.size(), 0);
+                (void)msg.unserialize(&hdr_[0], hdr_.size(), 0);
 
                 log_debug << "received header: " << n << " bytes, type "
                           << msg.type() << " len " << msg.len();
@@ -502,63 +598,92 @@ namespace galera
                 {
                 case Message::T_TRX:
                 {
-                    // TODO: ideally we want to make seqno_g and cert verdict
-                    // be a part of msg object above, so that we can skip this
-                    // read. The overhead is tiny given that vast majority of
-                    // messages will be trx writesets.
+                    // seqno_g and cert verdict follow the message header,
+                    // they normally come from the receive buffer together
+                    // with the header, without an extra read.
                     wsrep_seqno_t seqno_g, seqno_d;
 
-                    buf.resize(sizeof(seqno_g) + sizeof(seqno_d));
+                    hdr_.resize(sizeof(seqno_g) + sizeof(seqno_d));
 
-                    n = asio::read(socket, asio::buffer(&buf[0], buf.size()));
-                    if (n != buf.size())
+                    n = recv_stream(socket, &hdr_[0], hdr_.size());
+                    if (n != hdr_.size())
                     {
                         gu_throw_error(EPROTO) << "error reading trx meta data";
                     }
 
-                    size_t offset(gu::unserialize8(&buf[0], buf.size(), 0,
+                    size_t offset(gu::unserialize8(&hdr_[0], hdr_.size(), 0,
                                                    seqno_g));
-                    offset = gu::unserialize8(&buf[0], buf.size(), offset,
+                    offset = gu::unserialize8(&hdr_[0], hdr_.size(), offset,
                                               seqno_d);
 
-                    galera::TrxHandle* trx(galera::TrxHandle::New(trx_pool_));
-
-                    if (seqno_d == WSREP_SEQNO_UNDEFINED)
+                    if (seqno_d == WSREP_SEQNO_UNDEFINED &&
+                        offset != msg.len())
                     {
-                        if (offset != msg.len())
-                        {
-                            gu_throw_error(EINVAL)
-                                << "message size " << msg.len()
-                                << " does not match expected size " << offset;
-                        }
+                        gu_throw_error(EINVAL)
+                            << "message size " << msg.len()
+                            << " does not match expected size " << offset;
                     }
-                    else
-                    {
-                        MappedBuffer& wbuf(trx->write_set_collection());
-                        size_t const wsize(msg.len() - offset);
-                        wbuf.resize(wsize);
 
-                        n = asio::read(socket,
-                                       asio::buffer(&wbuf[0], wbuf.size()));
+                    size_t const wsize(msg.len() - offset);
 
-                        if (gu_unlikely(n != wbuf.size()))
+                    /* Rolled back write sets come without payload, but
+                     * still get a (minimal) gcache buffer: gcache history
+                     * must be continuous to be donated from. */
+                    gu::byte_t* const gbuf(gcache_ ?
+                                           static_cast<gu::byte_t*>(
+                                               gcache_->malloc(
+                                                   std::max(wsize,
+                                                            size_t(1))))
+                                           : NULL);
+
+                    galera::TrxHandle* trx(0);
+
+                    try
+                    {
+                        trx = galera::TrxHandle::New(trx_pool_);
+
+                        if (seqno_d != WSREP_SEQNO_UNDEFINED)
                         {
-                            gu_throw_error(EPROTO)
-                                << "error reading write set data";
+                            gu::byte_t* ws;
+
+                            if (gbuf)
+                            {
+                                ws = gbuf;
+                            }
+                            else
+                            {
+                                MappedBuffer& wbuf(trx->write_set_collection());
+                                wbuf.resize(wsize);
+                                ws = &wbuf[0];
+                            }
+
+                            n = recv_stream(socket, ws, wsize);
+
+                            if (gu_unlikely(n != wsize))
+                            {
+                                gu_throw_error(EPROTO)
+                                    << "error reading write set data";
+                            }
+
+                            trx->unserialize(ws, wsize, 0);
                         }
-
-                        trx->unserialize(&wbuf[0], wbuf.size(), 0);
+                    }
+                    catch (...)
+                    {
+                        if (gbuf) gcache_->free(gbuf);
+                        if (trx)  trx->unref();
+                        throw;
                     }
 
                     if (seqno_d == WSREP_SEQNO_UNDEFINED ||
                         trx->version() < 3)
                     {
-                        trx->set_received(0, -1, seqno_g);
+                        trx->set_received(gbuf, -1, seqno_g);
                         trx->set_depends_seqno(seqno_d);
                     }
                     else
                     {
-                        trx->set_received_from_ws();
+                        trx->set_received_from_ws(gbuf);
                         assert(trx->global_seqno() == seqno_g);
                         assert(trx->depends_seqno() >= seqno_d);
                     }
@@ -594,12 +719,311 @@ namespace galera
 
         private:
 
+            /* part of a send batch: either in arena_ (ptr_ == NULL) or in
+             * gcache */
+            struct Segment
+            {
+                const gu::byte_t* ptr_;
+                size_t            offset_;
+                size_t            size_;
+            };
+
+            void append_segment(const gu::byte_t* ptr, size_t offset,
+                                size_t size)
+            {
+                if (gu_likely(size > 0))
+                {
+                    Segment const seg = { ptr, offset, size };
+                    segs_.push_back(seg);
+                }
+            }
+
+            /* serializes trx message header into arena_ and adds its
+             * segments to the batch, returns message size */
+            size_t append_trx(const gcache::GCache::Buffer& buffer)
+            {
+                const bool rolled_back(buffer.seqno_d() == -1);
+
+                galera::WriteSetIn ws;
+                WriteSetIn::GatherVector out;
+                size_t payload_size(0);
+
+                if (gu_likely(!rolled_back))
+                {
+                    if (keep_keys_ || version_ < WS_NG_VERSION)
+                    {
+                        gu::Buf const buf = { buffer.ptr(), buffer.size() };
+                        out->push_back(buf);
+                        payload_size = buffer.size();
+                    }
+                    else
+                    {
+                        gu::Buf tmp = { buffer.ptr(), buffer.size() };
+                        ws.read_buf (tmp, 0);
+                        payload_size = ws.gather (out, false, false);
+                        assert (out->size() >= 2);
+                    }
+                }
+
+                size_t const trx_meta_size(
+                    8 /* serial_size(buffer.seqno_g()) */ +
+                    8 /* serial_size(buffer.seqno_d()) */
+                    );
+
+                Trx trx_msg(version_, trx_meta_size + payload_size);
+
+                /* stripped write set header is a temporary copy in ws,
+                 * so it goes to arena_ together with the message header */
+                bool const copy_first(!keep_keys_ &&
+                                      version_ >= WS_NG_VERSION &&
+                                      !rolled_back);
+                size_t const begin(arena_.size());
+                size_t const hdr_size(trx_msg.serial_size() + trx_meta_size);
+                size_t const copy_size(copy_first ? out[0].size : 0);
+
+                arena_.resize(begin + hdr_size + copy_size);
+
+                size_t offset(trx_msg.serialize(&arena_[0], arena_.size(),
+                                                begin));
+                offset = gu::serialize8(buffer.seqno_g(),
+                                        &arena_[0], arena_.size(), offset);
+                offset = gu::serialize8(buffer.seqno_d(),
+                                        &arena_[0], arena_.size(), offset);
+                assert(offset == begin + hdr_size);
+
+                if (copy_size > 0)
+                {
+                    ::memcpy(&arena_[offset], out[0].ptr, copy_size);
+                }
+
+                append_segment(NULL, begin, hdr_size + copy_size);
+
+                for (size_t i(copy_first ? 1 : 0); i < out->size(); ++i)
+                {
+                    append_segment(static_cast<const gu::byte_t*>(out[i].ptr),
+                                   0, out[i].size);
+                }
+
+                return hdr_size + payload_size;
+            }
+
+            const gu::byte_t* segment_ptr(const Segment& seg) const
+            {
+                return (seg.ptr_ ? seg.ptr_ : &arena_[seg.offset_]);
+            }
+
+            /* copies batch of bytes into linear_ */
+            void linearize(size_t const batch)
+            {
+                linear_.resize(batch);
+                gu::byte_t* ptr(&linear_[0]);
+
+                for (size_t i(0); i < segs_.size(); ++i)
+                {
+                    ::memcpy(ptr, segment_ptr(segs_[i]), segs_[i].size_);
+                    ptr += segs_[i].size_;
+                }
+                assert(ptr == &linear_[0] + batch);
+            }
+
+            template <class ST>
+            size_t write_batch(ST& socket, size_t const batch,
+                               bool const linearize)
+            {
+                if (linearize)
+                {
+                    this->linearize(batch);
+
+                    return asio::write(socket, asio::buffer(&linear_[0],
+                                                            batch));
+                }
+                else
+                {
+                    cbs_.clear();
+
+                    for (size_t i(0); i < segs_.size(); ++i)
+                    {
+                        cbs_.push_back(asio::const_buffer(segment_ptr(segs_[i]),
+                                                          segs_[i].size_));
+                    }
+
+                    return asio::write(socket, cbs_);
+                }
+            }
+
+            /* reads len bytes of message stream, decompressing it if
+             * the stream is compressed */
+            template <class ST>
+            size_t recv_stream(ST& socket, void* const ptr, size_t const len)
+            {
+                gu::byte_t* const dst(static_cast<gu::byte_t*>(ptr));
+
+                if (!compress_)
+                {
+                    return recv_buffered(socket, dst, len);
+                }
+
+                size_t n(0);
+
+                while (n < len)
+                {
+                    if (zpos_ == zbuf_.size()) recv_block(socket);
+
+                    size_t const chunk(std::min(len - n, zbuf_.size() - zpos_));
+                    ::memcpy(dst + n, &zbuf_[zpos_], chunk);
+                    zpos_ += chunk;
+                    n     += chunk;
+                }
+
+                return n;
+            }
+
+            /* Reads len bytes of uncompressed stream. Data is served from
+             * rbuf_ which is refilled with as much as the socket has
+             * available, at least the part of len which is still missing.
+             * Remainders larger than the buffer are read directly to dst.
+             * Stream must not be read past the EOF message, so this may be
+             * used only for the write set stream. */
+            template <class ST>
+            size_t recv_buffered(ST& socket, gu::byte_t* const dst,
+                                 size_t const len)
+            {
+                size_t n(std::min(len, rend_ - rpos_));
+
+                if (n > 0)
+                {
+                    ::memcpy(dst, &rbuf_[rpos_], n);
+                    rpos_ += n;
+                }
+
+                if (n == len) return n;
+
+                assert(rpos_ == rend_);
+                rpos_ = rend_ = 0;
+
+                if (len - n >= RECV_BUF_SIZE / 2)
+                {
+                    return n + asio::read(socket, asio::buffer(dst + n,
+                                                               len - n));
+                }
+
+                if (rbuf_.empty()) rbuf_.resize(size_t(RECV_BUF_SIZE));
+
+                rend_ = asio::read(socket, asio::buffer(&rbuf_[0],
+                                                        rbuf_.size()),
+                                   asio::transfer_at_least(len - n));
+                assert(rend_ >= len - n);
+
+                rpos_ = len - n;
+                ::memcpy(dst + n, &rbuf_[0], rpos_);
+
+                return len;
+            }
+
+            /* reads next message of compressed stream into zbuf_:
+             * T_COMPRESSED is decompressed, control messages are passed
+             * as is */
+            template <class ST>
+            void recv_block(ST& socket)
+            {
+                Message msg(version_);
+
+                zpos_ = 0;
+                zbuf_.resize(msg.serial_size());
+
+                size_t n(asio::read(socket, asio::buffer(&zbuf_[0],
+                                                         zbuf_.size())));
+                if (n != zbuf_.size())
+                {
+                    gu_throw_error(EPROTO) << "error receiving block header";
+                }
+
+                (void)msg.unserialize(&zbuf_[0], zbuf_.size(), 0);
+
+                if (msg.type() != Message::T_COMPRESSED)
+                {
+                    if (msg.len() > 0)
+                    {
+                        gu_throw_error(EPROTO)
+                            << "unexpected uncompressed message type "
+                            << msg.type() << ", len " << msg.len();
+                    }
+                    return;
+                }
+
+                uint64_t raw_size;
+
+                if (msg.len() < sizeof(raw_size))
+                {
+                    gu_throw_error(EPROTO) << "compressed block too short: "
+                                           << msg.len();
+                }
+
+                linear_.resize(msg.len());
+                n = asio::read(socket, asio::buffer(&linear_[0],
+                                                    linear_.size()));
+                if (n != linear_.size())
+                {
+                    gu_throw_error(EPROTO) << "error receiving compressed "
+                                           << "block";
+                }
+
+                size_t const offset(gu::unserialize8(&linear_[0],
+                                                     linear_.size(), 0,
+                                                     raw_size));
+                size_t const zsize(linear_.size() - offset);
+
+                /* each sequence expands to at most 255*(len - 3) + 19 bytes,
+                 * guard against allocating garbage sizes */
+                if (raw_size > uint64_t(zsize) * 255 + 19)
+                {
+                    gu_throw_error(EPROTO) << "bogus uncompressed size "
+                                           << raw_size << " of " << zsize
+                                           << " bytes block";
+                }
+
+                zbuf_.resize(raw_size);
+
+                try
+                {
+                    gu::lz::decompress(&linear_[offset], zsize,
+                                       raw_size ? &zbuf_[0] : NULL, raw_size);
+                }
+                catch (gu::Exception& e)
+                {
+                    gu_throw_error(EPROTO) << "failed to decompress IST "
+                                           << "block: " << e.what();
+                }
+            }
+
             TrxHandle::SlavePool& trx_pool_;
+            gcache::GCache*       gcache_;
 
             uint64_t raw_sent_;
             uint64_t real_sent_;
             int      version_;
             bool     keep_keys_;
+            bool     compress_;
+            int      stream_;
+            size_t   streams_;
+
+            /* send batch state, reused between batches */
+            std::vector<gu::byte_t>         arena_;
+            std::vector<Segment>            segs_;
+            std::vector<asio::const_buffer> cbs_;
+            std::vector<gu::byte_t>         linear_;  // also compressed input
+
+            /* decompressed stream */
+            std::vector<gu::byte_t>         zbuf_;
+            size_t                          zpos_;
+
+            /* uncompressed stream receive buffer, valid data
+             * in [rpos_, rend_) */
+            static size_t const RECV_BUF_SIZE = (1 << 18);
+            std::vector<gu::byte_t>         hdr_;
+            std::vector<gu::byte_t>         rbuf_;
+            size_t                          rpos_;
+            size_t                          rend_;
         };
     }
 }
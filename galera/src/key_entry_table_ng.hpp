@@ -0,0 +1,169 @@
+//
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+//
+
+#ifndef GALERA_KEY_ENTRY_TABLE_NG_HPP
+#define GALERA_KEY_ENTRY_TABLE_NG_HPP
+
+#include "key_entry_ng.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+namespace galera
+{
+    /*
+     * Open addressing (linear probing) table of KeyEntryNG pointers.
+     *
+     * Key hashes are kept inline in a separate flat array, so that a probe
+     * sequence scans consecutive memory and KeyEntryNG is dereferenced only
+     * on hash match. Zero hash marks empty slot. Entries are not owned by the
+     * table, so their addresses stay valid when the table grows. Erase uses
+     * backward shift deletion, no tombstones are left behind.
+     */
+    class KeyEntryTableNG
+    {
+    public:
+
+        KeyEntryTableNG() : hashes_(), entries_(), size_(0), shift_(0) { }
+
+        /* returns matching entry or NULL */
+        KeyEntryNG* find(const KeyEntryNG& ke) const
+        {
+            if (gu_unlikely(0 == size_)) return NULL;
+
+            size_t const h(stored_hash(ke));
+            size_t const mask(hashes_.size() - 1);
+
+            for (size_t i(home(h)); hashes_[i] != 0; i = (i + 1) & mask)
+            {
+                if (hashes_[i] == h &&
+                    entries_[i]->key().matches(ke.key())) return entries_[i];
+            }
+
+            return NULL;
+        }
+
+        /* kep must not be in the table */
+        void insert(KeyEntryNG* const kep)
+        {
+            assert(NULL == find(*kep));
+
+            if ((size_ + 1) * 2 > hashes_.size()) // keep load factor <= 0.5
+            {
+                grow();
+            }
+
+            place(stored_hash(*kep), kep);
+            ++size_;
+        }
+
+        /* kep must be in the table */
+        void erase(const KeyEntryNG* const kep)
+        {
+            size_t const mask(hashes_.size() - 1);
+            size_t i(home(stored_hash(*kep)));
+
+            while (entries_[i] != kep)
+            {
+                assert(hashes_[i] != 0);
+                i = (i + 1) & mask;
+            }
+
+            /* shift back following entries which would become unreachable */
+            for (size_t j((i + 1) & mask); hashes_[j] != 0; j = (j + 1) & mask)
+            {
+                size_t const k(home(hashes_[j]));
+
+                /* entry at j stays if its home is cyclically in (i, j] */
+                if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+
+                hashes_[i]  = hashes_[j];
+                entries_[i] = entries_[j];
+                i = j;
+            }
+
+            hashes_[i]  = 0;
+            entries_[i] = NULL;
+            --size_;
+        }
+
+        size_t size()         const { return size_; }
+        bool   empty()        const { return 0 == size_; }
+        size_t bucket_count() const { return hashes_.size(); }
+
+        /* applies op to every entry, op must not modify the table */
+        template <class Op>
+        void for_each(Op op) const
+        {
+            for (size_t i(0); i < entries_.size(); ++i)
+            {
+                if (entries_[i] != NULL) op(entries_[i]);
+            }
+        }
+
+        void clear()
+        {
+            std::fill(hashes_.begin(),  hashes_.end(),  0);
+            std::fill(entries_.begin(), entries_.end(),
+                      static_cast<KeyEntryNG*>(NULL));
+            size_ = 0;
+        }
+
+    private:
+
+        static size_t const MIN_BITS = 6; // 64 slots
+
+        static size_t stored_hash(const KeyEntryNG& ke)
+        {
+            return (ke.key().hash() | 1); // never 0
+        }
+
+        /* Fibonacci hashing: upper bits of the product depend on all bits of
+         * the hash, shard selection already fixes some of the lower ones. */
+        size_t home(size_t const h) const
+        {
+            return (uint64_t(h) * GU_ULONG_LONG(0x9E3779B97F4A7C15)) >> shift_;
+        }
+
+        void place(size_t const h, KeyEntryNG* const kep)
+        {
+            size_t const mask(hashes_.size() - 1);
+            size_t i(home(h));
+
+            while (hashes_[i] != 0) i = (i + 1) & mask;
+
+            hashes_[i]  = h;
+            entries_[i] = kep;
+        }
+
+        void grow()
+        {
+            size_t const bits(hashes_.empty() ?
+                              MIN_BITS : 64 - shift_ + 1);
+
+            std::vector<size_t>      hashes(size_t(1) << bits, 0);
+            std::vector<KeyEntryNG*> entries(hashes.size(),
+                                             static_cast<KeyEntryNG*>(NULL));
+            hashes.swap(hashes_);
+            entries.swap(entries_);
+            shift_ = 64 - bits;
+
+            for (size_t i(0); i < hashes.size(); ++i)
+            {
+                if (hashes[i] != 0) place(hashes[i], entries[i]);
+            }
+        }
+
+        KeyEntryTableNG(const KeyEntryTableNG&);
+        void operator=(const KeyEntryTableNG&);
+
+        std::vector<size_t>      hashes_;
+        std::vector<KeyEntryNG*> entries_;
+        size_t                   size_;
+        unsigned int             shift_;
+    };
+}
+
+#endif // GALERA_KEY_ENTRY_TABLE_NG_HPP
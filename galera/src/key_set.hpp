@@ -134,7 +134,7 @@ public:
          * version */
         static int prefix(wsrep_key_type_t const ws_type, int const ws_ver)
         {
-            if (ws_ver >= 0 && ws_ver <= 4)
+            if (ws_ver >= 0 && ws_ver <= 5)
             {
                 switch (ws_type)
                 {
@@ -159,7 +159,7 @@ public:
 
         wsrep_key_type_t wsrep_type(int const ws_ver) const
         {
-            assert(ws_ver >= 0 && ws_ver <= 4);
+            assert(ws_ver >= 0 && ws_ver <= 5);
 
             wsrep_key_type_t ret;
 
@@ -169,10 +169,10 @@ public:
                 ret = WSREP_KEY_SHARED;
                 break;
             case 1:
-                ret = ws_ver == 4 ? WSREP_KEY_SEMI : WSREP_KEY_EXCLUSIVE;
+                ret = ws_ver >= 4 ? WSREP_KEY_SEMI : WSREP_KEY_EXCLUSIVE;
                 break;
             case 2:
-                assert(ws_ver == 4);
+                assert(ws_ver >= 4);
                 ret = WSREP_KEY_EXCLUSIVE;
                 break;
             default:
@@ -692,7 +692,7 @@ public:
     {
         assert (version_ != KeySet::EMPTY);
         assert ((uintptr_t(reserved) % GU_WORD_BYTES) == 0);
-        assert (ws_ver <= 4);
+        assert (ws_ver <= 5);
         KeyPart zero(version_);
         prev_().push_back(zero);
     }
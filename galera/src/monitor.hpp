@@ -7,6 +7,7 @@
 
 #include "trx_handle.hpp"
 #include <gu_lock.hpp> // for gu::Mutex and gu::Cond
+#include <gu_atomic.hpp>
 #include <gu_limits.h>
 #include <gu_dbug.h>
 
@@ -42,18 +43,47 @@ namespace galera
             void operator=(const Process&);
         };
 
+        /*
+         * Slot of the lock-free monitor. Slot state and the seqno it refers
+         * to are kept in a single word, so that all state transitions are
+         * done with compare-and-swap on that word and a stale slot of
+         * a previous seqno can't be mistaken for the current one. A waiter
+         * spins for a while and then parks on the slot's own mutex and
+         * condition, so that threads in non-conflicting slots never share
+         * a lock.
+         */
+        struct Slot
+        {
+            Slot() : word_(0), parked_(0), obj_(0), mutex_(), cond_() { }
+
+            wsrep_seqno_t word_;   // (seqno << 3) | Process::State
+            int           parked_; // waiter sleeps on cond_
+            const C*      obj_;    // valid while parked_ is set
+            gu::Mutex     mutex_;
+            gu::Cond      cond_;
+
+        private:
+
+            // non-copyable
+            Slot(const Slot&);
+            void operator=(const Slot&);
+        };
+
         static const ssize_t process_size_ = (1ULL << 16);
         static const size_t  process_mask_ = process_size_ - 1;
+        static const int     spin_count_   = 256;
 
     public:
 
 #ifdef HAVE_PSI_INTERFACE
-        Monitor(wsrep_pfs_instr_tag mtag, wsrep_pfs_instr_tag ctag)
+        Monitor(wsrep_pfs_instr_tag mtag, wsrep_pfs_instr_tag ctag,
+                bool lock_free = false)
             :
             mutex_(mtag),
             cond_(ctag),
 #else
-        Monitor()
+        explicit
+        Monitor(bool lock_free = false)
             :
             mutex_(),
             cond_(),
@@ -61,17 +91,22 @@ namespace galera
             last_entered_(-1),
             last_left_(-1),
             drain_seqno_(GU_LLONG_MAX),
-            process_(new Process[process_size_]),
+            process_(lock_free ? 0 : new Process[process_size_]),
+            slots_(lock_free ? new Slot[process_size_] : 0),
+            sleepers_(0),
             entered_(0),
             oooe_(0),
             oool_(0),
             win_size_(0),
-            waits_(0)
+            waits_(0),
+            batches_(0),
+            batched_(0)
         { }
 
         ~Monitor()
         {
             delete[] process_;
+            delete[] slots_;
             if (entered_ > 0)
             {
                 log_debug << "mon: entered " << entered_
@@ -86,6 +121,8 @@ namespace galera
 
         void set_initial_position(wsrep_seqno_t seqno)
         {
+            if (slots_) { set_initial_position_lf(seqno); return; }
+
             gu::Lock lock(mutex_);
             if (last_entered_ == -1 || seqno == -1)
             {
@@ -108,6 +145,8 @@ namespace galera
 
         void enter(C& obj)
         {
+            if (slots_) { enter_lf(obj); return; }
+
             const wsrep_seqno_t obj_seqno(obj.seqno());
             const size_t        idx(indexof(obj_seqno));
             gu::Lock            lock(mutex_);
@@ -157,6 +196,8 @@ namespace galera
 
         void leave(const C& obj)
         {
+            if (slots_) { leave_lf(obj); return; }
+
 #ifndef NDEBUG
             size_t   idx(indexof(obj.seqno()));
 #endif /* NDEBUG */
@@ -172,6 +213,8 @@ namespace galera
 
         void self_cancel(C& obj)
         {
+            if (slots_) { self_cancel_lf(obj); return; }
+
             wsrep_seqno_t const obj_seqno(obj.seqno());
             size_t   idx(indexof(obj_seqno));
             gu::Lock lock(mutex_);
@@ -210,6 +253,7 @@ namespace galera
 
         void interrupt(const C& obj)
         {
+            if (slots_) { interrupt_lf(obj); return; }
 
             size_t   idx (indexof(obj.seqno()));
             gu::Lock lock(mutex_);
@@ -240,19 +284,25 @@ namespace galera
 
         wsrep_seqno_t last_left()   const
         {
+            if (slots_) return atomic_load(last_left_);
+
             gu::Lock lock(mutex_);
             return last_left_;
         }
         ssize_t       size()        const { return process_size_; }
 
+        bool          lock_free()   const { return (slots_ != 0); }
+
         bool would_block (wsrep_seqno_t seqno) const
         {
-            return (seqno - last_left_ >= process_size_ ||
-                    seqno > drain_seqno_);
+            return (seqno - atomic_load(last_left_) >= process_size_ ||
+                    seqno > atomic_load(drain_seqno_));
         }
 
         void drain(wsrep_seqno_t seqno)
         {
+            if (slots_) { drain_lf(seqno); return; }
+
             gu::Lock lock(mutex_);
 
             while (drain_seqno_ != GU_LLONG_MAX)
@@ -272,6 +322,14 @@ namespace galera
         void wait(wsrep_seqno_t seqno)
         {
             gu::Lock lock(mutex_);
+
+            if (slots_)
+            {
+                Sleeper s(sleepers_);
+                while (atomic_load(last_left_) < seqno) lock.wait(cond_);
+                return;
+            }
+
             if (last_left_ < seqno)
             {
                 size_t idx(indexof(seqno));
@@ -282,6 +340,17 @@ namespace galera
         void wait(wsrep_seqno_t seqno, const gu::datetime::Date& wait_until)
         {
             gu::Lock lock(mutex_);
+
+            if (slots_)
+            {
+                Sleeper s(sleepers_);
+                while (atomic_load(last_left_) < seqno)
+                {
+                    lock.wait(cond_, wait_until);
+                }
+                return;
+            }
+
             if (last_left_ < seqno)
             {
                 size_t idx(indexof(seqno));
@@ -290,7 +359,7 @@ namespace galera
         }
 
         void get_stats(double* oooe, double* oool, double* win_size,
-                       long long* waits) const
+                       double* batch, long long* waits) const
         {
             gu::Lock lock(mutex_);
 
@@ -304,6 +373,7 @@ namespace galera
             {
                 *oooe = .0; *oool = .0; *win_size = .0;
             }
+            *batch = (batches_ > 0 ? double(batched_)/batches_ : .0);
             *waits = waits_;
         }
 
@@ -311,6 +381,7 @@ namespace galera
         {
             gu::Lock lock(mutex_);
             oooe_ = 0; oool_ = 0; win_size_ = 0; entered_ = 0; waits_ = 0;
+            batches_ = 0; batched_ = 0;
         }
 
     private:
@@ -395,6 +466,8 @@ namespace galera
 
                 update_last_left();
                 oool_ += (last_left_ > obj_seqno);
+                ++batches_;
+                batched_ += last_left_ - obj_seqno + 1;
                 // wake up waiters that may remain above us (last_left_
                 // now is max)
                 wake_up_next();
@@ -420,6 +493,446 @@ namespace galera
             }
         }
 
+        /*
+         * Lock-free implementation.
+         *
+         * last_entered_, last_left_ and drain_seqno_ are accessed atomically.
+         * last_left_ is advanced by whoever manages to switch the slot next
+         * to it from S_FINISHED to S_IDLE, and only that thread then stores
+         * the new last_left_, so it never moves backwards. Waiters for
+         * last_left_ are woken by the thread that advanced it: slot waiters
+         * through their own slot mutex and only if their condition holds,
+         * rare slow path waiters (full process window, drain, wait()) through
+         * mutex_/cond_ and only if there are any.
+         *
+         * Lost wakeups are excluded since waiters first announce themselves
+         * (parked_, sleepers_) and then check last_left_, while wakers first
+         * store last_left_ and then check for waiters, all with full memory
+         * barriers.
+         */
+
+        template <typename T>
+        static T atomic_load(const T& val)
+        {
+            T ret;
+            gu_atomic_get(const_cast<T*>(&val), &ret);
+            return ret;
+        }
+
+        template <typename T>
+        static void atomic_store(T& val, T const set)
+        {
+            gu_atomic_set(&val, &set);
+        }
+
+        template <typename T>
+        static bool atomic_cas(T& val, T const cmp, T const set)
+        {
+            return __sync_bool_compare_and_swap(&val, cmp, set);
+        }
+
+        static void cpu_relax()
+        {
+#if defined(__i386__) || defined(__x86_64__)
+            __asm__ __volatile__ ("pause");
+#elif defined(__aarch64__)
+            __asm__ __volatile__ ("yield");
+#endif
+        }
+
+        static wsrep_seqno_t slot_word(wsrep_seqno_t const seqno,
+                                       typename Process::State const state)
+        {
+            return (seqno * 8) | state;
+        }
+
+        static typename Process::State slot_state(wsrep_seqno_t const word)
+        {
+            return static_cast<typename Process::State>(word & 7);
+        }
+
+        static wsrep_seqno_t slot_seqno(wsrep_seqno_t const word)
+        {
+            return (word - (word & 7)) / 8;
+        }
+
+        /* S_IDLE slot word which is free for seqno: slot is idle for seqno if
+         * it refers to a lower seqno, seqno itself means it has left. */
+        static wsrep_seqno_t idle_for(wsrep_seqno_t const seqno)
+        {
+            return slot_word(seqno - process_size_, Process::S_IDLE);
+        }
+
+        /* counts threads waiting on cond_ in lock-free mode */
+        class Sleeper
+        {
+        public:
+            Sleeper(long& count) : count_(count)
+            {
+                gu_atomic_fetch_and_add(&count_, 1);
+            }
+            ~Sleeper() { gu_atomic_fetch_and_sub(&count_, 1); }
+        private:
+            Sleeper(const Sleeper&);
+            void operator=(const Sleeper&);
+            long& count_;
+        };
+
+        bool may_enter_lf(const C& obj) const
+        {
+            return obj.condition(atomic_load(last_entered_),
+                                 atomic_load(last_left_));
+        }
+
+        void update_last_entered_lf(wsrep_seqno_t const seqno)
+        {
+            wsrep_seqno_t le(atomic_load(last_entered_));
+
+            while (le < seqno && !atomic_cas(last_entered_, le, seqno))
+            {
+                le = atomic_load(last_entered_);
+            }
+        }
+
+        void set_initial_position_lf(wsrep_seqno_t const seqno)
+        {
+            gu::Lock lock(mutex_);
+
+            if (last_entered_ == -1 || seqno == -1)
+            {
+                // first call or reset
+                for (ssize_t i(0); i < process_size_; ++i)
+                {
+                    atomic_store(slots_[i].word_,
+                                 slot_word(seqno, Process::S_IDLE));
+                }
+                atomic_store(last_entered_, seqno);
+                atomic_store(last_left_, seqno);
+            }
+            else
+            {
+                Sleeper s(sleepers_);
+                drain_common_lf(seqno, lock);
+                atomic_store(drain_seqno_, wsrep_seqno_t(GU_LLONG_MAX));
+            }
+
+            cond_.broadcast();
+        }
+
+        void enter_lf(C& obj)
+        {
+            const wsrep_seqno_t obj_seqno(obj.seqno());
+            Slot&               slot(slots_[indexof(obj_seqno)]);
+
+            assert(obj_seqno > atomic_load(last_left_));
+
+            pre_enter_lf(obj);
+
+            wsrep_seqno_t const waiting(slot_word(obj_seqno,
+                                                  Process::S_WAITING));
+            wsrep_seqno_t const word(atomic_load(slot.word_));
+
+            if (gu_likely(slot_state(word) == Process::S_IDLE) &&
+                atomic_cas(slot.word_, word, waiting))
+            {
+                assert(slot_seqno(word) < obj_seqno);
+
+#ifdef GU_DBUG_ON
+                {
+                    gu::Lock lock(mutex_);
+                    obj.debug_sync(mutex_);
+                }
+#endif // GU_DBUG_ON
+                if (may_enter_lf(obj) == false)
+                {
+                    obj.unlock();
+                    gu_atomic_fetch_and_add(&waits_, 1);
+                    wait_slot_lf(slot, obj, waiting);
+                    obj.lock();
+                }
+
+                if (atomic_cas(slot.word_, waiting,
+                               slot_word(obj_seqno, Process::S_APPLYING)))
+                {
+                    wsrep_seqno_t const ll(atomic_load(last_left_));
+
+                    gu_atomic_fetch_and_add(&entered_, 1);
+                    if (ll + 1 < obj_seqno) gu_atomic_fetch_and_add(&oooe_, 1);
+                    gu_atomic_fetch_and_add(&win_size_,
+                                            atomic_load(last_entered_) - ll);
+                    return;
+                }
+            }
+
+            assert(atomic_load(slot.word_) ==
+                   slot_word(obj_seqno, Process::S_CANCELED));
+            atomic_store(slot.word_, idle_for(obj_seqno));
+
+            gu_throw_error(EINTR);
+        }
+
+        void wait_slot_lf(Slot& slot, const C& obj,
+                          wsrep_seqno_t const waiting)
+        {
+            for (int i(0); i < spin_count_; ++i)
+            {
+                if (may_enter_lf(obj) ||
+                    atomic_load(slot.word_) != waiting) return;
+                cpu_relax();
+            }
+
+            gu::Lock lock(slot.mutex_);
+
+            slot.obj_ = &obj;
+            atomic_store(slot.parked_, 1);
+
+            while (may_enter_lf(obj) == false &&
+                   atomic_load(slot.word_) == waiting)
+            {
+                lock.wait(slot.cond_);
+            }
+
+            atomic_store(slot.parked_, 0);
+            slot.obj_ = 0;
+        }
+
+        void pre_enter_lf(C& obj)
+        {
+            const wsrep_seqno_t obj_seqno(obj.seqno());
+
+            if (gu_unlikely(would_block(obj_seqno))) // TODO: exit on error
+            {
+                obj.unlock();
+                {
+                    gu::Lock lock(mutex_);
+                    Sleeper  s(sleepers_);
+                    while (would_block(obj_seqno)) lock.wait(cond_);
+                }
+                obj.lock();
+            }
+
+            update_last_entered_lf(obj_seqno);
+        }
+
+        void leave_lf(const C& obj)
+        {
+            const wsrep_seqno_t obj_seqno(obj.seqno());
+
+            assert(atomic_load(slots_[indexof(obj_seqno)].word_) ==
+                   slot_word(obj_seqno, Process::S_APPLYING) ||
+                   atomic_load(slots_[indexof(obj_seqno)].word_) ==
+                   slot_word(obj_seqno, Process::S_CANCELED));
+
+            atomic_store(slots_[indexof(obj_seqno)].word_,
+                         slot_word(obj_seqno, Process::S_FINISHED));
+
+            if (update_last_left_lf() > obj_seqno)
+            {
+                gu_atomic_fetch_and_add(&oool_, 1);
+            }
+        }
+
+        void self_cancel_lf(C& obj)
+        {
+            wsrep_seqno_t const obj_seqno(obj.seqno());
+            Slot&               slot(slots_[indexof(obj_seqno)]);
+
+            assert(obj_seqno > atomic_load(last_left_));
+
+            if (obj_seqno - atomic_load(last_left_) >= process_size_
+                || GU_DBUG_EVALUATE_IF ("simulate_low_process_size", 1, 0))
+            {
+                obj.unlock();
+                {
+                    gu::Lock lock(mutex_);
+                    Sleeper  s(sleepers_);
+
+                    while (obj_seqno - atomic_load(last_left_) >= process_size_
+                       || GU_DBUG_EVALUATE_IF("simulate_low_process_size",1,0))
+                        // TODO: exit on error
+                    {
+                        log_warn << "Trying to self-cancel seqno out of "
+                                 << "process space: obj_seqno - last_left_ = "
+                                 << obj_seqno << " - " << last_left_ << " = "
+                                 << (obj_seqno - last_left_)
+                                 << ", process_size_: "  << process_size_
+                                 << ". Deadlock is very likely.";
+                        lock.wait(cond_);
+                    }
+                }
+                obj.lock();
+            }
+
+            assert(slot_state(atomic_load(slot.word_)) == Process::S_IDLE ||
+                   slot_state(atomic_load(slot.word_)) == Process::S_CANCELED);
+
+            update_last_entered_lf(obj_seqno);
+
+            atomic_store(slot.word_, slot_word(obj_seqno, Process::S_FINISHED));
+
+            // above drain_seqno_ the slot is left finished until drain ends,
+            // drain_lf() then advances last_left_ over it
+            if (obj_seqno <= atomic_load(drain_seqno_) &&
+                update_last_left_lf() > obj_seqno)
+            {
+                gu_atomic_fetch_and_add(&oool_, 1);
+            }
+        }
+
+        void interrupt_lf(const C& obj)
+        {
+            wsrep_seqno_t const obj_seqno(obj.seqno());
+            Slot&               slot(slots_[indexof(obj_seqno)]);
+
+            if (obj_seqno - atomic_load(last_left_) >= process_size_)
+            {
+                gu::Lock lock(mutex_);
+                Sleeper  s(sleepers_);
+
+                while (obj_seqno - atomic_load(last_left_) >= process_size_)
+                    // TODO: exit on error
+                {
+                    lock.wait(cond_);
+                }
+            }
+
+            wsrep_seqno_t const waiting(slot_word(obj_seqno,
+                                                  Process::S_WAITING));
+            wsrep_seqno_t const canceled(slot_word(obj_seqno,
+                                                   Process::S_CANCELED));
+            for (;;)
+            {
+                wsrep_seqno_t const word(atomic_load(slot.word_));
+
+                if (slot_state(word) == Process::S_IDLE &&
+                    slot_seqno(word) <  obj_seqno       &&
+                    obj_seqno        >  atomic_load(last_left_))
+                {
+                    if (atomic_cas(slot.word_, word, canceled)) break;
+                }
+                else if (word == waiting)
+                {
+                    if (atomic_cas(slot.word_, word, canceled))
+                    {
+                        gu::Lock lock(slot.mutex_);
+                        slot.cond_.signal();
+                        break;
+                    }
+                }
+                else
+                {
+                    log_debug << "interrupting " << obj_seqno
+                              << " state " << slot_state(word)
+                              << " le " << atomic_load(last_entered_)
+                              << " ll " << atomic_load(last_left_);
+                    break;
+                }
+            }
+        }
+
+        void drain_lf(wsrep_seqno_t const seqno)
+        {
+            {
+                gu::Lock lock(mutex_);
+                Sleeper  s(sleepers_);
+
+                while (atomic_load(drain_seqno_) != GU_LLONG_MAX)
+                {
+                    lock.wait(cond_);
+                }
+
+                drain_common_lf(seqno, lock);
+
+                atomic_store(drain_seqno_, wsrep_seqno_t(GU_LLONG_MAX));
+                cond_.broadcast();
+            }
+
+            // there can be some stale canceled entries
+            update_last_left_lf();
+        }
+
+        /* must be called with sleepers_ incremented */
+        void drain_common_lf(wsrep_seqno_t const seqno, gu::Lock& lock)
+        {
+            log_debug << "draining up to " << seqno;
+
+            atomic_store(drain_seqno_, seqno);
+
+            wsrep_seqno_t const ll(atomic_load(last_left_));
+            if (ll > seqno)
+            {
+                log_debug << "last left greater than drain seqno";
+                for (wsrep_seqno_t i = seqno; i <= ll; ++i)
+                {
+                    log_debug << "applier " << i << " in state "
+                              << slot_state(atomic_load(
+                                                slots_[indexof(i)].word_));
+                }
+            }
+
+            while (atomic_load(last_left_) < seqno) lock.wait(cond_);
+        }
+
+        /* Advances last_left_ over finished slots and wakes up waiters.
+         * Returns the highest seqno this thread advanced last_left_ to or
+         * WSREP_SEQNO_UNDEFINED if it did not. */
+        wsrep_seqno_t update_last_left_lf()
+        {
+            wsrep_seqno_t const start(atomic_load(last_left_));
+            wsrep_seqno_t       ll(start);
+
+            for (;;)
+            {
+                wsrep_seqno_t const next(ll + 1);
+
+                if (!atomic_cas(slots_[indexof(next)].word_,
+                                slot_word(next, Process::S_FINISHED),
+                                slot_word(next, Process::S_IDLE))) break;
+
+                atomic_store(last_left_, next);
+                ll = next;
+            }
+
+            if (ll == start) return WSREP_SEQNO_UNDEFINED;
+
+            gu_atomic_fetch_and_add(&batches_, 1);
+            gu_atomic_fetch_and_add(&batched_, ll - start);
+
+            wake_up_next_lf(ll);
+
+            if (atomic_load(sleepers_) > 0)
+            {
+                gu::Lock lock(mutex_);
+                cond_.broadcast();
+            }
+
+            return ll;
+        }
+
+        void wake_up_next_lf(wsrep_seqno_t const ll)
+        {
+            wsrep_seqno_t const le(atomic_load(last_entered_));
+
+            for (wsrep_seqno_t i = ll + 1; i <= le; ++i)
+            {
+                Slot& a(slots_[indexof(i)]);
+                wsrep_seqno_t const waiting(slot_word(i, Process::S_WAITING));
+
+                if (atomic_load(a.parked_) && atomic_load(a.word_) == waiting)
+                {
+                    gu::Lock lock(a.mutex_);
+
+                    // obj_ can be dereferenced only while the waiter is
+                    // parked, that is it sleeps on a.cond_
+                    if (a.parked_ && atomic_load(a.word_) == waiting &&
+                        may_enter_lf(*a.obj_))
+                    {
+                        a.cond_.signal();
+                    }
+                }
+            }
+        }
+
         void drain_common(wsrep_seqno_t seqno, gu::Lock& lock)
         {
             log_debug << "draining up to " << seqno;
@@ -453,7 +966,9 @@ namespace galera
         wsrep_seqno_t last_entered_;
         wsrep_seqno_t last_left_;
         wsrep_seqno_t drain_seqno_;
-        Process*      process_;
+        Process*      process_;  // mutex based implementation
+        Slot*         slots_;    // lock-free implementation
+        long          sleepers_; // lock-free waiters on cond_
         long entered_;  // entered
         long oooe_;     // out of order entered
         long oool_;     // out of order left
@@ -461,6 +976,8 @@ namespace galera
         // Total number of waits in the monitor. Incremented before
         // entering into waiting state.
         long long waits_;
+        long batches_;  // number of times the window shrinked
+        long batched_;  // seqnos released by those
     };
 }
 
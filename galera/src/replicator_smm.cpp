@@ -174,22 +174,25 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     slave_pool_         (sizeof(TrxHandle), 1024, "SlaveTrxHandle"),
     as_                 (0),
     gcs_as_             (slave_pool_, gcs_, *this, gcache_),
-    ist_receiver_       (config_, slave_pool_, args->node_address),
+    ist_receiver_       (config_, gcache_, slave_pool_, args->node_address),
     ist_prepared_       (false),
     ist_senders_        (gcs_, gcache_),
     wsdb_               (),
     cert_               (config_, service_thd_, gcache_),
 #ifdef HAVE_PSI_INTERFACE
     local_monitor_      (WSREP_PFS_INSTR_TAG_LOCAL_MONITOR_MUTEX,
-                         WSREP_PFS_INSTR_TAG_LOCAL_MONITOR_CONDVAR),
+                         WSREP_PFS_INSTR_TAG_LOCAL_MONITOR_CONDVAR,
+                         monitor_lock_free(config_)),
     apply_monitor_      (WSREP_PFS_INSTR_TAG_APPLY_MONITOR_MUTEX,
-                         WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR),
+                         WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR,
+                         monitor_lock_free(config_)),
     commit_monitor_     (WSREP_PFS_INSTR_TAG_COMMIT_MONITOR_MUTEX,
-                         WSREP_PFS_INSTR_TAG_COMMIT_MONITOR_CONDVAR),
+                         WSREP_PFS_INSTR_TAG_COMMIT_MONITOR_CONDVAR,
+                         monitor_lock_free(config_)),
 #else
-    local_monitor_      (),
-    apply_monitor_      (),
-    commit_monitor_     (),
+    local_monitor_      (monitor_lock_free(config_)),
+    apply_monitor_      (monitor_lock_free(config_)),
+    commit_monitor_     (monitor_lock_free(config_)),
 #endif /* HAVE_PSI_INTERFACE */
     causal_read_timeout_(config_.get(Param::causal_read_timeout)),
     receivers_          (),
@@ -211,7 +214,9 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
 #else
     incoming_mutex_     (),
 #endif /* HAVE_PSI_INTERFACE */
-    wsrep_stats_        ()
+    wsrep_stats_        (),
+    purge_latency_string_(),
+    checksum_latency_string_()
 {
     /*
       Register the application callback that should be called
@@ -257,6 +262,8 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     state_.add_transition(Transition(S_DONOR, S_JOINED));
 
     local_monitor_.set_initial_position(0);
+    ChecksumPool::instance().set_threads(
+        gu::from_string<size_t>(config_.get(Param::checksum_threads)));
 
     wsrep_uuid_t  uuid;
     wsrep_seqno_t seqno;
@@ -1519,6 +1526,12 @@ void galera::ReplicatorSMM::establish_protocol_versions (int proto_ver)
         trx_params_.record_set_ver_ = gu::RecordSet::VER2;
         str_proto_ver_ = 2;
         break;
+    case 10:
+        // Protocol upgrade to enable parallel checksumming of data sets.
+        trx_params_.version_ = 5;
+        trx_params_.record_set_ver_ = gu::RecordSet::VER2;
+        str_proto_ver_ = 2;
+        break;
     default:
         log_fatal << "Configuration change resulted in an unsupported protocol "
             "version: " << proto_ver << ". Can't continue.";
@@ -1956,6 +1969,9 @@ wsrep_status_t galera::ReplicatorSMM::cert(TrxHandle* trx)
 
     trx->set_state(TrxHandle::S_CERTIFYING);
 
+    // key parsing does not need to be serialized, do it before local monitor
+    cert_.prepare(trx);
+
     LocalOrder  lo(*trx);
     ApplyOrder  ao(*trx);
     CommitOrder co(*trx, co_mode_);
@@ -206,8 +206,12 @@ namespace galera
             static const std::string commit_order;
             static const std::string causal_read_timeout;
             static const std::string max_write_set_size;
+            static const std::string monitor_impl;
+            static const std::string checksum_threads;
         };
 
+        static bool monitor_lock_free(const gu::Config& conf);
+
         typedef std::pair<std::string, std::string> Default;
 
         struct Defaults
@@ -681,6 +685,8 @@ namespace galera
         // Storage space for dynamic status strings
         char                  interval_string_[64];
         char                  ist_status_string_[128];
+        char                  purge_latency_string_[256];
+        char                  checksum_latency_string_[256];
     };
 
     std::ostream& operator<<(std::ostream& os, ReplicatorSMM::State state);
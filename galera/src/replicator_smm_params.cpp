@@ -24,8 +24,12 @@ const std::string galera::ReplicatorSMM::Param::key_format =
     common_prefix + "key_format";
 const std::string galera::ReplicatorSMM::Param::max_write_set_size =
     common_prefix + "max_ws_size";
+const std::string galera::ReplicatorSMM::Param::monitor_impl =
+    common_prefix + "monitor_impl";
+const std::string galera::ReplicatorSMM::Param::checksum_threads =
+    common_prefix + "checksum_threads";
 
-int const galera::ReplicatorSMM::MAX_PROTO_VER(9);
+int const galera::ReplicatorSMM::MAX_PROTO_VER(10);
 
 galera::ReplicatorSMM::Defaults::Defaults() : map_()
 {
@@ -38,6 +42,22 @@ galera::ReplicatorSMM::Defaults::Defaults() : map_()
     const int max_write_set_size(galera::WriteSetNG::MAX_SIZE);
     map_.insert(Default(Param::max_write_set_size,
                         gu::to_string(max_write_set_size)));
+    map_.insert(Default(Param::monitor_impl, "mutex"));
+    map_.insert(Default(Param::checksum_threads,
+                        gu::to_string(size_t(ChecksumPool::DEFAULT_THREADS))));
+}
+
+bool
+galera::ReplicatorSMM::monitor_lock_free(const gu::Config& conf)
+{
+    const std::string& impl(conf.get(Param::monitor_impl));
+
+    if (impl == "mutex")    return false;
+    if (impl == "lockfree") return true;
+
+    gu_throw_error(EINVAL) << "Invalid value '" << impl << "' for "
+                           << Param::monitor_impl
+                           << ", expected 'mutex' or 'lockfree'";
 }
 
 const galera::ReplicatorSMM::Defaults galera::ReplicatorSMM::defaults;
@@ -161,7 +181,7 @@ void
 galera::ReplicatorSMM::set_param (const std::string& key,
                                   const std::string& value)
 {
-    if (key == Param::commit_order)
+    if (key == Param::commit_order || key == Param::monitor_impl)
     {
         log_error << "setting '" << key << "' during runtime not allowed";
         gu_throw_error(EPERM)
@@ -171,6 +191,10 @@ galera::ReplicatorSMM::set_param (const std::string& key,
     {
         causal_read_timeout_ = gu::datetime::Period(value);
     }
+    else if (key == Param::checksum_threads)
+    {
+        ChecksumPool::instance().set_threads(gu::from_string<size_t>(value));
+    }
     else if (key == Param::base_host ||
              key == Param::base_port ||
              key == Param::base_dir ||
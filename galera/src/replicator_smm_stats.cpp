@@ -117,6 +117,7 @@ typedef enum status_vars
     STATS_COMMIT_OOOE,
     STATS_COMMIT_OOOL,
     STATS_COMMIT_WINDOW,
+    STATS_COMMIT_BATCH,
     STATS_LOCAL_STATE,
     STATS_LOCAL_STATE_COMMENT,
     STATS_CERT_INDEX_SIZE,
@@ -124,6 +125,9 @@ typedef enum status_vars
     STATS_GCACHE_POOL_SIZE,
     STATS_CAUSAL_READS,
     STATS_CERT_INTERVAL,
+    STATS_CERT_PURGE_LATENCY,
+    STATS_CHECKSUM_QUEUE,
+    STATS_CHECKSUM_LATENCY,
     STATS_OPEN_TRX,
     STATS_OPEN_CONN,
     STATS_IST_RECEIVE_STATUS,
@@ -179,6 +183,7 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "commit_oooe",              WSREP_VAR_DOUBLE, { 0 }  },
     { "commit_oool",              WSREP_VAR_DOUBLE, { 0 }  },
     { "commit_window",            WSREP_VAR_DOUBLE, { 0 }  },
+    { "commit_batch",             WSREP_VAR_DOUBLE, { 0 }  },
     { "local_state",              WSREP_VAR_INT64,  { 0 }  },
     { "local_state_comment",      WSREP_VAR_STRING, { 0 }  },
     { "cert_index_size",          WSREP_VAR_INT64,  { 0 }  },
@@ -186,6 +191,9 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "gcache_pool_size",         WSREP_VAR_INT64,  { 0 }  },
     { "causal_reads",             WSREP_VAR_INT64,  { 0 }  },
     { "cert_interval",            WSREP_VAR_DOUBLE, { 0 }  },
+    { "cert_purge_latency",       WSREP_VAR_STRING, { 0 }  },
+    { "checksum_queue",           WSREP_VAR_INT64,  { 0 }  },
+    { "checksum_latency",         WSREP_VAR_STRING, { 0 }  },
     { "open_transactions",        WSREP_VAR_INT64,  { 0 }  },
     { "open_connections",         WSREP_VAR_INT64,  { 0 }  },
     { "ist_receive_status",       WSREP_VAR_STRING, { 0 }  },
@@ -276,23 +284,35 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_CERT_INDEX_SIZE     ].value._int64 = index_size;
     sv[STATS_CERT_BUCKET_COUNT   ].value._int64 = cert_.bucket_count();
 
+    strncpy(purge_latency_string_, cert_.purge_latency().c_str(),
+            sizeof(purge_latency_string_) - 1);
+    sv[STATS_CERT_PURGE_LATENCY  ].value._string = purge_latency_string_;
+
+    ChecksumPool& checksum_pool(ChecksumPool::instance());
+    sv[STATS_CHECKSUM_QUEUE      ].value._int64 = checksum_pool.queue_len();
+    strncpy(checksum_latency_string_, checksum_pool.latency().c_str(),
+            sizeof(checksum_latency_string_) - 1);
+    sv[STATS_CHECKSUM_LATENCY    ].value._string = checksum_latency_string_;
+
     sv[STATS_GCACHE_POOL_SIZE    ].value._int64 = gcache_.allocated_pool_size();
 
     double oooe;
     double oool;
     double win;
+    double batch;
     long long waits;
-    apply_monitor_.get_stats(&oooe, &oool, &win, &waits);
+    apply_monitor_.get_stats(&oooe, &oool, &win, &batch, &waits);
 
     sv[STATS_APPLY_OOOE          ].value._double = oooe;
     sv[STATS_APPLY_OOOL          ].value._double = oool;
     sv[STATS_APPLY_WINDOW        ].value._double = win;
     sv[STATS_APPLY_WAITS         ].value._int64 = waits;
-    commit_monitor_.get_stats(&oooe, &oool, &win, &waits);
+    commit_monitor_.get_stats(&oooe, &oool, &win, &batch, &waits);
 
     sv[STATS_COMMIT_OOOE         ].value._double = oooe;
     sv[STATS_COMMIT_OOOL         ].value._double = oool;
     sv[STATS_COMMIT_WINDOW       ].value._double = win;
+    sv[STATS_COMMIT_BATCH        ].value._double = batch;
 
     sv[STATS_LOCAL_STATE         ].value._int64  = state2stats(state_());
     sv[STATS_LOCAL_STATE_COMMENT ].value._string = state2stats_str(state_(),
@@ -427,6 +447,8 @@ galera::ReplicatorSMM::stats_reset()
     commit_monitor_.flush_stats();
 
     cert_.stats_reset();
+
+    ChecksumPool::instance().stats_reset();
 }
 
 void
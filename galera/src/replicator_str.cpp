@@ -1013,6 +1013,14 @@ void ReplicatorSMM::recv_IST(void* recv_ctx)
                 // Verify checksum before applying. This is also required
                 // to synchronize with possible background checksum thread.
                 trx->verify_checksum();
+                if (trx->action())
+                {
+                    // received into gcache (ist.recv_gcache): make it part
+                    // of gcache history, so that it can be donated
+                    gcache_.seqno_assign(trx->action(),
+                                         trx->global_seqno(),
+                                         trx->depends_seqno());
+                }
                 if (trx->depends_seqno() == -1)
                 {
                     ApplyOrder ao(*trx);
@@ -1040,6 +1048,13 @@ void ReplicatorSMM::recv_IST(void* recv_ctx)
                     }
                     GU_DBUG_SYNC_WAIT("recv_IST_after_apply_trx");
                 }
+                if (trx->action())
+                {
+                    // ordered buffers must be freed in seqno order and
+                    // appliers finish out of order: free everything up to
+                    // the last write set applied in order
+                    gcache_.seqno_release(apply_monitor_.last_left());
+                }
             }
             else
             {
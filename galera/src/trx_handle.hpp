@@ -24,6 +24,7 @@
 #include "gu_limits.h" // page size stuff
 
 #include <set>
+#include <vector>
 
 namespace galera
 {
@@ -308,11 +309,12 @@ namespace galera
             }
         }
 
-        /* obtain global and depends seqno from the writeset (IST) */
-        void set_received_from_ws()
+        /* obtain global and depends seqno from the writeset (IST),
+         * action is the gcache buffer holding it, if any */
+        void set_received_from_ws(const void* action = 0)
         {
             wsrep_seqno_t const seqno_g(write_set_in_.seqno());
-            set_received(0, -1, seqno_g);
+            set_received(action, -1, seqno_g);
             wsrep_seqno_t const seqno_d
                 (std::max<wsrep_seqno_t>
                     (global_seqno_ - write_set_in_.pa_range(),
@@ -628,6 +630,12 @@ namespace galera
 
         CertKeySet& cert_keys() { return cert_keys_; }
 
+        /* key parts of the new version writeset, parsed in advance so that
+         * certification does not need to walk the key set under its lock */
+        typedef std::vector<KeySet::KeyPart> CertKeysNG;
+
+        CertKeysNG& cert_keys_ng() { return cert_keys_ng_; }
+
         size_t serial_size() const;
         size_t serialize  (gu::byte_t* buf, size_t buflen, size_t offset) const;
         size_t unserialize(const gu::byte_t* buf, size_t buflen, size_t offset);
@@ -669,6 +677,7 @@ namespace galera
             write_set_in_      (),
             annotation_        (),
             cert_keys_         (),
+            cert_keys_ng_      (),
             write_set_buffer_  (0, 0),
             mem_pool_          (mp),
             action_            (0),
@@ -713,6 +722,7 @@ namespace galera
             write_set_in_      (),
             annotation_        (),
             cert_keys_         (),
+            cert_keys_ng_      (),
             write_set_buffer_  (0, 0),
             mem_pool_          (mp),
             action_            (0),
@@ -784,6 +794,7 @@ namespace galera
         WriteSetIn             write_set_in_;
         gu::Buffer             annotation_;
         CertKeySet             cert_keys_;
+        CertKeysNG             cert_keys_ng_;
 
         // Write set buffer location if stored outside TrxHandle.
         std::pair<const gu::byte_t*, size_t> write_set_buffer_;
@@ -211,19 +211,13 @@ WriteSetIn::init (ssize_t const st)
     {
         if (size_ >= st)
         {
-            /* buffer too big, start checksumming in background */
-            int const err(gu_thread_create (&check_thr_id_, NULL,
-                                            checksum_thread, this));
-
-            if (gu_likely(0 == err))
+            /* buffer too big, checksum it in background */
+            if (gu_likely(ChecksumPool::instance().submit(*this)))
             {
                 check_thr_ = true;
                 return;
             }
 
-            log_warn << "Starting checksum thread failed: " << err
-                     << '(' << ::strerror(err) << ')';
-
             /* fall through to checksum in foreground */
         }
 
@@ -262,7 +256,7 @@ WriteSetIn::checksum()
         {
             assert (psize > 0);
             gu_trace(data_.init(dver, pptr, psize));
-            gu_trace(data_.checksum());
+            gu_trace(ChecksumPool::instance().checksum(data_));
             size_t const tmpsize(data_.serial_size());
             psize -= tmpsize;
             pptr  += tmpsize;
@@ -271,7 +265,7 @@ WriteSetIn::checksum()
             if (header_.has_unrd())
             {
                 gu_trace(unrd_.init(dver, pptr, psize));
-                gu_trace(unrd_.checksum());
+                gu_trace(ChecksumPool::instance().checksum(unrd_));
                 size_t const tmpsize(unrd_.serial_size());
                 psize -= tmpsize;
                 pptr  += tmpsize;
@@ -17,6 +17,7 @@
 #include "wsrep_api.h"
 #include "key_set.hpp"
 #include "data_set.hpp"
+#include "checksum_pool.hpp"
 
 #include "gu_serialize.hpp"
 #include "gu_vector.hpp"
@@ -24,6 +25,7 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <algorithm>
 
 #include <gu_threads.h>
 
@@ -38,11 +40,12 @@ namespace galera
         enum Version
         {
             VER3 = 3,
-            VER4
+            VER4,
+            VER5  /* data sets may be checksummed in parallel */
         };
 
         /* Max header version that we can understand */
-        static Version const MAX_VERSION = VER4;
+        static Version const MAX_VERSION = VER5;
 
         /* Parses beginning of the header to detect writeset version and
          * returns it as raw integer for backward compatibility
@@ -89,11 +92,18 @@ namespace galera
             {
             case VER3: return VER3;
             case VER4: return VER4;
+            case VER5: return VER5;
             }
 
             gu_throw_error (EPROTO) << "Unrecognized writeset version: " << v;
         }
 
+        /* Max DataSet version that can be used with writeset version */
+        static DataSet::Version max_dataset_version(Version const ver)
+        {
+            return (ver >= VER5 ? DataSet::VER2 : DataSet::VER1);
+        }
+
         /* These flags should be fixed to wire protocol version and so
          * technically can't be initialized to WSREP_FLAG_xxx macros as the
          * latter may arbitrarily change. */
@@ -134,6 +144,7 @@ namespace galera
                 {
                 case VER3:
                 case VER4:
+                case VER5:
                 {
                     GU_COMPILE_ASSERT(0 == (V3_SIZE % GU_MIN_ALIGNMENT),
                                       unaligned_header_size);
@@ -503,10 +514,12 @@ namespace galera
                     kbn_, kver, rsv, ver),
             /* 5/8 of reserved goes to data set  */
             dbn_   (base_name_),
-            data_  (reserved + reserved_size, reserved_size*5, dbn_, dver, rsv),
+            data_  (reserved + reserved_size, reserved_size*5, dbn_,
+                    std::min(dver, WriteSetNG::max_dataset_version(ver)), rsv),
             /* 2/8 of reserved goes to unordered set  */
             ubn_   (base_name_),
-            unrd_  (reserved + reserved_size*6, reserved_size*2, ubn_, uver,rsv),
+            unrd_  (reserved + reserved_size*6, reserved_size*2, ubn_,
+                    std::min(uver, WriteSetNG::max_dataset_version(ver)), rsv),
             /* annotation set is not allocated unless requested */
             abn_   (base_name_),
             annt_  (NULL),
@@ -538,7 +551,9 @@ namespace galera
         {
             if (NULL == annt_)
             {
-                annt_ = new DataSetOut(NULL, 0, abn_, DataSet::MAX_VERSION,
+                annt_ = new DataSetOut(NULL, 0, abn_,
+                                       WriteSetNG::max_dataset_version(
+                                           header_.version()),
                                        // use the same version as the dataset
                                        data_.gu::RecordSet::version());
                 left_ -= annt_->size();
@@ -681,8 +696,8 @@ namespace galera
               data_  (),
               unrd_  (),
               annt_  (NULL),
-              check_thr_id_(),
               check_thr_(false),
+              check_done_(false),
               check_ (false)
         {
             gu_trace(init(st));
@@ -695,8 +710,8 @@ namespace galera
               data_  (),
               unrd_  (),
               annt_  (NULL),
-              check_thr_id_(),
               check_thr_(false),
+              check_done_(false),
               check_ (false)
         {}
 
@@ -723,8 +738,8 @@ namespace galera
         {
             if (gu_unlikely(check_thr_))
             {
-                /* checksum was performed in a parallel thread */
-                gu_thread_join (check_thr_id_, NULL);
+                /* checksum is being performed in a checksum pool thread */
+                ChecksumPool::instance().wait(*this);
             }
 
             delete annt_;
@@ -759,8 +774,8 @@ namespace galera
         {
             if (gu_unlikely(check_thr_))
             {
-                /* checksum was performed in a parallel thread */
-                gu_thread_join (check_thr_id_, NULL);
+                /* checksum was performed in a checksum pool thread */
+                ChecksumPool::instance().wait(*this);
                 check_thr_ = false;
                 gu_trace(checksum_fin());
             }
@@ -800,8 +815,8 @@ namespace galera
         DataSetIn          data_;
         DataSetIn          unrd_;
         DataSetIn*         annt_;
-        gu_thread_t        check_thr_id_;
         bool mutable       check_thr_;
+        bool               check_done_; /* protected by ChecksumPool */
         bool               check_;
 
         static size_t const SIZE_THRESHOLD = 1 << 22; /* 4Mb */
@@ -816,30 +831,11 @@ namespace galera
             }
         }
 
-        static void* checksum_thread (void* arg)
-        {
-#ifdef HAVE_PSI_INTERFACE
-            pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
-                               WSREP_PFS_INSTR_OPS_INIT,
-                               WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
-                               NULL, NULL, NULL);
-#endif /* HAVE_PSI_INTERFACE */
-
-            WriteSetIn* ws(reinterpret_cast<WriteSetIn*>(arg));
-            ws->checksum();
-
-#ifdef HAVE_PSI_INTERFACE
-            pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
-                               WSREP_PFS_INSTR_OPS_DESTROY,
-                               WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
-                               NULL, NULL, NULL);
-#endif /* HAVE_PSI_INTERFACE */
-            return NULL;
-        }
-
         /* late initialization after default constructor */
         void init (ssize_t size_threshold);
 
+        friend class ChecksumPool;
+
         WriteSetIn (const WriteSetIn&);
         WriteSetIn& operator=(WriteSetIn);
     };
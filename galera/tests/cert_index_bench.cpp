@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/**
+ * This is to benchmark certification index operations on v3+ keys, comparing
+ * chained hash set implementation (cert.index_impl = hash) with open
+ * addressing table (cert.index_impl = flat).
+ *
+ * The index is kept at a constant size while certifying a stream of
+ * transactions: for each trx its keys are looked up and inserted and the keys
+ * of the oldest trx are erased, like index purge does.
+ *
+ * Usage: cert_index_bench [index size] [keys per trx] [trxs]
+ */
+
+#define NDEBUG 1
+
+#include "test_key.hpp"
+#include "../src/certification.hpp"
+
+#include <sys/time.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+
+class BenchBaseName : public gu::Allocator::BaseName
+{
+public:
+    void print(std::ostream& os) const { os << "cert_index_bench"; }
+};
+
+/* Serialized key sets, one per trx, and the key parts pointing into them */
+class Keys
+{
+public:
+
+    Keys(size_t const trxs, size_t const keys_per_trx)
+        : bufs_(trxs), parts_()
+    {
+        static KeySet::Version const ver(KeySet::FLAT8A);
+        static int const             ws_ver(3);
+        BenchBaseName const          base_name;
+
+        parts_.reserve(trxs * keys_per_trx);
+
+        for (size_t t(0); t < trxs; ++t)
+        {
+            union { gu::byte_t buf[1024]; gu_word_t align; } reserved;
+            KeySetOut kso(reserved.buf, sizeof(reserved.buf), base_name, ver,
+                          gu::RecordSet::VER2, ws_ver);
+
+            for (size_t k(0); k < keys_per_trx; ++k)
+            {
+                std::ostringstream os;
+                os << t << ':' << k;
+                std::string const part(os.str());
+                TestKey tk(ws_ver, WSREP_KEY_EXCLUSIVE, true, "db", "tbl",
+                           part.c_str());
+                kso.append(tk());
+            }
+
+            KeySetOut::GatherVector out;
+            out->reserve(kso.page_count());
+            kso.gather(out);
+
+            std::vector<gu::byte_t>& buf(bufs_[t]);
+            for (size_t i(0); i < out->size(); ++i)
+            {
+                const gu::byte_t* ptr
+                    (reinterpret_cast<const gu::byte_t*>(out[i].ptr));
+                buf.insert(buf.end(), ptr, ptr + out[i].size);
+            }
+
+            KeySetIn ksi(kso.version(), &buf[0], buf.size());
+            /* key set contains also the branch keys: take only leaves */
+            for (long i(0); i < ksi.count(); ++i)
+            {
+                const KeySet::KeyPart& kp(ksi.next());
+                if (kp.wsrep_type(ws_ver) == WSREP_KEY_EXCLUSIVE)
+                {
+                    parts_.push_back(kp);
+                }
+            }
+        }
+    }
+
+    size_t size() const { return parts_.size(); }
+    const KeySet::KeyPart& operator[](size_t i) const { return parts_[i]; }
+
+private:
+
+    std::vector<std::vector<gu::byte_t> > bufs_;
+    std::vector<KeySet::KeyPart>          parts_;
+};
+
+static void
+run(const Keys& keys, size_t const index_size, size_t const keys_per_trx,
+    bool const flat)
+{
+    std::vector<KeyEntryNG*> entries;
+    entries.reserve(keys.size());
+    for (size_t i(0); i < keys.size(); ++i)
+    {
+        entries.push_back(new KeyEntryNG(keys[i]));
+    }
+
+    Certification::CertIndexShard index;
+    index.set_flat(flat);
+
+    struct timeval tv_begin, tv_end;
+
+    /* populate */
+    gettimeofday(&tv_begin, NULL);
+    for (size_t i(0); i < index_size; ++i)
+    {
+        index.insert(entries[i]);
+    }
+    gettimeofday(&tv_end, NULL);
+    double const t_insert(time_diff(tv_end, tv_begin));
+
+    /* lookups of present keys */
+    size_t found(0);
+    gettimeofday(&tv_begin, NULL);
+    for (size_t i(0); i < index_size; ++i)
+    {
+        KeyEntryNG ke(keys[(i * 7919) % index_size]);
+        found += (index.find(ke) != NULL);
+    }
+    gettimeofday(&tv_end, NULL);
+    double const t_hit(time_diff(tv_end, tv_begin));
+
+    /* certification stream: miss + insert new, erase oldest */
+    size_t const ops(keys.size() - index_size);
+    gettimeofday(&tv_begin, NULL);
+    for (size_t i(index_size); i < keys.size(); i += keys_per_trx)
+    {
+        size_t const end(std::min(i + keys_per_trx, keys.size()));
+
+        for (size_t k(i); k < end; ++k)
+        {
+            KeyEntryNG ke(keys[k]);
+            if (index.find(ke) == NULL) index.insert(entries[k]);
+        }
+
+        for (size_t k(i - index_size); k < end - index_size; ++k)
+        {
+            index.erase(entries[k]);
+        }
+    }
+    gettimeofday(&tv_end, NULL);
+    double const t_stream(time_diff(tv_end, tv_begin));
+
+    std::cout << (flat ? "flat" : "hash")
+              << ": insert " << t_insert * 1.0e9 / index_size << " ns/key"
+              << ", hit " << t_hit * 1.0e9 / index_size << " ns/key"
+              << ", stream " << (ops ? t_stream * 1.0e9 / ops : 0) << " ns/key"
+              << ", found " << found << '/' << index_size
+              << ", buckets " << index.bucket_count() << std::endl;
+
+    for (size_t i(keys.size() - index_size); i < keys.size(); ++i)
+    {
+        index.erase(entries[i]);
+    }
+
+    for (size_t i(0); i < entries.size(); ++i) delete entries[i];
+}
+
+template <typename T>
+static void read_arg(char* argv[], int const i, T& val)
+{
+    std::istringstream is(argv[i]);
+    is >> val;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t index_size(1 << 18);
+    size_t keys_per_trx(64);
+    size_t trxs(1 << 12);
+
+    if (argc >= 2) read_arg(argv, 1, index_size);
+    if (argc >= 3) read_arg(argv, 2, keys_per_trx);
+    if (argc >= 4) read_arg(argv, 3, trxs);
+
+    if (0 == keys_per_trx)
+    {
+        std::cerr << "Keys per trx must be positive" << std::endl;
+        return 1;
+    }
+
+    size_t const total_trxs((index_size + keys_per_trx - 1) / keys_per_trx
+                            + trxs);
+
+    std::cout << "Running with parameters: index size = " << index_size
+              << ", keys per trx = " << keys_per_trx
+              << ", trxs = " << trxs << std::endl;
+
+    Keys const keys(total_trxs, keys_per_trx);
+
+    if (keys.size() < index_size)
+    {
+        std::cerr << "Generated " << keys.size() << " keys, less than index "
+                  << "size" << std::endl;
+        return 1;
+    }
+
+    run(keys, index_size, keys_per_trx, false);
+    run(keys, index_size, keys_per_trx, true);
+
+    return 0;
+}
@@ -30,6 +30,12 @@ static const char* Defaults[] =
     "base_port",                   "4567",
     "cert.log_conflicts",          "no",
     "cert.optimistic_pa",          "yes",
+    "cert.pipeline",               "no",
+    "cert.index_impl",             "hash",
+    "cert.purge_keys_threshold",   "1024",
+    "cert.purge_bytes_threshold",  "128M",
+    "cert.purge_trxs_threshold",   "127",
+    "cert.purge_step_keys",        "0",
     "debug",                       "no",
 #ifdef GU_DBUG_ON
     "dbug",                        "",
@@ -66,10 +72,12 @@ static const char* Defaults[] =
     "gcache.recover",              "no",
     "gcache.size",                 "128M",
     "gcomm.thread_prio",           "",
+    "gcs.batch_window",            "0",
     "gcs.fc_debug",                "0",
     "gcs.fc_factor",               "1",
     "gcs.fc_limit",                "100",
     "gcs.fc_master_slave",         "no",
+    "gcs.max_batch",               "1",
     "gcs.max_packet_size",         "64500",
     "gcs.max_throttle",            "0.25",
 #if (GU_WORDSIZE == 32)
@@ -86,7 +94,12 @@ static const char* Defaults[] =
     "gmcast.segment",              "0",
     "gmcast.time_wait",            "PT5S",
     "gmcast.version",              "0",
+    "ist.compress",                "no",
 //  "ist.recv_addr",               no default,
+    "ist.recv_gcache",             "no",
+    "ist.recv_queue",              "64",
+    "ist.recv_streams",            "1",
+    "ist.send_batch",              "1M",
     "pc.announce_timeout",         "PT3S",
     "pc.checksum",                 "false",
     "pc.ignore_quorum",            "false",
@@ -101,14 +114,17 @@ static const char* Defaults[] =
     "protonet.backend",            "asio",
     "protonet.version",            "0",
     "repl.causal_read_timeout",    "PT30S",
+    "repl.checksum_threads",       "2",
     "repl.commit_order",           "3",
     "repl.key_format",             "FLAT8",
     "repl.max_ws_size",            "2147483647",
-    "repl.proto_max",              "9",
+    "repl.monitor_impl",           "mutex",
+    "repl.proto_max",              "10",
 #ifdef GU_DBUG_ON
     "signal",                      "",
 #endif
     "socket.checksum",             "2",
+    "socket.io_threads",           "1",
     "socket.recv_buf_size",        "auto",
     "socket.send_buf_size",        "auto",
 //  "socket.ssl",                  no default,
@@ -113,28 +113,38 @@ struct receiver_args
     wsrep_seqno_t last_;
     size_t        n_receivers_;
     TrxHandle::SlavePool& trx_pool_;
+    gcache::GCache& gcache_;
     int           version_;
+    size_t        n_streams_;
+    bool          recv_gcache_;
 
     receiver_args(const std::string listen_addr,
                   wsrep_seqno_t first, wsrep_seqno_t last,
-                  size_t n_receivers, TrxHandle::SlavePool& sp, int version)
+                  size_t n_receivers, TrxHandle::SlavePool& sp,
+                  gcache::GCache& gcache, int version,
+                  size_t n_streams, bool recv_gcache)
         :
         listen_addr_(listen_addr),
         first_      (first),
         last_       (last),
         n_receivers_(n_receivers),
         trx_pool_   (sp),
-        version_    (version)
+        gcache_     (gcache),
+        version_    (version),
+        n_streams_  (n_streams),
+        recv_gcache_(recv_gcache)
     { }
 };
 
 struct trx_thread_args
 {
     galera::ist::Receiver& receiver_;
+    gcache::GCache& gcache_;
     galera::Monitor<TestOrder> monitor_;
-    trx_thread_args(galera::ist::Receiver& receiver)
+    trx_thread_args(galera::ist::Receiver& receiver, gcache::GCache& gcache)
         :
         receiver_(receiver),
+        gcache_  (gcache),
 #ifdef HAVE_PSI_INTERFACE
         monitor_(WSREP_PFS_INSTR_TAG_IST_RECEIVER_MONITOR_MUTEX,
                  WSREP_PFS_INSTR_TAG_IST_RECEIVER_MONITOR_CONDVAR)
@@ -152,6 +162,10 @@ extern "C" void* sender_thd(void* arg)
 
     gu::Config conf;
     galera::ReplicatorSMM::InitConfig(conf, NULL, NULL);
+    // a few write sets per batch
+    conf.set("ist.send_batch", "256");
+    // newer versions are tested with compressed stream
+    conf.set("ist.compress", sargs->version_ >= 4 ? "yes" : "no");
     gu_barrier_wait(&start_barrier);
     sargs->gcache_.seqno_lock(sargs->first_); // unlocked in sender dtor
     galera::ist::Sender sender(conf, sargs->gcache_, sargs->peer_,
@@ -177,9 +191,20 @@ extern "C" void* trx_thread(void* arg)
             log_info << "terminated with " << err;
             return 0;
         }
+        if (trx->action())
+        {
+            // as in ReplicatorSMM::recv_IST()
+            targs->gcache_.seqno_assign(trx->action(), trx->global_seqno(),
+                                        trx->depends_seqno());
+        }
         TestOrder to(*trx);
         targs->monitor_.enter(to);
         targs->monitor_.leave(to);
+        if (trx->action())
+        {
+            // as in ReplicatorSMM::recv_IST()
+            targs->gcache_.seqno_release(targs->monitor_.last_left());
+        }
         trx->unref();
     }
     return 0;
@@ -197,14 +222,19 @@ extern "C" void* receiver_thd(void* arg)
     mark_point();
 
     conf.set(galera::ist::Receiver::RECV_ADDR, rargs->listen_addr_);
-    galera::ist::Receiver receiver(conf, rargs->trx_pool_, 0);
+    // shorter than the stream, so that receiver has to wait for consumers
+    conf.set(galera::ist::Receiver::RECV_QUEUE, "2");
+    conf.set(galera::ist::Receiver::RECV_STREAMS,
+             gu::to_string(rargs->n_streams_));
+    conf.set(galera::ist::Receiver::RECV_GCACHE, rargs->recv_gcache_);
+    galera::ist::Receiver receiver(conf, rargs->gcache_, rargs->trx_pool_, 0);
     rargs->listen_addr_ = receiver.prepare(rargs->first_, rargs->last_,
                                            rargs->version_);
 
     mark_point();
 
     std::vector<gu_thread_t> threads(rargs->n_receivers_);
-    trx_thread_args trx_thd_args(receiver);
+    trx_thread_args trx_thd_args(receiver, rargs->gcache_);
     for (size_t i(0); i < threads.size(); ++i)
     {
         log_info << "starting trx thread " << i;
@@ -245,7 +275,10 @@ static int select_trx_version(int protocol_version)
 }
 
 
-static void test_ist_common(int const version)
+static void test_ist_common(int const version,
+                            wsrep_seqno_t const last = 10,
+                            size_t const streams = 1,
+                            bool const recv_gcache = false)
 {
     using galera::KeyData;
     using galera::TrxHandle;
@@ -261,7 +294,8 @@ static void test_ist_common(int const version)
     galera::ReplicatorSMM::InitConfig(conf, NULL, NULL);
     std::string gcache_file("ist_check.cache");
     conf.set("gcache.name", gcache_file);
-    conf.set("gcache.size", "1M");
+    size_t const gcache_size(last > 10 ? (16 << 20) : (1 << 20));
+    conf.set("gcache.size", gu::to_string(gcache_size));
     std::string dir(".");
     std::string receiver_addr("tcp://127.0.0.1:0");
     wsrep_uuid_t uuid;
@@ -269,10 +303,19 @@ static void test_ist_common(int const version)
 
     gcache::GCache* gcache = new gcache::GCache(conf, dir);
 
+    // joiner gcache, to receive write sets into
+    std::string rgcache_file("ist_check_recv.cache");
+    gcache::GCache* rgcache(0);
+    if (recv_gcache)
+    {
+        conf.set("gcache.name", rgcache_file);
+        rgcache = new gcache::GCache(conf, dir);
+    }
+
     mark_point();
 
     // populate gcache
-    for (size_t i(1); i <= 10; ++i)
+    for (wsrep_seqno_t i(1); i <= last; ++i)
     {
         TrxHandle* trx(TrxHandle::New(lp, trx_params, uuid, 1234+i, 5678+i));
 
@@ -329,8 +372,10 @@ static void test_ist_common(int const version)
 
     mark_point();
 
-    receiver_args rargs(receiver_addr, 1, 10, 1, sp, version);
-    sender_args sargs(*gcache, rargs.listen_addr_, 1, 10, version);
+    receiver_args rargs(receiver_addr, 1, last, 1, sp,
+                        recv_gcache ? *rgcache : *gcache, version, streams,
+                        recv_gcache);
+    sender_args sargs(*gcache, rargs.listen_addr_, 1, last, version);
 
     gu_barrier_init(&start_barrier, 0, 1 + 1 + rargs.n_receivers_);
 
@@ -347,6 +392,45 @@ static void test_ist_common(int const version)
 
     mark_point();
 
+    if (recv_gcache)
+    {
+        // joiner gcache must hold the same continuous history as donor's
+        std::vector<gcache::GCache::Buffer> bufs(last);
+        std::vector<gcache::GCache::Buffer> rbufs(last);
+
+        gcache->seqno_lock(1);
+        rgcache->seqno_lock(1);
+        ck_assert(gcache->seqno_get_buffers(bufs, 1) == size_t(last));
+        ck_assert(rgcache->seqno_get_buffers(rbufs, 1) == size_t(last));
+
+        for (wsrep_seqno_t i(0); i < last; ++i)
+        {
+            ck_assert(rbufs[i].seqno_g() == i + 1);
+            ck_assert(rbufs[i].seqno_d() == bufs[i].seqno_d());
+            ck_assert(rbufs[i].size()    == bufs[i].size());
+            ck_assert(0 == ::memcmp(rbufs[i].ptr(), bufs[i].ptr(),
+                                    bufs[i].size()));
+        }
+
+        gcache->seqno_unlock();
+        rgcache->seqno_unlock();
+
+        // received buffers must have been released by consumers: cycling
+        // through the whole ring must discard them from history
+        size_t const chunk(gcache_size / 4);
+        for (int i(0); i < 8; ++i)
+        {
+            void* const ptr(rgcache->malloc(chunk));
+            ck_assert(ptr != 0);
+            rgcache->free(ptr);
+        }
+        ck_assert_msg(rgcache->seqno_min() == gcache::SEQNO_ILL,
+                      "seqno_min: %lld", (long long)rgcache->seqno_min());
+
+        delete rgcache;
+        unlink(rgcache_file.c_str());
+    }
+
     delete gcache;
 
     mark_point();
@@ -387,6 +471,19 @@ START_TEST(test_ist_v5)
 }
 END_TEST
 
+// enough write sets for 3 stripes
+START_TEST(test_ist_streams)
+{
+    test_ist_common(5, 3000, 4);
+}
+END_TEST
+
+START_TEST(test_ist_recv_gcache)
+{
+    test_ist_common(5, 100, 2, true);
+}
+END_TEST
+
 Suite* ist_suite()
 {
     Suite* s  = suite_create("ist");
@@ -421,5 +518,15 @@ Suite* ist_suite()
     tcase_add_test(tc, test_ist_v5);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_ist_streams");
+    tcase_set_timeout(tc, 60);
+    tcase_add_test(tc, test_ist_streams);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("test_ist_recv_gcache");
+    tcase_set_timeout(tc, 60);
+    tcase_add_test(tc, test_ist_recv_gcache);
+    suite_add_tcase(s, tc);
+
     return s;
 }
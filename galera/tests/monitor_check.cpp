@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "../src/monitor.hpp"
+
+#include <gu_throw.hpp>
+
+#include <check.h>
+#include <errno.h>
+#include <vector>
+
+namespace
+{
+    class TestOrder
+    {
+    public:
+        TestOrder(wsrep_seqno_t seqno, wsrep_seqno_t depends)
+            : seqno_(seqno), depends_(depends) { }
+        void lock() { }
+        void unlock() { }
+        wsrep_seqno_t seqno() const { return seqno_; }
+        bool condition(wsrep_seqno_t last_entered,
+                       wsrep_seqno_t last_left) const
+        {
+            return (last_left >= depends_);
+        }
+#ifdef GU_DBUG_ON
+#ifdef HAVE_PSI_INTERFACE
+        void debug_sync(gu::MutexWithPFS&) { }
+#else
+        void debug_sync(gu::Mutex&) { }
+#endif /* HAVE_PSI_INTERFACE */
+#endif // GU_DBUG_ON
+    private:
+        wsrep_seqno_t const seqno_;
+        wsrep_seqno_t const depends_;
+    };
+
+    typedef galera::Monitor<TestOrder> TestMonitor;
+
+    struct thd_args
+    {
+        TestMonitor&               mon_;
+        wsrep_seqno_t              last_;
+        wsrep_seqno_t              next_;  // next seqno to take
+        long                       pos_;   // next position in order_
+        std::vector<wsrep_seqno_t> order_; // seqnos in the order of entering
+        bool                       strict_;
+        long                       errors_;
+
+        thd_args(TestMonitor& mon, wsrep_seqno_t last, bool strict)
+            : mon_(mon), last_(last), next_(1), pos_(0),
+              order_(last), strict_(strict), errors_(0) { }
+    };
+
+    /* in strict mode every seqno depends on the previous one, otherwise
+     * every 4th depends on the previous one and the rest are independent */
+    extern "C" void* monitor_thd(void* arg)
+    {
+        thd_args* const args(static_cast<thd_args*>(arg));
+
+        for (;;)
+        {
+            wsrep_seqno_t const seqno
+                (gu_atomic_fetch_and_add(&args->next_, 1));
+
+            if (seqno > args->last_) break;
+
+            wsrep_seqno_t const depends
+                (args->strict_ || seqno % 4 == 0 ? seqno - 1 : 0);
+
+            TestOrder to(seqno, depends);
+            args->mon_.enter(to);
+            if (args->mon_.last_left() < depends)
+            {
+                gu_atomic_fetch_and_add(&args->errors_, 1);
+            }
+            args->order_[gu_atomic_fetch_and_add(&args->pos_, 1)] = seqno;
+            args->mon_.leave(to);
+        }
+
+        return 0;
+    }
+
+    void run_threads(bool const lock_free, bool const strict)
+    {
+        static size_t const n_thds(8);
+        static wsrep_seqno_t const last(20000);
+
+        TestMonitor mon(
+#ifdef HAVE_PSI_INTERFACE
+            WSREP_PFS_INSTR_TAG_APPLY_MONITOR_MUTEX,
+            WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR,
+#endif /* HAVE_PSI_INTERFACE */
+            lock_free);
+        ck_assert(mon.lock_free() == lock_free);
+        mon.set_initial_position(0);
+
+        thd_args args(mon, last, strict);
+
+        std::vector<gu_thread_t> thds(n_thds);
+        for (size_t i(0); i < thds.size(); ++i)
+        {
+            ck_assert(0 == gu_thread_create(&thds[i], 0, monitor_thd, &args));
+        }
+
+        mon.wait(last);
+        ck_assert(mon.last_left() == last);
+
+        for (size_t i(0); i < thds.size(); ++i)
+        {
+            gu_thread_join(thds[i], 0);
+        }
+
+        ck_assert_msg(0 == args.errors_, "%ld seqnos entered before their "
+                      "dependencies left", args.errors_);
+
+        if (strict)
+        {
+            for (wsrep_seqno_t i(0); i < last; ++i)
+            {
+                ck_assert_msg(args.order_[i] == i + 1,
+                              "position %lld: expected %lld, got %lld",
+                              (long long)i, (long long)i + 1,
+                              (long long)args.order_[i]);
+            }
+        }
+
+        mon.drain(last);
+        ck_assert(mon.last_left() == last);
+    }
+
+    void run_cancel(bool const lock_free)
+    {
+        TestMonitor mon(
+#ifdef HAVE_PSI_INTERFACE
+            WSREP_PFS_INSTR_TAG_APPLY_MONITOR_MUTEX,
+            WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR,
+#endif /* HAVE_PSI_INTERFACE */
+            lock_free);
+        mon.set_initial_position(0);
+
+        TestOrder to1(1, 0);
+        TestOrder to2(2, 1);
+        TestOrder to3(3, 2);
+
+        // interrupted before entering
+        mon.interrupt(to2);
+        try
+        {
+            mon.enter(to2);
+            ck_abort_msg("interrupted enter did not throw");
+        }
+        catch (gu::Exception& e)
+        {
+            ck_assert(e.get_errno() == EINTR);
+        }
+
+        mon.enter(to1);
+        mon.self_cancel(to2);
+        ck_assert(mon.last_left() == 0);
+        mon.leave(to1);
+        ck_assert(mon.last_left() == 2);
+
+        // finished out of order
+        TestOrder to4(4, 0);
+        mon.enter(to4);
+        mon.leave(to4);
+        ck_assert(mon.last_left() == 2);
+        mon.enter(to3);
+        mon.leave(to3);
+        ck_assert(mon.last_left() == 4);
+
+        double oooe, oool, win, batch;
+        long long waits;
+        mon.get_stats(&oooe, &oool, &win, &batch, &waits);
+        ck_assert(oooe > 0);
+        ck_assert(oool > 0);
+        ck_assert(batch > 1);
+    }
+}
+
+START_TEST(test_monitor_strict)
+{
+    run_threads(false, true);
+    run_threads(true, true);
+}
+END_TEST
+
+START_TEST(test_monitor_parallel)
+{
+    run_threads(false, false);
+    run_threads(true, false);
+}
+END_TEST
+
+START_TEST(test_monitor_cancel)
+{
+    run_cancel(false);
+    run_cancel(true);
+}
+END_TEST
+
+Suite* monitor_suite()
+{
+    Suite* s = suite_create("monitor");
+    TCase* tc;
+
+    tc = tcase_create("test_monitor_strict");
+    tcase_add_test(tc, test_monitor_strict);
+    tcase_set_timeout(tc, 60);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("test_monitor_parallel");
+    tcase_add_test(tc, test_monitor_parallel);
+    tcase_set_timeout(tc, 60);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("test_monitor_cancel");
+    tcase_add_test(tc, test_monitor_cancel);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
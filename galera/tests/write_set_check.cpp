@@ -14,6 +14,7 @@
 #include "gu_inttypes.hpp"
 
 #include <cstdlib>
+#include <sstream>
 #include <check.h>
 
 namespace
@@ -577,6 +578,298 @@ START_TEST(test_cert_hierarchical_v2)
 }
 END_TEST
 
+/* Creates slave trx of version 3 from a write set with given keys,
+ * buf holds the write set and must outlive the trx. */
+static TrxHandle*
+make_remote_trx_v3(gu::Buffer&          buf,
+                   const wsrep_uuid_t&  uuid,
+                   const wsrep_buf_t*   keys,
+                   size_t               key_num,
+                   bool                 shared,
+                   wsrep_seqno_t        global_seqno,
+                   wsrep_seqno_t        last_seen_seqno)
+{
+    const int version(3);
+    galera::TrxHandle::Params const trx_params("", version,KeySet::MAX_VERSION);
+
+    TrxHandle* trx(TrxHandle::New(lp, trx_params, uuid, 1, global_seqno));
+
+    for (size_t k(0); k < key_num; ++k)
+    {
+        trx->append_key(KeyData(version, &keys[k], 1,
+                                (shared ?
+                                 WSREP_KEY_SHARED : WSREP_KEY_EXCLUSIVE),
+                                true));
+    }
+
+    WriteSetNG::GatherVector out;
+    size_t const out_size(trx->write_set_out().gather(trx->source_id(),
+                                                      trx->conn_id(),
+                                                      trx->trx_id(),
+                                                      out));
+    trx->set_last_seen_seqno(last_seen_seqno);
+
+    buf.reserve(out_size);
+    for (size_t b(0); b < out->size(); ++b)
+    {
+        const gu::byte_t* ptr(static_cast<const gu::byte_t*>(out[b].ptr));
+        buf.insert(buf.end(), ptr, ptr + out[b].size);
+    }
+    trx->unref();
+
+    trx = TrxHandle::New(sp);
+    trx->unserialize(&buf[0], buf.size(), 0);
+    trx->set_received(0, global_seqno, global_seqno);
+
+    return trx;
+}
+
+static void
+test_cert_v3(bool const pipeline, const char* const index_impl)
+{
+    const int version(3);
+    struct wsinfo_ {
+        wsrep_uuid_t     uuid;
+        wsrep_buf_t      key[2];
+        size_t           key_num;
+        bool             shared;
+        wsrep_seqno_t    global_seqno;
+        wsrep_seqno_t    last_seen_seqno;
+        wsrep_seqno_t    expected_depends_seqno;
+        Certification::TestResult result;
+    } wsi[] = {
+        // 1: no dependencies
+        { { {1, } }, { {void_cast("1"), 1}, }, 1, false,
+          1, 0, 0, Certification::TEST_OK },
+        // 2: same source, depends on 1
+        { { {1, } }, { {void_cast("1"), 1}, }, 1, false,
+          2, 0, 1, Certification::TEST_OK },
+        // 3: collides with 2
+        { { {2, } }, { {void_cast("1"), 1}, }, 1, false,
+          3, 1, -1, Certification::TEST_FAILED },
+        // 4: 2 is seen, depends on 2
+        { { {2, } }, { {void_cast("1"), 1}, }, 1, false,
+          4, 2, 2, Certification::TEST_OK },
+        // 5: shared, no dependencies
+        { { {1, } }, { {void_cast("2"), 1}, }, 1, true,
+          5, 4, 0, Certification::TEST_OK },
+        // 6: exclusive - shared, depends on 5
+        { { {2, } }, { {void_cast("2"), 1}, }, 1, false,
+          6, 4, 5, Certification::TEST_OK },
+        // 7: new key "3" followed by collision with 6 on key "2"
+        { { {1, } }, { {void_cast("3"), 1}, {void_cast("2"), 1} }, 2, false,
+          7, 5, -1, Certification::TEST_FAILED },
+        // 8: key "3" must have been removed from the index by failed 7
+        { { {2, } }, { {void_cast("3"), 1}, }, 1, false,
+          8, 0, 0, Certification::TEST_OK },
+    };
+
+    size_t nws(sizeof(wsi)/sizeof(wsi[0]));
+
+    /* write sets must outlive cert, it purges their keys in destructor */
+    std::vector<gu::Buffer> bufs(nws);
+
+    TestEnv env;
+    env.conf().set(Certification::PARAM_INDEX_IMPL, index_impl);
+    galera::Certification cert(env.conf(), env.thd(), env.gcache());
+    cert.param_set(Certification::PARAM_PIPELINE, pipeline ? "yes" : "no");
+
+    cert.assign_initial_position(0, version);
+
+    mark_point();
+
+    for (size_t i(0); i < nws; ++i)
+    {
+        TrxHandle* const trx(make_remote_trx_v3(bufs[i], wsi[i].uuid,
+                                                wsi[i].key, wsi[i].key_num,
+                                                wsi[i].shared,
+                                                wsi[i].global_seqno,
+                                                wsi[i].last_seen_seqno));
+        cert.prepare(trx);
+        ck_assert(trx->cert_keys_ng().size() == (pipeline ? wsi[i].key_num :0));
+
+        Certification::TestResult result(cert.append_trx(trx));
+        ck_assert_msg(result == wsi[i].result, "g: %" PRId64 " res: %d exp: %d",
+                      trx->global_seqno(), result, wsi[i].result);
+        ck_assert_msg(trx->depends_seqno() == wsi[i].expected_depends_seqno,
+                      "wsi: %zu g: %" PRId64 " ld: %" PRId64 " eld: %" PRId64,
+                      i, trx->global_seqno(), trx->depends_seqno(),
+                      wsi[i].expected_depends_seqno);
+        cert.set_trx_committed(trx);
+        trx->unref();
+    }
+}
+
+START_TEST(test_cert_v3)
+{
+    log_info << "test_cert_v3";
+    test_cert_v3(false, "hash");
+}
+END_TEST
+
+START_TEST(test_cert_v3_pipeline)
+{
+    log_info << "test_cert_v3_pipeline";
+    test_cert_v3(true, "hash");
+}
+END_TEST
+
+START_TEST(test_cert_v3_flat)
+{
+    log_info << "test_cert_v3_flat";
+    test_cert_v3(false, "flat");
+    test_cert_v3(true,  "flat");
+}
+END_TEST
+
+/* index purge must remove entries from all index shards */
+static void
+test_cert_v3_purge(const char* const index_impl, bool const background)
+{
+    static size_t const NKEYS(64); // enough to hit every index shard
+    static size_t const NTRX(8);
+
+    char        key_str[NKEYS][4];
+    wsrep_buf_t keys[NKEYS];
+    for (size_t k(0); k < NKEYS; ++k)
+    {
+        snprintf(key_str[k], sizeof(key_str[k]), "%zu", k);
+        keys[k].ptr = key_str[k];
+        keys[k].len = strlen(key_str[k]);
+    }
+
+    wsrep_uuid_t const uuid[2] = { { {1, } }, { {2, } } };
+
+    /* write sets must outlive cert, it purges their keys in destructor */
+    std::vector<gu::Buffer> bufs(NTRX + 1);
+
+    TestEnv env;
+    env.conf().set(Certification::PARAM_INDEX_IMPL, index_impl);
+    /* one trx per background purge step */
+    env.conf().set(Certification::PARAM_PURGE_STEP_KEYS,
+                   background ? "1" : "0");
+    galera::Certification cert(env.conf(), env.thd(), env.gcache());
+    cert.assign_initial_position(0, 3);
+
+    for (size_t i(0); i < NTRX; ++i)
+    {
+        wsrep_seqno_t const g(i + 1);
+        TrxHandle* const trx(make_remote_trx_v3(bufs[i], uuid[i % 2],
+                                                keys, NKEYS, false, g, g - 1));
+
+        ck_assert(cert.append_trx(trx) == Certification::TEST_OK);
+        ck_assert_msg(trx->depends_seqno() == g - 1,
+                      "g: %" PRId64 " ld: %" PRId64, g, trx->depends_seqno());
+        cert.set_trx_committed(trx);
+        trx->unref();
+    }
+
+    size_t bucket_count(cert.bucket_count());
+    ck_assert(bucket_count > 0);
+
+    /* all trxs are committed, last one has seen NTRX - 1 */
+    ck_assert(cert.get_safe_to_discard_seqno() == NTRX - 1);
+    ck_assert(cert.purge_trxs_upto(NTRX, background) == NTRX - 1);
+    cert.purge_flush();
+    ck_assert(cert.purge_latency().find("nan") == std::string::npos);
+
+    /* purged trxs are gone from trx map, last one still holds the keys */
+    ck_assert(cert.get_trx(NTRX - 1) == 0);
+    TrxHandle* const last(cert.get_trx(NTRX));
+    ck_assert(last != 0);
+    last->unref();
+
+    /* conflict with the trx left in the index */
+    TrxHandle* const trx(make_remote_trx_v3(bufs[NTRX], uuid[NTRX % 2],
+                                            keys, NKEYS, false,
+                                            NTRX + 1, NTRX - 1));
+    ck_assert(cert.append_trx(trx) == Certification::TEST_FAILED);
+    cert.set_trx_committed(trx);
+    trx->unref();
+}
+
+START_TEST(test_cert_v3_purge)
+{
+    log_info << "test_cert_v3_purge";
+    test_cert_v3_purge("hash", false);
+    test_cert_v3_purge("flat", false);
+    test_cert_v3_purge("hash", true);
+    test_cert_v3_purge("flat", true);
+}
+END_TEST
+
+START_TEST(test_key_entry_table)
+{
+    log_info << "test_key_entry_table";
+
+    static size_t const NKEYS(1000); // enough for a few table resizes
+
+    std::vector<std::string> key_str(NKEYS);
+    std::vector<wsrep_buf_t> keys(NKEYS);
+    for (size_t k(0); k < NKEYS; ++k)
+    {
+        std::ostringstream os;
+        os << "key" << k;
+        key_str[k] = os.str();
+        keys[k].ptr = key_str[k].c_str();
+        keys[k].len = key_str[k].length();
+    }
+
+    gu::Buffer buf;
+    wsrep_uuid_t const uuid = { {1, } };
+    TrxHandle* const trx(make_remote_trx_v3(buf, uuid, &keys[0], NKEYS,
+                                            false, 1, 0));
+
+    const KeySetIn& ks(trx->write_set_in().keyset());
+    ck_assert(size_t(ks.count()) == NKEYS);
+
+    std::vector<KeyEntryNG*> entries;
+    ks.rewind();
+    for (size_t k(0); k < NKEYS; ++k)
+    {
+        entries.push_back(new KeyEntryNG(ks.next()));
+    }
+
+    KeyEntryTableNG table;
+    ck_assert(table.find(*entries[0]) == NULL);
+
+    for (size_t k(0); k < NKEYS; ++k)
+    {
+        table.insert(entries[k]);
+    }
+    ck_assert(table.size() == NKEYS);
+    ck_assert(table.bucket_count() >= 2 * NKEYS);
+
+    for (size_t k(0); k < NKEYS; ++k)
+    {
+        KeyEntryNG ke(entries[k]->key());
+        ck_assert_msg(table.find(ke) == entries[k], "key %zu not found", k);
+    }
+
+    /* erase every other entry, the rest must stay reachable */
+    for (size_t k(0); k < NKEYS; k += 2)
+    {
+        table.erase(entries[k]);
+    }
+    ck_assert(table.size() == NKEYS / 2);
+
+    for (size_t k(0); k < NKEYS; ++k)
+    {
+        KeyEntryNG ke(entries[k]->key());
+        ck_assert_msg(table.find(ke) == (k % 2 ? entries[k] : NULL),
+                      "key %zu lookup mismatch", k);
+    }
+
+    table.for_each(gu::DeleteObject());
+    table.clear();
+    ck_assert(table.empty());
+
+    for (size_t k(0); k < NKEYS; k += 2) delete entries[k];
+
+    trx->unref();
+}
+END_TEST
+
 // This test leaks memory and it is for trx protocol version 2
 // which is pre 25.3.5. Disabling this test for now with ASAN
 // build. The test should be either removed or fixed to work
@@ -686,6 +979,15 @@ Suite* write_set_suite()
     tcase_set_timeout(tc, 120);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_cert_v3");
+    tcase_add_test(tc, test_cert_v3);
+    tcase_add_test(tc, test_cert_v3_pipeline);
+    tcase_add_test(tc, test_cert_v3_flat);
+    tcase_add_test(tc, test_cert_v3_purge);
+    tcase_add_test(tc, test_key_entry_table);
+    tcase_set_timeout(tc, 20);
+    suite_add_tcase(s, tc);
+
 #ifndef GALERA_WITH_ASAN
     tc = tcase_create("test_trac_726");
     tcase_add_test(tc, test_trac_726);
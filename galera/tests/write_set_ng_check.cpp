@@ -296,6 +296,12 @@ START_TEST (ver3_basic_rsv2_wsv4)
 }
 END_TEST
 
+START_TEST (ver3_basic_rsv2_wsv5)
+{
+    ver3_basic(gu::RecordSet::VER2, WriteSetNG::VER5);
+}
+END_TEST
+
 static void ver3_annotation(gu::RecordSet::Version const rsv)
 {
     union {
@@ -395,6 +401,96 @@ START_TEST (ver3_annotation_rsv2)
 }
 END_TEST
 
+START_TEST (ver3_checksum_pool)
+{
+    std::string const dir(".");
+    wsrep_trx_id_t trx_id(1);
+    WriteSetOut wso (dir, trx_id, KeySet::FLAT8A, 0, 0, 0,
+                     gu::RecordSet::VER2, WriteSetNG::VER5);
+
+    TestKey tk0(KeySet::MAX_VERSION, WSREP_KEY_EXCLUSIVE, true, "a0");
+    wso.append_key(tk0());
+
+    /* big enough for data set to be checksummed in chunks */
+    std::vector<gu::byte_t> data(3 * gu::RecordSet::CHECK_CHUNK_SIZE);
+    for (size_t i(0); i < data.size(); ++i) data[i] = i % 251;
+    wso.append_data (data.data(), data.size(), false);
+
+    wsrep_uuid_t source;
+    gu_uuid_generate (reinterpret_cast<gu_uuid_t*>(&source), NULL, 0);
+
+    WriteSetNG::GatherVector out;
+    size_t const out_size(wso.gather(source, 1, 2, out));
+    wso.set_last_seen(1);
+
+    std::vector<gu::byte_t> in;
+    in.reserve(out_size);
+    for (size_t i(0); i < out->size(); ++i)
+    {
+        const gu::byte_t* ptr(static_cast<const gu::byte_t*>(out[i].ptr));
+        in.insert (in.end(), ptr, ptr + out[i].size);
+    }
+
+    gu::Buf const in_buf = { in.data(), static_cast<ssize_t>(in.size()) };
+
+    ChecksumPool& pool(ChecksumPool::instance());
+    pool.stats_reset();
+
+    for (size_t thds(0); thds <= 4; thds += 2)
+    {
+        pool.set_threads(thds);
+
+        std::vector<WriteSetIn*> wsi(16);
+        for (size_t i(0); i < wsi.size(); ++i)
+        {
+            wsi[i] = new WriteSetIn(in_buf, 2);
+        }
+
+        /* plus up to thds helper jobs for the record set each thread
+         * is checksumming */
+        ck_assert(pool.queue_len() <= long(wsi.size() + thds * thds));
+
+        /* every other is destroyed without verification */
+        for (size_t i(0); i < wsi.size(); ++i)
+        {
+            if (i % 2) wsi[i]->verify_checksum();
+            delete wsi[i];
+        }
+
+        ck_assert(pool.queue_len() == 0);
+    }
+
+    /* resizing the pool must not lose queued writesets */
+    pool.set_threads(1);
+    {
+        WriteSetIn wsi(in_buf, 2);
+        pool.set_threads(2);
+        wsi.verify_checksum();
+    }
+    {
+        WriteSetIn wsi(in_buf, 2);
+        pool.set_threads(0);
+        wsi.verify_checksum();
+    }
+
+    ck_assert(pool.latency().find(":") != std::string::npos);
+    pool.set_threads(ChecksumPool::DEFAULT_THREADS);
+
+    /* corruption in the last chunk */
+    in[in.size() - 2] ^= 1;
+    try
+    {
+        WriteSetIn wsi(in_buf, 2);
+        wsi.verify_checksum();
+        ck_abort_msg("payload corruption slipped through");
+    }
+    catch (gu::Exception& e)
+    {
+        ck_assert(e.get_errno() == EINVAL);
+    }
+}
+END_TEST
+
 Suite* write_set_ng_suite ()
 {
     Suite* s = suite_create ("WriteSet");
@@ -405,6 +501,7 @@ Suite* write_set_ng_suite ()
 #endif
     tcase_add_test (t, ver3_basic_rsv2_wsv3);
     tcase_add_test (t, ver3_basic_rsv2_wsv4);
+    tcase_add_test (t, ver3_basic_rsv2_wsv5);
     tcase_set_timeout(t, 60);
     suite_add_tcase (s, t);
 
@@ -416,5 +513,10 @@ Suite* write_set_ng_suite ()
     tcase_set_timeout(t, 60);
     suite_add_tcase (s, t);
 
+    t = tcase_create ("WriteSet checksum pool");
+    tcase_add_test (t, ver3_checksum_pool);
+    tcase_set_timeout(t, 60);
+    suite_add_tcase (s, t);
+
     return s;
 }
@@ -87,6 +87,10 @@ extern "C" {
 #error "This GCC version does not support 8-byte atomics on this platform. Use GCC >= 4.7.x."
 #endif /* __ATOMIC_RELAXED */
 
+// stores val into ptr if it contains old, returns true on success
+#define gu_atomic_bool_compare_and_swap(ptr, old, val)  \
+    __sync_bool_compare_and_swap(ptr, old, val)
+
 #else /* __GNUC__ */
 #error "Compiler not supported"
 #endif
@@ -24,7 +24,7 @@ namespace gu
      * @return      value cast to TO
      */
     template <typename FROM, typename TO> inline
-    TO convert (const FROM& from, const TO& to)
+    TO convert (const FROM& from, const TO&)
     {
         if (gu_unlikely(from > std::numeric_limits<TO>::max() ||
                         from < std::numeric_limits<TO>::min()))
@@ -42,7 +42,7 @@ namespace gu
     /* Specialized templates are for signed conversion */
 
     template <> inline
-    long long convert (const unsigned long long& from, const long long& to)
+    long long convert (const unsigned long long& from, const long long&)
     {
         if (gu_unlikely(from > static_cast<unsigned long long>
                         (std::numeric_limits<long long>::max())))
@@ -56,7 +56,7 @@ namespace gu
 
     template <> inline
     unsigned long long convert (const long long& from,
-                                const unsigned long long& to)
+                                const unsigned long long&)
     {
         if (gu_unlikely(from < 0))
         {
@@ -68,7 +68,7 @@ namespace gu
     }
 
     template <> inline
-    long convert (const unsigned long& from, const long& to)
+    long convert (const unsigned long& from, const long&)
     {
         if (gu_unlikely(from > static_cast<unsigned long>
                         (std::numeric_limits<long>::max())))
@@ -81,7 +81,7 @@ namespace gu
     }
 
     template <> inline
-    unsigned long convert (const long& from, const unsigned long& to)
+    unsigned long convert (const long& from, const unsigned long&)
     {
         if (gu_unlikely(from < 0))
         {
@@ -93,7 +93,7 @@ namespace gu
     }
 
     template <> inline
-    int convert (const unsigned int& from, const int& to)
+    int convert (const unsigned int& from, const int&)
     {
         if (gu_unlikely(from > static_cast<unsigned int>
                         (std::numeric_limits<int>::max())))
@@ -106,7 +106,7 @@ namespace gu
     }
 
     template <> inline
-    unsigned int convert (const int& from, const unsigned int& to)
+    unsigned int convert (const int& from, const unsigned int&)
     {
         if (gu_unlikely(from < 0))
         {
@@ -89,7 +89,8 @@ std::ostream& gu::operator<<(std::ostream& os, const Histogram& hs)
     {
         i_next = i;
         ++i_next;
-        os << i->first << ":" << std::fabs(double(i->second)/double(norm));
+        os << i->first << ":"
+           << (norm ? std::fabs(double(i->second)/double(norm)) : 0.);
         if (i_next != hs.cnt_.end()) os << ",";
     }
 
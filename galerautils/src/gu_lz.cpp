@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "gu_lz.hpp"
+#include "gu_throw.hpp"
+
+#include <cstring>
+#include <stdint.h>
+
+namespace
+{
+    static size_t const MIN_MATCH  = 4;
+    static size_t const MAX_OFFSET = 65535;
+    static int    const HASH_BITS  = 12;
+
+    typedef unsigned char byte;
+
+    inline uint32_t read32(const byte* const p)
+    {
+        uint32_t ret;
+        ::memcpy(&ret, p, sizeof(ret));
+        return ret;
+    }
+
+    inline size_t hash(uint32_t const seq)
+    {
+        return (seq * 2654435761U) >> (32 - HASH_BITS);
+    }
+
+    /* writes length continuation bytes after the nibble */
+    inline byte* put_length(byte* op, size_t len)
+    {
+        for (; len >= 255; len -= 255) *op++ = 255;
+        *op++ = byte(len);
+        return op;
+    }
+
+    inline byte* put_sequence(byte* op,
+                              const byte* const lit, size_t const lit_len,
+                              size_t const offset, size_t const match_len)
+    {
+        byte* const token(op++);
+
+        *token = byte((lit_len < 15 ? lit_len : 15) << 4);
+        if (lit_len >= 15) op = put_length(op, lit_len - 15);
+
+        ::memcpy(op, lit, lit_len);
+        op += lit_len;
+
+        if (0 == match_len) return op; // last sequence
+
+        *op++ = byte(offset);
+        *op++ = byte(offset >> 8);
+
+        size_t const ml(match_len - MIN_MATCH);
+        *token |= byte(ml < 15 ? ml : 15);
+        if (ml >= 15) op = put_length(op, ml - 15);
+
+        return op;
+    }
+
+    inline size_t get_length(const byte*& ip, const byte* const end,
+                             size_t len)
+    {
+        if (len < 15) return len;
+
+        byte b;
+        do
+        {
+            if (gu_unlikely(ip >= end))
+            {
+                gu_throw_error(EINVAL) << "truncated compressed length";
+            }
+            b = *ip++;
+            len += b;
+        }
+        while (255 == b);
+
+        return len;
+    }
+}
+
+size_t
+gu::lz::compress(const void* const src, size_t const len, void* const dst)
+{
+    const byte* const base(static_cast<const byte*>(src));
+    byte*             op(static_cast<byte*>(dst));
+
+    size_t table[1 << HASH_BITS]; // position + 1, 0 is empty
+    ::memset(table, 0, sizeof(table));
+
+    size_t anchor(0);
+
+    if (len >= MIN_MATCH)
+    {
+        size_t const limit(len - MIN_MATCH);
+        size_t       ip(0);
+
+        while (ip <= limit)
+        {
+            uint32_t const seq(read32(base + ip));
+            size_t&        slot(table[hash(seq)]);
+            size_t const   ref(slot);
+
+            slot = ip + 1;
+
+            if (ref > 0 && ip - (ref - 1) <= MAX_OFFSET &&
+                read32(base + ref - 1) == seq)
+            {
+                size_t const from(ref - 1);
+                size_t       ml(MIN_MATCH);
+
+                while (ip + ml < len && base[from + ml] == base[ip + ml]) ++ml;
+
+                op = put_sequence(op, base + anchor, ip - anchor,
+                                  ip - from, ml);
+                ip    += ml;
+                anchor = ip;
+            }
+            else
+            {
+                /* skip faster through incompressible data */
+                ip += 1 + ((ip - anchor) >> 6);
+            }
+        }
+    }
+
+    op = put_sequence(op, base + anchor, len - anchor, 0, 0);
+
+    return op - static_cast<byte*>(dst);
+}
+
+void
+gu::lz::decompress(const void* const src, size_t const len,
+                   void* const dst, size_t const dst_len)
+{
+    const byte*       ip(static_cast<const byte*>(src));
+    const byte* const ip_end(ip + len);
+    byte*             op(static_cast<byte*>(dst));
+    byte* const       op_begin(op);
+    byte* const       op_end(op + dst_len);
+
+    for (;;)
+    {
+        if (gu_unlikely(ip >= ip_end))
+        {
+            gu_throw_error(EINVAL) << "truncated compressed block";
+        }
+
+        byte const   token(*ip++);
+        size_t const lit_len(get_length(ip, ip_end, token >> 4));
+
+        if (gu_unlikely(lit_len > size_t(ip_end - ip) ||
+                        lit_len > size_t(op_end - op)))
+        {
+            gu_throw_error(EINVAL) << "compressed literals out of bounds";
+        }
+
+        ::memcpy(op, ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == ip_end) break; // last sequence
+
+        if (gu_unlikely(ip_end - ip < 2))
+        {
+            gu_throw_error(EINVAL) << "truncated match offset";
+        }
+
+        size_t const offset(ip[0] | (size_t(ip[1]) << 8));
+        ip += 2;
+
+        size_t const ml(get_length(ip, ip_end, token & 15) + MIN_MATCH);
+
+        if (gu_unlikely(0 == offset || offset > size_t(op - op_begin) ||
+                        ml > size_t(op_end - op)))
+        {
+            gu_throw_error(EINVAL) << "compressed match out of bounds";
+        }
+
+        /* match may overlap with output, copy byte by byte then */
+        const byte* from(op - offset);
+        if (offset >= ml)
+        {
+            ::memcpy(op, from, ml);
+            op += ml;
+        }
+        else
+        {
+            for (byte* const end(op + ml); op < end; ++op, ++from) *op = *from;
+        }
+    }
+
+    if (gu_unlikely(op != op_end))
+    {
+        gu_throw_error(EINVAL) << "compressed block size mismatch: "
+                               << (op - op_begin) << ", expected " << dst_len;
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*!
+ * @file Fast byte oriented LZ77 block compression.
+ *
+ * Sequence format follows LZ4 block: token byte with literal length in the
+ * upper and match length - 4 in the lower nibble (15 means that length
+ * continues in the following bytes, 255 per byte), literals, 2-byte
+ * little-endian match offset, match length continuation. The last sequence
+ * consists of literals only. Favors speed over ratio.
+ */
+
+#ifndef _gu_lz_hpp_
+#define _gu_lz_hpp_
+
+#include <cstddef>
+
+namespace gu
+{
+    namespace lz
+    {
+        /*! maximum compressed size of len bytes */
+        inline size_t bound(size_t const len) { return len + len/255 + 16; }
+
+        /*!
+         * Compresses len bytes at src into dst, which must be at least
+         * bound(len) bytes long.
+         * @return compressed size
+         */
+        size_t compress(const void* src, size_t len, void* dst);
+
+        /*!
+         * Decompresses len bytes at src into exactly dst_len bytes at dst.
+         * Throws EINVAL if input is malformed or does not decompress
+         * to dst_len bytes.
+         */
+        void decompress(const void* src, size_t len,
+                        void* dst, size_t dst_len);
+    }
+}
+
+#endif // _gu_lz_hpp_
@@ -0,0 +1,134 @@
+/* Copyright (C) 2026 Codership Oy <info@codership.com> */
+
+#include "gu_mem_pool.hpp"
+
+#include <algorithm>
+
+gu::MemPool<true>::~MemPool()
+{
+    if (keyed_) gu_thread_key_delete(key_);
+
+    /* cache_destroy() won't be called for the remaining caches */
+    void* unpooled[CACHE_SIZE];
+
+    for (size_t i(0); i < caches_.size(); ++i)
+    {
+        Cache* const c(caches_[i]);
+        size_t const n(to_pool(*c, c->count_, unpooled));
+
+        for (size_t j(0); j < n; ++j) base_.free(unpooled[j]);
+
+        delete c;
+    }
+}
+
+gu::MemPool<true>::Cache*
+gu::MemPool<true>::new_cache()
+{
+    Cache* const ret(new Cache());
+    ret->pool_ = this;
+
+    {
+        Lock lock(mtx_);
+        caches_.push_back(ret);
+    }
+
+    if (gu_unlikely(gu_thread_setspecific(key_, ret)))
+    {
+        Lock lock(mtx_);
+        caches_.pop_back();
+        delete ret;
+        return NULL;
+    }
+
+    return ret;
+}
+
+void*
+gu::MemPool<true>::refill(Cache& c)
+{
+    assert(0 == c.count_);
+
+    void* ret;
+
+    {
+        Lock lock(mtx_);
+
+        ret = base_.from_pool();
+
+        while (ret && c.count_ < CACHE_BATCH - 1 && base_.pool_.size() > 0)
+        {
+            c.bufs_[c.count_++] = base_.from_pool();
+        }
+    }
+
+    if (!ret) ret = base_.alloc();
+
+    return ret;
+}
+
+size_t
+gu::MemPool<true>::to_pool(Cache& c, size_t n, void** const unpooled)
+{
+    assert(n <= c.count_);
+
+    size_t ret(0);
+
+    for (; n > 0; --n)
+    {
+        void* const buf(c.bufs_[--c.count_]);
+        if (!base_.to_pool(buf)) unpooled[ret++] = buf;
+    }
+
+    return ret;
+}
+
+void
+gu::MemPool<true>::flush(Cache& c, size_t const n)
+{
+    void*  unpooled[CACHE_SIZE];
+    size_t m;
+
+    {
+        Lock lock(mtx_);
+        m = to_pool(c, n, unpooled);
+    }
+
+    for (size_t i(0); i < m; ++i) base_.free(unpooled[i]);
+}
+
+void
+gu::MemPool<true>::cache_destroy(void* const arg)
+{
+    Cache* const   c(static_cast<Cache*>(arg));
+    MemPool<true>& mp(*c->pool_);
+
+    mp.flush(*c, c->count_);
+
+    {
+        Lock lock(mp.mtx_);
+        mp.caches_.erase(std::find(mp.caches_.begin(), mp.caches_.end(), c));
+    }
+
+    delete c;
+}
+
+void
+gu::MemPool<true>::print(std::ostream& os) const
+{
+    Lock lock(mtx_);
+
+    base_.print(os);
+
+    /* per-thread stats are updated without locking, so are approximate */
+    os << ", thread caches: " << caches_.size();
+
+    for (size_t i(0); i < caches_.size(); ++i)
+    {
+        const Cache& c(*caches_[i]);
+
+        os << (i ? ", " : " (hits/misses: ") << c.hits_ << '/' << c.misses_;
+    }
+
+    if (!caches_.empty()) os << ')';
+}
@@ -15,6 +15,7 @@
 
 #include "gu_lock.hpp"
 #include "gu_macros.hpp"
+#include "gu_threads.h"
 
 #include <assert.h>
 
@@ -169,27 +170,51 @@ namespace gu
     /* Thread-safe MemPool specialization.
      * Even though MemPool<true> technically IS-A MemPool<false>, the need to
      * overload nearly all public methods and practical uselessness of
-     * polymorphism in this case make inheritance undesirable. */
+     * polymorphism in this case make inheritance undesirable.
+     *
+     * Each thread keeps a small cache of buffers in front of the shared pool,
+     * so that most acquire()/recycle() calls don't need to take the mutex.
+     * Buffers move between thread cache and the shared pool in batches. */
     template <>
     class MemPool<true>
     {
     public:
 
+        static size_t const CACHE_SIZE  = 16; /* max buffers in thread cache */
+        static size_t const CACHE_BATCH = 8;  /* buffers moved at once     */
+
         explicit
         MemPool(int buf_size, int reserve = 0, const char* name = "")
             :
-            base_(buf_size, reserve, name),
+            base_  (buf_size, reserve, name),
 #ifdef HAVE_PSI_INTERFACE
-            mtx_ (WSREP_PFS_INSTR_TAG_MEMPOOL_MUTEX)
+            mtx_   (WSREP_PFS_INSTR_TAG_MEMPOOL_MUTEX),
 #else
-            mtx_ ()
+            mtx_   (),
 #endif /* HAVE_PSI_INTERFACE */
+            key_   (),
+            keyed_ (0 == gu_thread_key_create(&key_, cache_destroy)),
+            caches_()
         {}
 
-        ~MemPool() {}
+        ~MemPool();
 
         void* acquire()
         {
+            Cache* const c(cache());
+
+            if (gu_likely(c != NULL))
+            {
+                if (gu_likely(c->count_ > 0))
+                {
+                    ++c->hits_;
+                    return c->bufs_[--c->count_];
+                }
+
+                ++c->misses_;
+                return refill(*c);
+            }
+
             void* ret;
 
             {
@@ -204,6 +229,19 @@ namespace gu
 
         void recycle(void* buf)
         {
+            Cache* const c(cache());
+
+            if (gu_likely(c != NULL))
+            {
+                if (gu_unlikely(CACHE_SIZE == c->count_))
+                {
+                    flush(*c, CACHE_BATCH);
+                }
+
+                c->bufs_[c->count_++] = buf;
+                return;
+            }
+
             bool pooled;
 
             {
@@ -214,22 +252,53 @@ namespace gu
             if (!pooled) base_.free(buf);
         }
 
-        void print(std::ostream& os) const
-        {
-            Lock lock(mtx_);
-            base_.print(os);
-        }
+        void print(std::ostream& os) const;
 
         size_t buf_size() const { return base_.buf_size(); }
 
     private:
 
+        struct Cache
+        {
+            MemPool<true>* pool_;
+            void*          bufs_[CACHE_SIZE];
+            size_t         count_;
+            size_t         hits_;   /* served from thread cache */
+            size_t         misses_; /* had to go to shared pool */
+        };
+
         MemPool<false> base_;
 #ifdef HAVE_PSI_INTERFACE
         gu::MutexWithPFS mtx_;
 #else
         gu::Mutex      mtx_;
 #endif /* HAVE_PSI_INTERFACE */
+        gu_thread_key_t     key_;
+        bool const          keyed_;
+        std::vector<Cache*> caches_; /* all thread caches, protected by mtx_ */
+
+        Cache* cache()
+        {
+            if (gu_unlikely(!keyed_)) return NULL;
+
+            Cache* const ret(static_cast<Cache*>(gu_thread_getspecific(key_)));
+
+            return (gu_likely(ret != NULL) ? ret : new_cache());
+        }
+
+        Cache* new_cache();
+        void*  refill(Cache& c);
+        void   flush (Cache& c, size_t n);
+
+        /* moves n buffers from cache to the shared pool, must be called
+         * under mtx_, buffers which were not accepted go to unpooled */
+        size_t to_pool(Cache& c, size_t n, void** unpooled);
+
+        /* flushes and deletes cache of the exiting thread */
+        static void cache_destroy(void* c);
+
+        MemPool (const MemPool&);
+        MemPool operator= (const MemPool&);
 
     }; /* class MemPool<true>: thread-safe */
 
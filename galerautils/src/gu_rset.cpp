@@ -35,6 +35,7 @@ RecordSet::check_size (RecordSet::CheckType const ct)
     case RecordSet::CHECK_MMH32:  return 4;
     case RecordSet::CHECK_MMH64:  return 8;
     case RecordSet::CHECK_MMH128: return 16;
+    case RecordSet::CHECK_MMH128_TREE: return 16;
 #define MAX_CHECKSUM_SIZE                16
     }
 
@@ -275,6 +276,10 @@ RecordSetOutBase::write_header (byte_t* const buf, ssize_t const size)
     if (check_type() != CHECK_NONE)
     {
         assert (csize <= size - off);
+        if (CHECK_MMH128_TREE == check_type() && chunk_size_ > 0)
+        {
+            check_chunk_fin();
+        }
         check_.append (buf + hdr_offset, off - hdr_offset); /* append header */
         check_.gather (buf + off, csize);
     }
@@ -375,6 +380,8 @@ RecordSetOutBase::RecordSetOutBase (byte_t*                 reserved,
 #endif
     alloc_      (base_name, reserved, reserved_size),
     check_      (),
+    chunk_      (),
+    chunk_size_ (0),
     bufs_       (),
     prev_stored_(true)
 {
@@ -390,6 +397,35 @@ RecordSetOutBase::RecordSetOutBase (byte_t*                 reserved,
 }
 
 
+void
+RecordSetOutBase::check_append_tree (const byte_t* ptr, size_t size)
+{
+    while (size > 0)
+    {
+        size_t const left(CHECK_CHUNK_SIZE - chunk_size_);
+        size_t const n(size < left ? size : left);
+
+        chunk_.append (ptr, n);
+        chunk_size_ += n;
+        ptr  += n;
+        size -= n;
+
+        if (CHECK_CHUNK_SIZE == chunk_size_) check_chunk_fin();
+    }
+}
+
+
+void
+RecordSetOutBase::check_chunk_fin ()
+{
+    uint64_t const digest(htog64(chunk_.gather8()));
+    check_.append (&digest, sizeof(digest));
+
+    chunk_      = Hash();
+    chunk_size_ = 0;
+}
+
+
 static inline RecordSet::Version
 header_version (const byte_t* buf, ssize_t const size)
 {
@@ -427,6 +463,8 @@ header_check_type(RecordSet::Version const ver,
             return RecordSet::CHECK_MMH32;
         case RecordSet::CHECK_MMH64:  return RecordSet::CHECK_MMH64;
         case RecordSet::CHECK_MMH128: return RecordSet::CHECK_MMH128;
+        case RecordSet::CHECK_MMH128_TREE:
+            return RecordSet::CHECK_MMH128_TREE;
         }
 
         gu_throw_error (EPROTO) << "Unsupported RecordSet checksum type: " << ct;
@@ -527,7 +565,7 @@ RecordSetInBase::parse_header_v1_2 (size_t const size)
 }
 
 
-/* returns false if checksum matched and true if failed */
+/* throws if checksum fails */
 void
 RecordSetInBase::checksum() const
 {
@@ -537,22 +575,76 @@ RecordSetInBase::checksum() const
     {
         Hash check;
 
-        check.append (head_ + begin_, serial_size() - begin_); /* records */
-        check.append (head_, begin_ - cs);                     /* header  */
+        if (gu_likely(check_type() != CHECK_MMH128_TREE))
+        {
+            check.append (head_ + begin_, serial_size() - begin_); /*records*/
+        }
+        else
+        {
+            for (int i(0), n(check_chunks()); i < n; ++i)
+            {
+                uint64_t const digest(checksum_chunk(i));
+                check.append (&digest, sizeof(digest));
+            }
+        }
+
+        checksum_fin (check);
+    }
+}
+
+int
+RecordSetInBase::check_chunks() const
+{
+    if (check_type() != CHECK_MMH128_TREE) return 0;
 
-        assert(cs <= MAX_CHECKSUM_SIZE);
-        byte_t result[MAX_CHECKSUM_SIZE];
-        check.gather<sizeof(result)>(result);
+    return (serial_size() - begin_ + CHECK_CHUNK_SIZE - 1) / CHECK_CHUNK_SIZE;
+}
 
-        const byte_t* const stored_checksum(head_ + begin_ - cs);
+uint64_t
+RecordSetInBase::checksum_chunk(int const i) const
+{
+    assert(i >= 0 && i < check_chunks());
 
-        if (gu_unlikely(memcmp (result, stored_checksum, cs)))
-        {
-            gu_throw_error(EINVAL)
-                << "RecordSet checksum does not match:"
-                << "\ncomputed: " << gu::Hexdump(result, cs)
-                << "\nfound:    " << gu::Hexdump(stored_checksum, cs);
-        }
+    size_t const off(begin_ + i * CHECK_CHUNK_SIZE);
+    size_t const left(serial_size() - off);
+
+    Hash chunk;
+    chunk.append (head_ + off, left < CHECK_CHUNK_SIZE ?
+                  left : size_t(CHECK_CHUNK_SIZE));
+
+    return htog64(chunk.gather8());
+}
+
+void
+RecordSetInBase::checksum(const uint64_t* const digests) const
+{
+    assert(CHECK_MMH128_TREE == check_type());
+
+    Hash check;
+    check.append (digests, check_chunks() * sizeof(uint64_t));
+
+    checksum_fin (check);
+}
+
+void
+RecordSetInBase::checksum_fin(Hash& check) const
+{
+    int const cs(check_size(check_type()));
+
+    check.append (head_, begin_ - cs);                         /* header  */
+
+    assert(cs <= MAX_CHECKSUM_SIZE);
+    byte_t result[MAX_CHECKSUM_SIZE];
+    check.gather<sizeof(result)>(result);
+
+    const byte_t* const stored_checksum(head_ + begin_ - cs);
+
+    if (gu_unlikely(memcmp (result, stored_checksum, cs)))
+    {
+        gu_throw_error(EINVAL)
+            << "RecordSet checksum does not match:"
+            << "\ncomputed: " << gu::Hexdump(result, cs)
+            << "\nfound:    " << gu::Hexdump(stored_checksum, cs);
     }
 }
 
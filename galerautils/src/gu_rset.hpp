@@ -46,11 +46,16 @@ public:
         CHECK_NONE   = 0,
         CHECK_MMH32,
         CHECK_MMH64,
-        CHECK_MMH128
+        CHECK_MMH128,
+        CHECK_MMH128_TREE /* MMH128 of 64-bit MMH128 digests of each
+                           * CHECK_CHUNK_SIZE chunk of records, so that
+                           * the chunks can be checksummed in parallel */
     };
 
     static int check_size(CheckType ct);
 
+    static size_t const CHECK_CHUNK_SIZE = 1 << 20;
+
     /*! return net, payload size of a RecordSet */
     size_t size() const  { return size_; }
 
@@ -120,7 +125,7 @@ public:
 
 protected:
 
-    RecordSetOutBase() : RecordSet() {}
+    RecordSetOutBase() : RecordSet(), chunk_size_(0) {}
 
     RecordSetOutBase (byte_t*           reserved,
                       size_t            reserved_size,
@@ -214,7 +219,9 @@ private:
     ssize_t const max_size_;
 #endif
     Allocator     alloc_;
-    Hash          check_;
+    Hash          check_;       /* chunk digests in CHECK_MMH128_TREE */
+    Hash          chunk_;       /* current chunk in CHECK_MMH128_TREE */
+    size_t        chunk_size_;
     Vector<Buf, Allocator::INITIAL_VECTOR_SIZE> bufs_;
     bool          prev_stored_;
 
@@ -252,10 +259,17 @@ private:
                  const byte_t* const ptr,
                  ssize_t const       size)
     {
-        check_.append (ptr, size);
+        if (gu_likely(check_type() != CHECK_MMH128_TREE))
+            check_.append (ptr, size);
+        else
+            check_append_tree (ptr, size);
+
         post_alloc (new_page, ptr, size);
     }
 
+    void check_append_tree (const byte_t* ptr, size_t size);
+    void check_chunk_fin   ();
+
 
     int header_size     () const;
     int header_size_max () const;
@@ -361,6 +375,20 @@ public:
 
     void checksum() const; // throws if checksum fails
 
+    /* CHECK_MMH128_TREE checksum can be computed in parallel:
+     * checksum_chunk() for each of check_chunks() chunks in any order and
+     * then checksum(digests) to verify the result. */
+
+    /*! number of independently checksummed chunks, 0 if not supported */
+    int check_chunks() const;
+
+    /*! returns digest of the chunk i */
+    uint64_t checksum_chunk(int i) const;
+
+    /*! verifies checksum given check_chunks() chunk digests,
+     *  throws if checksum fails */
+    void checksum(const uint64_t* digests) const;
+
     uint64_t get_checksum() const;
 
     gu::Buf buf() const
@@ -427,6 +455,9 @@ private:
     /* takes total size of the supplied buffer */
     void parse_header_v1_2 (size_t size);
 
+    /* appends header to records checksum and compares the result */
+    void checksum_fin (Hash& check) const;
+
     enum Error
     {
         E_PERM,
@@ -26,6 +26,12 @@ typedef pthread_t             gu_thread_t_SYS;
 #define gu_thread_self_SYS    pthread_self
 #define gu_thread_equal_SYS   pthread_equal
 
+typedef pthread_key_t             gu_thread_key_t_SYS;
+#define gu_thread_key_create_SYS  pthread_key_create
+#define gu_thread_key_delete_SYS  pthread_key_delete
+#define gu_thread_getspecific_SYS pthread_getspecific
+#define gu_thread_setspecific_SYS pthread_setspecific
+
 #define GU_THREAD_INITIALIZER_SYS 0
 
 typedef pthread_mutexattr_t   gu_mutexattr_t_SYS;
@@ -200,6 +206,12 @@ typedef gu_thread_t_SYS   gu_thread_t;
 #define gu_thread_self    gu_thread_self_SYS
 #define gu_thread_equal   gu_thread_equal_SYS
 
+typedef gu_thread_key_t_SYS   gu_thread_key_t;
+#define gu_thread_key_create  gu_thread_key_create_SYS
+#define gu_thread_key_delete  gu_thread_key_delete_SYS
+#define gu_thread_getspecific gu_thread_getspecific_SYS
+#define gu_thread_setspecific gu_thread_setspecific_SYS
+
 typedef gu_condattr_t_SYS gu_condattr_t;
 typedef gu_cond_t_SYS     gu_cond_t;
 #define gu_cond_init      gu_cond_init_SYS
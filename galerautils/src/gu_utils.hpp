@@ -36,7 +36,7 @@ inline std::string to_string(const T& x,
 /*! Specialized template: make bool translate into 'true' or 'false' */
 template <>
 inline std::string to_string<bool>(const bool& x,
-                                   std::ios_base& (*f)(std::ios_base&))
+                                   std::ios_base& (*)(std::ios_base&))
 {
     std::ostringstream out;
     out << std::boolalpha << x;
@@ -46,7 +46,7 @@ inline std::string to_string<bool>(const bool& x,
 /*! Specialized template: make double to print with full precision */
 template <>
 inline std::string to_string<double>(const double& x,
-                                     std::ios_base& (*f)(std::ios_base&))
+                                     std::ios_base& (*)(std::ios_base&))
 {
     const int sigdigits = std::numeric_limits<double>::digits10;
     // or perhaps std::numeric_limits<double>::max_digits10?
@@ -79,7 +79,7 @@ from_string(const std::string& s,
  *  NotFound in case of empty string. */
 template <> inline std::string
 from_string<std::string>(const std::string& s,
-                         std::ios_base& (*f)(std::ios_base&))
+                         std::ios_base& (*)(std::ios_base&))
 {
     return s;
 }
@@ -88,7 +88,7 @@ from_string<std::string>(const std::string& s,
  * @throws NotFound */
 template <> inline void*
 from_string<void*>(const std::string& s,
-                   std::ios_base& (*f)(std::ios_base&))
+                   std::ios_base& (*)(std::ios_base&))
 {
     std::istringstream iss(s);
     void*              ret;
@@ -104,7 +104,7 @@ extern "C" const char* gu_str2bool (const char* str, bool* bl);
  * @throws NotFound */
 template <> inline bool
 from_string<bool> (const std::string& s,
-                   std::ios_base& (*f)(std::ios_base&))
+                   std::ios_base& (*)(std::ios_base&))
 {
     bool ret;
     const char* const str(s.c_str());
@@ -87,6 +87,10 @@ START_TEST (gu_lock_step_test)
                   "Expected LS.wait to be 0, found: %ld", LS.wait);
 
     gu_lock_step_destroy (&LS);
+
+    // destroying lock-step which was never enabled should not block
+    gu_lock_step_init    (&LS);
+    gu_lock_step_destroy (&LS);
 }
 END_TEST
 
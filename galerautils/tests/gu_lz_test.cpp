@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "../src/gu_lz.hpp"
+#include "../src/gu_exception.hpp"
+
+#include "gu_lz_test.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static size_t
+roundtrip(const std::vector<unsigned char>& src)
+{
+    std::vector<unsigned char> z(gu::lz::bound(src.size()));
+    size_t const zlen(gu::lz::compress(src.empty() ? NULL : &src[0],
+                                       src.size(), &z[0]));
+    ck_assert(zlen <= z.size());
+
+    std::vector<unsigned char> out(src.size() + 1);
+    gu::lz::decompress(&z[0], zlen, &out[0], src.size());
+    ck_assert(0 == ::memcmp(src.empty() ? NULL : &src[0], &out[0],
+                            src.size()));
+
+    return zlen;
+}
+
+START_TEST(test_lz_roundtrip)
+{
+    std::vector<unsigned char> buf;
+
+    roundtrip(buf);
+
+    for (size_t i(0); i < 7; ++i) // shorter than minimal match
+    {
+        buf.push_back('a' + i);
+        roundtrip(buf);
+    }
+
+    // runs: overlapping matches
+    buf.assign(100000, 'x');
+    ck_assert(roundtrip(buf) < 1000);
+
+    // random: incompressible
+    for (size_t i(0); i < buf.size(); ++i) buf[i] = ::rand();
+    ck_assert(roundtrip(buf) <= gu::lz::bound(buf.size()));
+
+    // repeating records with varying fields, like row images
+    buf.clear();
+    for (int i(0); i < 10000; ++i)
+    {
+        char rec[64];
+        int const len(::snprintf(rec, sizeof(rec),
+                                 "id=%08d,name=user%d,status=active;", i, i%97));
+        buf.insert(buf.end(), rec, rec + len);
+    }
+    ck_assert(roundtrip(buf) < buf.size() / 2);
+}
+END_TEST
+
+START_TEST(test_lz_malformed)
+{
+    std::vector<unsigned char> src(10000);
+    for (size_t i(0); i < src.size(); ++i) src[i] = i % 251;
+
+    std::vector<unsigned char> z(gu::lz::bound(src.size()));
+    size_t const zlen(gu::lz::compress(&src[0], src.size(), &z[0]));
+    std::vector<unsigned char> out(src.size());
+
+    // truncated
+    try
+    {
+        gu::lz::decompress(&z[0], zlen - 1, &out[0], out.size());
+        ck_abort_msg("truncated block decompressed");
+    }
+    catch (gu::Exception& e)
+    {
+        ck_assert(e.get_errno() == EINVAL);
+    }
+
+    // wrong size
+    try
+    {
+        gu::lz::decompress(&z[0], zlen, &out[0], out.size() - 1);
+        ck_abort_msg("block decompressed into short buffer");
+    }
+    catch (gu::Exception& e)
+    {
+        ck_assert(e.get_errno() == EINVAL);
+    }
+
+    // garbage must not overrun the output
+    for (int i(0); i < 1000; ++i)
+    {
+        for (size_t j(0); j < 64; ++j) z[j] = ::rand();
+        try { gu::lz::decompress(&z[0], 64, &out[0], 256); }
+        catch (gu::Exception& e) { ck_assert(e.get_errno() == EINVAL); }
+    }
+}
+END_TEST
+
+Suite* gu_lz_suite()
+{
+    Suite* s = suite_create ("gu::lz");
+
+    TCase* t = tcase_create ("test_lz_roundtrip");
+    tcase_add_test (t, test_lz_roundtrip);
+    suite_add_tcase (s, t);
+
+    t = tcase_create ("test_lz_malformed");
+    tcase_add_test (t, test_lz_malformed);
+    suite_add_tcase (s, t);
+
+    return s;
+}
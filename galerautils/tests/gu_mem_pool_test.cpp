@@ -5,9 +5,13 @@
 #define TEST_SIZE 1024
 
 #include "gu_mem_pool.hpp"
+#include "gu_threads.h"
 
 #include "gu_mem_pool_test.hpp"
 
+#include <sstream>
+#include <vector>
+
 START_TEST (unsafe)
 {
     gu::MemPoolUnsafe mp(10, 1, "unsafe");
@@ -56,6 +60,77 @@ START_TEST (safe)
 }
 END_TEST
 
+struct mem_pool_thd_args
+{
+    gu::MemPoolSafe& mp_;
+    long             errors_;
+
+    mem_pool_thd_args(gu::MemPoolSafe& mp) : mp_(mp), errors_(0) {}
+};
+
+/* acquires buffers in batches of varying size, marks them as owned by
+ * this thread and checks that nobody else touched them before recycling */
+extern "C" void* mem_pool_thd(void* arg)
+{
+    mem_pool_thd_args* const args(static_cast<mem_pool_thd_args*>(arg));
+    std::vector<long*> bufs;
+
+    for (int i(0); i < 10000; ++i)
+    {
+        size_t const n(1 + i % (3 * gu::MemPoolSafe::CACHE_SIZE));
+
+        for (size_t j(0); j < n; ++j)
+        {
+            long* const buf(static_cast<long*>(args->mp_.acquire()));
+            *buf = long(&bufs);
+            bufs.push_back(buf);
+        }
+
+        for (size_t j(0); j < bufs.size(); ++j)
+        {
+            if (*bufs[j] != long(&bufs)) ++args->errors_;
+            args->mp_.recycle(bufs[j]);
+        }
+
+        bufs.clear();
+    }
+
+    return NULL;
+}
+
+START_TEST (safe_threads)
+{
+    gu::MemPoolSafe mp(sizeof(long), 16, "safe_threads");
+
+    std::vector<mem_pool_thd_args*> args;
+    std::vector<gu_thread_t> thds(8);
+
+    for (size_t i(0); i < thds.size(); ++i)
+    {
+        args.push_back(new mem_pool_thd_args(mp));
+        ck_assert(0 == gu_thread_create(&thds[i], NULL, mem_pool_thd,
+                                        args.back()));
+    }
+
+    for (size_t i(0); i < thds.size(); ++i)
+    {
+        gu_thread_join(thds[i], NULL);
+        ck_assert(0 == args[i]->errors_);
+        delete args[i];
+    }
+
+    log_info << mp;
+
+    /* exited threads must have returned their caches */
+    std::ostringstream os;
+    os << mp;
+    ck_assert_msg(os.str().find("in use: 0,") != std::string::npos,
+                  "%s", os.str().c_str());
+    ck_assert_msg(os.str().find("thread caches: 0") != std::string::npos,
+                  "%s", os.str().c_str());
+}
+END_TEST
+
 Suite *gu_mem_pool_suite(void)
 {
     Suite *s = suite_create("gu::MemPool");
@@ -64,6 +139,7 @@ Suite *gu_mem_pool_suite(void)
     suite_add_tcase (s, tc_mem);
     tcase_add_test(tc_mem, unsafe);
     tcase_add_test(tc_mem, safe);
+    tcase_add_test(tc_mem, safe_threads);
 
     return s;
 }
@@ -589,6 +589,72 @@ START_TEST (ver2_sizes)
 }
 END_TEST
 
+START_TEST (ver2_tree)
+{
+    typedef std::vector<gu::byte_t> record_t;
+    size_t const rec_size(3001);
+    record_t data(1000 * rec_size);
+    for (size_t i(0); i < data.size(); ++i) data[i] = i % 251;
+
+    TestBaseName name("gu_rset_test_ver2_tree");
+    gu::RecordSetOut<record_t> rso(NULL, 0, name,
+                                   gu::RecordSet::CHECK_MMH128_TREE,
+                                   gu::RecordSet::VER2);
+    for (size_t off(0); off < data.size(); off += rec_size)
+    {
+        /* mix stored and referenced records */
+        rso.append(&data[off], rec_size, (off / rec_size) % 2);
+    }
+
+    gu::RecordSet::GatherVector out;
+    size_t const out_size(rso.gather(out));
+
+    std::vector<gu::byte_t> in_buf;
+    in_buf.reserve(out_size);
+    for (size_t i(0); i < out->size(); ++i)
+    {
+        const gu::byte_t* ptr(static_cast<const gu::byte_t*>(out[i].ptr));
+        in_buf.insert (in_buf.end(), ptr, ptr + out[i].size);
+    }
+
+    gu::RecordSetIn<uint64_t> rsi(in_buf.data(), in_buf.size(), false);
+    ck_assert(rsi.check_type() == gu::RecordSet::CHECK_MMH128_TREE);
+
+    int const chunks(rsi.check_chunks());
+    ck_assert_msg(chunks == 3, "Expected 3 chunks, got %d", chunks);
+
+    rsi.checksum();
+
+    /* chunks can be checksummed in any order */
+    std::vector<uint64_t> digests(chunks);
+    for (int i(chunks - 1); i >= 0; --i) digests[i] = rsi.checksum_chunk(i);
+    rsi.checksum(digests.data());
+
+    std::swap(digests[0], digests[1]);
+    try
+    {
+        rsi.checksum(digests.data());
+        ck_abort_msg("reordered chunk digests were accepted");
+    }
+    catch (gu::Exception& e)
+    {
+        ck_assert(EINVAL == e.get_errno());
+    }
+
+    /* corrupt the middle of the second chunk */
+    in_buf[in_buf.size() / 2] ^= 1;
+    try
+    {
+        rsi.checksum();
+        ck_abort_msg("corrupted record set passed checksum");
+    }
+    catch (gu::Exception& e)
+    {
+        ck_assert(EINVAL == e.get_errno());
+    }
+}
+END_TEST
+
 Suite* gu_rset_suite ()
 {
     Suite* s(suite_create("gu::RecordSet"));
@@ -605,6 +671,7 @@ Suite* gu_rset_suite ()
     tcase_add_test (t, ver2);
     tcase_add_test (t, ver2_padding);
     tcase_add_test (t, ver2_sizes);
+    tcase_add_test (t, ver2_tree);
     suite_add_tcase (s, t);
 //    tcase_set_timeout(t, 60);
 
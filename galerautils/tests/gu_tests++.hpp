@@ -24,6 +24,7 @@
 #include "gu_net_test.hpp"
 #include "gu_datetime_test.hpp"
 #include "gu_histogram_test.hpp"
+#include "gu_lz_test.hpp"
 #include "gu_stats_test.hpp"
 #include "gu_thread_test.hpp"
 #include "gu_asio_test.hpp"
@@ -47,6 +48,7 @@ static suite_creator_t suites[] =
     gu_net_suite,
     gu_datetime_suite,
     gu_histogram_suite,
+    gu_lz_suite,
     gu_stats_suite,
     gu_thread_suite,
     gu_asio_suite,
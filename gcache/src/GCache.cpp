@@ -45,11 +45,12 @@ namespace gcache
 #else
         mtx       (),
 #endif /* HAVE_PSI_INTERFACE */
+        seqno_mtx (),
         seqno2ptr (SEQNO_NONE),
         gid       (),
-        mem       (params.mem_size(), seqno2ptr, params.debug()),
-        rb        (params.rb_name(), params.rb_size(), seqno2ptr, gid,
-                   params.debug(), params.recover()),
+        mem       (params.mem_size(), seqno2ptr, seqno_mtx, params.debug()),
+        rb        (params.rb_name(), params.rb_size(), seqno2ptr, seqno_mtx,
+                   gid, params.debug(), params.recover()),
         ps        (params.dir_name(),
                    params.keep_pages_size(),
                    params.page_size(),
@@ -77,7 +77,7 @@ namespace gcache
          */
         seqno_t seqno_min() const
         {
-            gu::Lock lock(mtx);
+            gu::Lock lock(seqno_mtx);
             if (gu_likely(!seqno2ptr.empty()))
                 return seqno2ptr.index_begin();
             else
@@ -242,11 +242,19 @@ namespace gcache
         }
             params;
 
+        /*
+         * Lock hierarchy: mtx protects the stores and allocation counters,
+         * seqno_mtx protects seqno2ptr map, seqno_* members below and seqno
+         * fields of the buffer headers. When both are needed, mtx must be
+         * locked first. Stores lock seqno_mtx on their own when allocation
+         * has to discard released buffers.
+         */
 #ifdef HAVE_PSI_INTERFACE
         gu::MutexWithPFS mtx;
 #else
         gu::Mutex       mtx;
 #endif /* HAVE_PSI_INTERFACE */
+        gu::Mutex       seqno_mtx;
         seqno2ptr_t     seqno2ptr;
         gu::UUID        gid;
 
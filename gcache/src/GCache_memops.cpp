@@ -135,9 +135,12 @@ namespace gcache
         assert(bh->seqno_g != SEQNO_ILL);
         BH_release(bh);
 
-        seqno_t new_released(seqno_released);
+        /* seqno_released may be touched only if seqno_mtx is locked, which
+         * is required for ordered buffers only */
+        bool const ordered(SEQNO_NONE != bh->seqno_g);
+        seqno_t new_released(SEQNO_NONE);
 
-        if (gu_likely(SEQNO_NONE != bh->seqno_g))
+        if (gu_likely(ordered))
         {
 #ifndef NDEBUG
             if (!(seqno_released + 1 == bh->seqno_g ||
@@ -186,7 +189,7 @@ namespace gcache
         }
         rb.assert_size_free();
 
-        seqno_released = new_released;
+        if (ordered) seqno_released = new_released;
     }
 
     void
@@ -199,6 +202,16 @@ namespace gcache
 
 #ifndef NDEBUG
             if (params.debug()) { log_info << "GCache::free() " << bh; }
+#endif
+            if (SEQNO_NONE == bh->seqno_g)
+            {
+                /* unordered buffer, seqno2ptr map is not involved */
+                free_common (bh);
+                return;
+            }
+
+            gu::Lock      index_lock(seqno_mtx);
+#ifndef NDEBUG
             seqno_t const old_sr(seqno_released);
 #endif
             free_common (bh);
@@ -20,6 +20,7 @@ namespace gcache
     GCache::seqno_reset (const gu::UUID& g, seqno_t const s)
     {
         gu::Lock lock(mtx);
+        gu::Lock index_lock(seqno_mtx);
 
         assert(seqno2ptr.empty() || seqno_max == seqno2ptr.index_back());
 
@@ -57,7 +58,8 @@ namespace gcache
                           seqno_t     const seqno_g,
                           seqno_t     const seqno_d)
     {
-        gu::Lock lock(mtx);
+        /* buffer is already allocated, so stores are not involved */
+        gu::Lock lock(seqno_mtx);
 
         BufferHeader* bh = ptr2BH(ptr);
 
@@ -127,6 +129,7 @@ namespace gcache
             if (loop) sched_yield();
 
             gu::Lock lock(mtx);
+            gu::Lock index_lock(seqno_mtx);
 
             if (seqno < seqno_released || seqno >= seqno_locked)
             {
@@ -235,7 +238,7 @@ namespace gcache
      */
     void GCache::seqno_lock (seqno_t const seqno_g)
     {
-        gu::Lock lock(mtx);
+        gu::Lock lock(seqno_mtx);
 
         assert(seqno_g > 0);
 
@@ -261,7 +264,7 @@ namespace gcache
         const void* ptr;
 
         {
-            gu::Lock lock(mtx);
+            gu::Lock lock(seqno_mtx);
             ptr = seqno2ptr.at(seqno_g);
         }
 
@@ -285,7 +288,7 @@ namespace gcache
         size_t found(0);
 
         {
-            gu::Lock lock(mtx);
+            gu::Lock lock(seqno_mtx);
 
             assert(seqno_locked <= start);
             // the caller should have locked the range first
@@ -325,7 +328,7 @@ namespace gcache
      */
     void GCache::seqno_unlock ()
     {
-        gu::Lock lock(mtx);
+        gu::Lock lock(seqno_mtx);
 
         if (seqno_locked_count > 0)
         {
@@ -14,6 +14,11 @@ namespace gcache
 bool
 MemStore::have_free_space (size_type size)
 {
+    if (size_ <= max_size_ - size) return true;
+
+    /* discarding buffers modifies seqno2ptr map */
+    gu::Lock lock(seqno_mtx_);
+
     while ((size_ > max_size_ - size) && !seqno2ptr_.empty())
     {
         /* try to free some released bufs */
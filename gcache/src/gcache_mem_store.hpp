@@ -12,6 +12,8 @@
 #include "gcache_types.hpp"
 #include "gcache_limits.hpp"
 
+#include <gu_lock.hpp>
+
 #include <string>
 #include <set>
 
@@ -21,11 +23,15 @@ namespace gcache
     {
     public:
 
-        MemStore (size_t const max_size, seqno2ptr_t& seqno2ptr, int const dbg)
+        MemStore (size_t const max_size,
+                  seqno2ptr_t& seqno2ptr,
+                  gu::Mutex&   seqno_mtx,
+                  int const    dbg)
             : max_size_ (max_size),
               size_     (0),
               allocd_   (),
               seqno2ptr_(seqno2ptr),
+              seqno_mtx_(seqno_mtx),
               debug_    (dbg & DEBUG)
         {}
 
@@ -150,6 +156,7 @@ namespace gcache
         size_t          size_;
         std::set<void*> allocd_;
         seqno2ptr_t&    seqno2ptr_;
+        gu::Mutex&      seqno_mtx_;
         int             debug_;
     };
 }
@@ -170,8 +170,9 @@ gcache::GCache::param_set (const std::string& key, const std::string& val)
         seqno_t seqno = -1;
 
         gu::Lock lock(mtx);
+        gu::Lock index_lock(seqno_mtx);
         /* locking here serves two purposes: ensures atomic setting of config
-         * and params. */
+         * and params. Purge freeze is checked with both locks held. */
 
         if (val.compare("now") == 0)
             seqno = (seqno2ptr.empty() ? 1 : seqno2ptr.index_begin());
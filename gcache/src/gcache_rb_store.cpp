@@ -46,6 +46,7 @@ namespace gcache
     RingBuffer::RingBuffer (const std::string& name,
                             size_t             size,
                             seqno2ptr_t&       seqno2ptr,
+                            gu::Mutex&         seqno_mtx,
                             gu::UUID&          gid,
                             int const          dbg,
                             bool const         recover)
@@ -65,6 +66,7 @@ namespace gcache
         max_used_  (first_ - static_cast<uint8_t*>(mmap_.ptr) +
                     sizeof(BufferHeader)),
         seqno2ptr_ (seqno2ptr),
+        seqno_mtx_ (seqno_mtx),
         gid_       (gid),
         freeze_purge_at_seqno_(SEQNO_ILL),
         size_cache_(end_ - start_ - sizeof(BufferHeader)),
@@ -12,6 +12,7 @@
 #include "gcache_types.hpp"
 
 #include <gu_fdesc.hpp>
+#include <gu_lock.hpp>
 #include <gu_mmap.hpp>
 #include <gu_uuid.hpp>
 
@@ -26,6 +27,7 @@ namespace gcache
         RingBuffer (const std::string& name,
                     size_t             size,
                     seqno2ptr_t&       seqno2ptr,
+                    gu::Mutex&         seqno_mtx,
                     gu::UUID&          gid,
                     int                dbg,
                     bool               recover);
@@ -60,9 +62,11 @@ namespace gcache
         bool  discard_seqnos(seqno2ptr_t::iterator i_begin,
                              seqno2ptr_t::iterator i_end);
 
-        /* returns true when successfully discards all seqnos up to s */
+        /* returns true when successfully discards all seqnos up to s,
+         * locks seqno2ptr map for the duration */
         bool  discard_seqno(seqno_t s)
         {
+            gu::Lock lock(seqno_mtx_);
             return discard_seqnos(seqno2ptr_.begin(), seqno2ptr_.find(s + 1));
         }
 
@@ -157,6 +161,7 @@ namespace gcache
 
         size_t            max_used_; // maximal memory usage (in bytes)
         seqno2ptr_t&       seqno2ptr_;
+        gu::Mutex&         seqno_mtx_;
         gu::UUID&          gid_;
 
         seqno_t            freeze_purge_at_seqno_;
@@ -16,7 +16,8 @@ START_TEST(test1)
     ssize_t const mem_size (3 + 2*bh_size);
 
     seqno2ptr_t s2p(SEQNO_NONE);
-    MemStore ms(mem_size, s2p, 0);
+    gu::Mutex   s2p_mtx;
+    MemStore ms(mem_size, s2p, s2p_mtx, 0);
 
     void* buf1 = ms.malloc (1 + bh_size);
     ck_assert(NULL != buf1);
@@ -33,8 +33,9 @@ START_TEST(test1)
     size_t const rb_size(ALLOC_SIZE(2) * 2);
 
     seqno2ptr_t s2p(SEQNO_NONE);
+    gu::Mutex  s2p_mtx;
     gu::UUID   gid(GID);
-    RingBuffer rb(RB_NAME, rb_size, s2p, gid, 0, false);
+    RingBuffer rb(RB_NAME, rb_size, s2p, s2p_mtx, gid, 0, false);
 
     ck_assert_msg(rb.size() == rb_size,
                   "Expected %zd, got %zd", rb_size, rb.size());
@@ -153,12 +154,13 @@ START_TEST(recovery)
     {
         size_t const size;
         seqno2ptr_t  s2p;
+        gu::Mutex    s2p_mtx;
         gu::UUID     gid;
         RingBuffer   rb;
 
         rb_ctx(size_t s, bool recover = true) :
-            size(s), s2p(SEQNO_NONE), gid(GID),
-            rb(RB_NAME, size, s2p, gid, 0, recover)
+            size(s), s2p(SEQNO_NONE), s2p_mtx(), gid(GID),
+            rb(RB_NAME, size, s2p, s2p_mtx, gid, 0, recover)
         {}
 
         void seqno_assign (seqno2ptr_t& s2p, void* const ptr,
@@ -18,6 +18,7 @@
 #include <boost/bind.hpp>
 
 #include <fstream>
+#include <cstring>
 
 
 gcomm::AsioProtonet::AsioProtonet(gu::Config& conf, int version)
@@ -31,7 +32,20 @@ gcomm::AsioProtonet::AsioProtonet(gu::Config& conf, int version)
     mtu_(1 << 15),
     checksum_(NetHeader::checksum_type(
                   conf.get<int>(gcomm::Conf::SocketChecksum,
-                                NetHeader::CS_CRC32C)))
+                                NetHeader::CS_CRC32C))),
+    io_mutex_(),
+    io_cond_(),
+    io_done_(),
+    io_threads_(),
+    n_io_threads_(check_range<int>(gcomm::Conf::SocketIoThreads,
+                                   conf.get(gcomm::Conf::SocketIoThreads),
+                                   1, 257)),
+    io_round_(0),
+    io_active_(0),
+    io_running_(false),
+    io_exit_(false),
+    io_errno_(0),
+    io_error_()
 {
     conf.set(gcomm::Conf::SocketChecksum, checksum_);
     // use ssl if either private key or cert file is specified
@@ -54,7 +68,7 @@ gcomm::AsioProtonet::AsioProtonet(gu::Config& conf, int version)
 
 gcomm::AsioProtonet::~AsioProtonet()
 {
-
+    stop_io_threads();
 }
 
 void gcomm::AsioProtonet::enter()
@@ -113,7 +127,147 @@ void gcomm::AsioProtonet::event_loop(const gu::datetime::Period& period)
     timer_.expires_from_now(boost::posix_time::nanosec(p.get_nsecs()));
     timer_.async_wait(boost::bind(&AsioProtonet::handle_wait, this,
                                   asio::placeholders::error));
-    io_service_.run();
+
+    if (n_io_threads_ == 1)
+    {
+        io_service_.run();
+        return;
+    }
+
+    {
+        gu::Lock lock(io_mutex_);
+        start_io_threads();
+        ++io_round_;
+        io_running_ = true;
+        io_cond_.broadcast();
+    }
+
+    try
+    {
+        io_service_.run();
+    }
+    catch (...)
+    {
+        io_service_.stop();
+        gu::Lock lock(io_mutex_);
+        io_running_ = false;
+        while (io_active_ > 0) lock.wait(io_done_);
+        throw;
+    }
+
+    int err;
+    std::string msg;
+    {
+        // io_service_ can be reset only after all threads have left run()
+        gu::Lock lock(io_mutex_);
+        io_running_ = false;
+        while (io_active_ > 0) lock.wait(io_done_);
+        err = io_errno_;
+        msg.swap(io_error_);
+        io_errno_ = 0;
+    }
+
+    if (gu_unlikely(err != 0))
+    {
+        gu_throw_error(err) << msg;
+    }
+}
+
+void gcomm::AsioProtonet::start_io_threads()
+{
+    while (io_threads_.size() < n_io_threads_ - 1)
+    {
+        gu_thread_t thd;
+        int const err(gu_thread_create(&thd, NULL, io_thread_func, this));
+
+        if (gu_unlikely(err != 0))
+        {
+            log_warn << "Starting I/O thread failed: " << err
+                     << " (" << ::strerror(err) << "), continuing with "
+                     << (io_threads_.size() + 1) << " I/O threads";
+            n_io_threads_ = io_threads_.size() + 1;
+            break;
+        }
+
+        io_threads_.push_back(thd);
+    }
+}
+
+void gcomm::AsioProtonet::stop_io_threads()
+{
+    {
+        gu::Lock lock(io_mutex_);
+        io_exit_ = true;
+        io_cond_.broadcast();
+    }
+
+    for (size_t i(0); i < io_threads_.size(); ++i)
+    {
+        gu_thread_join(io_threads_[i], NULL);
+    }
+
+    io_threads_.clear();
+}
+
+void gcomm::AsioProtonet::run_io_thread()
+{
+    long long round(0);
+
+    while (true)
+    {
+        {
+            gu::Lock lock(io_mutex_);
+
+            while (!io_exit_ && (!io_running_ || round == io_round_))
+            {
+                lock.wait(io_cond_);
+            }
+
+            if (io_exit_) break;
+
+            round = io_round_;
+            ++io_active_;
+        }
+
+        try
+        {
+            io_service_.run();
+        }
+        // rethrown from event_loop() in the caller thread
+        catch (gu::Exception& e)
+        {
+            set_io_error(e.get_errno() ? e.get_errno() : EPROTO, e.what());
+        }
+        catch (std::exception& e)
+        {
+            set_io_error(EPROTO, e.what());
+        }
+        catch (...)
+        {
+            set_io_error(EPROTO, "unknown exception in I/O thread");
+        }
+
+        gu::Lock lock(io_mutex_);
+        --io_active_;
+        io_done_.broadcast();
+    }
+}
+
+void gcomm::AsioProtonet::set_io_error(int const err, const char* const what)
+{
+    gu::Lock lock(io_mutex_);
+    if (io_errno_ == 0)
+    {
+        io_errno_ = err;
+        io_error_ = what;
+    }
+    io_service_.stop();
+}
+
+void* gcomm::AsioProtonet::io_thread_func(void* arg)
+{
+    static_cast<AsioProtonet*>(arg)->run_io_thread();
+    return NULL;
 }
 
 
@@ -9,8 +9,11 @@
 #include "socket.hpp"
 
 #include "gu_monitor.hpp"
+#include "gu_lock.hpp"
 #include "gu_asio.hpp"
 
+#include <gu_threads.h>
+
 #include <vector>
 #include <deque>
 #include <list>
@@ -48,6 +51,15 @@ private:
 
     void handle_wait(const asio::error_code& ec);
 
+    // Additional I/O threads (socket.io_threads - 1) run io_service_
+    // together with the event_loop() caller. Handlers of a single socket
+    // are serialized by its strand, protocol processing by mutex_.
+    void  start_io_threads(); // must be called under io_mutex_
+    void  stop_io_threads();
+    void  run_io_thread();
+    void  set_io_error(int err, const char* what); // stops io_service_
+    static void* io_thread_func(void* arg);
+
     gu::RecursiveMutex          mutex_;
     gu::datetime::Date          poll_until_;
     asio::io_service            io_service_;
@@ -56,6 +68,18 @@ private:
     size_t                      mtu_;
 
     NetHeader::checksum_t       checksum_;
+
+    gu::Mutex                   io_mutex_;
+    gu::Cond                    io_cond_;     // round started or exit
+    gu::Cond                    io_done_;     // I/O thread left the round
+    std::vector<gu_thread_t>    io_threads_;
+    size_t                      n_io_threads_;
+    long long                   io_round_;    // event_loop() round number
+    size_t                      io_active_;   // threads running io_service_
+    bool                        io_running_;
+    bool                        io_exit_;
+    int                         io_errno_;    // exception from I/O thread
+    std::string                 io_error_;
 };
 
 #endif // GCOMM_ASIO_PROTONET_HPP
@@ -67,9 +67,14 @@ gcomm::AsioTcpSocket::AsioTcpSocket(AsioProtonet& net, const gu::URI& uri)
     :
     Socket       (uri),
     net_         (net),
+    strand_      (net.io_service_),
     socket_      (net.io_service_),
     ssl_socket_  (0),
     send_q_      (),
+    write_q_     (),
+    write_q_bytes_(0),
+    write_cbs_   (),
+    ssl_write_buf_(),
     last_queued_tstamp_(),
     recv_buf_    (net_.mtu() + NetHeader::serial_size_),
     recv_offset_ (0),
@@ -119,6 +124,8 @@ void gcomm::AsioTcpSocket::failed_handler(const asio::error_code& ec,
 
 void gcomm::AsioTcpSocket::handshake_handler(const asio::error_code& ec)
 {
+    Critical<AsioProtonet> crit(net_);
+
     if (ec)
     {
         if (ec.category() == asio::error::get_ssl_category() &&
@@ -181,9 +188,10 @@ void gcomm::AsioTcpSocket::connect_handler(const asio::error_code& ec)
                           << local_addr();
                 ssl_socket_->async_handshake(
                     asio::ssl::stream<asio::ip::tcp::socket>::client,
-                    boost::bind(&AsioTcpSocket::handshake_handler,
-                                shared_from_this(),
-                                asio::placeholders::error)
+                    strand_.wrap(
+                        boost::bind(&AsioTcpSocket::handshake_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error))
                     );
             }
             else
@@ -229,9 +237,10 @@ void gcomm::AsioTcpSocket::connect(const gu::URI& uri)
             ssl_socket_->lowest_layer().open(i->endpoint().protocol());
             set_buf_sizes(); // Must be done before connect
             ssl_socket_->lowest_layer().async_connect(
-                *i, boost::bind(&AsioTcpSocket::connect_handler,
+                *i, strand_.wrap(
+                    boost::bind(&AsioTcpSocket::connect_handler,
                                 shared_from_this(),
-                                asio::placeholders::error)
+                                asio::placeholders::error))
             );
         }
         else
@@ -245,9 +254,10 @@ void gcomm::AsioTcpSocket::connect(const gu::URI& uri)
                 socket_.bind(ep);
             }
             set_buf_sizes(); // Must be done before connect
-            socket_.async_connect(*i, boost::bind(&AsioTcpSocket::connect_handler,
+            socket_.async_connect(*i, strand_.wrap(
+                                      boost::bind(&AsioTcpSocket::connect_handler,
                                                   shared_from_this(),
-                                                  asio::placeholders::error));
+                                                  asio::placeholders::error)));
         }
         state_ = S_CONNECTING;
     }
@@ -271,9 +281,20 @@ void gcomm::AsioTcpSocket::close()
     log_debug << "closing " << id() << " state " << state()
               << " send_q size " << send_q_.size();
 
-    if (send_q_.empty() == true || state() != S_CONNECTED)
+    if ((send_q_.empty() == true && write_q_.empty() == true) ||
+        state() != S_CONNECTED)
     {
-        close_socket();
+        if (net_.n_io_threads_ > 1)
+        {
+            // SSL stream may be in use by a handler running in another
+            // I/O thread, shut it down in the socket strand
+            strand_.dispatch(boost::bind(&AsioTcpSocket::close_socket,
+                                         shared_from_this()));
+        }
+        else
+        {
+            close_socket();
+        }
         state_ = S_CLOSED;
     }
     else
@@ -290,8 +311,7 @@ void gcomm::AsioTcpSocket::write_handler(const asio::error_code& ec,
 {
 #ifdef GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
     static const long empty_rate(10000);
-    static const long bytes_transferred_less_than_rate(10000);
-    static const long bytes_transferred_not_zero_rate(10000);
+    static const long bytes_transferred_mismatch_rate(10000);
 #endif // GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
 
     Critical<AsioProtonet> crit(net_);
@@ -313,63 +333,39 @@ void gcomm::AsioTcpSocket::write_handler(const asio::error_code& ec,
 
     if (!ec)
     {
-        if (send_q_.empty() == true
+        if (write_q_.empty() == true
 #ifdef GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
             || ::rand() % empty_rate == 0
 #endif // GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
             )
         {
-            log_warn << "write_handler() called with empty send_q_. "
+            log_warn << "write_handler() called with empty write_q_. "
                      << "Transport may not be reliable, closing the socket";
             FAILED_HANDLER(asio::error_code(EPROTO,
                                             asio::error::system_category));
         }
-        else if (send_q_.front().len() < bytes_transferred
+        else if (write_q_bytes_ != bytes_transferred
 #ifdef GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
-                 || ::rand() % bytes_transferred_less_than_rate == 0
+                 || ::rand() % bytes_transferred_mismatch_rate == 0
 #endif // GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
             )
         {
             log_warn << "write_handler() bytes_transferred "
                      << bytes_transferred
-                     << " less than sent "
-                     << send_q_.front().len()
+                     << " differs from sent "
+                     << write_q_bytes_
                      << ". Transport may not be reliable, closing the socket";
             FAILED_HANDLER(asio::error_code(EPROTO,
                                             asio::error::system_category));
         }
         else
         {
-            while (send_q_.empty() == false &&
-                   bytes_transferred >= send_q_.front().len())
-            {
-                const Datagram& dg(send_q_.front());
-                bytes_transferred -= dg.len();
-                send_q_.pop_front();
-            }
-            if (bytes_transferred != 0
-#ifdef GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
-                || ::rand() % bytes_transferred_not_zero_rate == 0
-#endif // GCOMM_ASIO_TCP_SIMULATE_WRITE_HANDLER_ERROR
-                )
-            {
-                log_warn << "write_handler() bytes_transferred "
-                         << bytes_transferred
-                         << " after processing the send_q_. "
-                         << "Transport may not be reliable, closing the socket";
-                FAILED_HANDLER(asio::error_code(EPROTO,
-                                                asio::error::system_category));
-            }
-            else if (send_q_.empty() == false)
+            write_q_.clear();
+            write_q_bytes_ = 0;
+
+            if (send_q_.empty() == false)
             {
-                const Datagram& dg(send_q_.front());
-                gu::array<asio::const_buffer, 2>::type cbs;
-                cbs[0] = asio::const_buffer(dg.header()
-                                            + dg.header_offset(),
-                                            dg.header_len());
-                cbs[1] = asio::const_buffer(dg.payload().data(),
-                                            dg.payload().size());
-                write_one(cbs);
+                start_write();
             }
             else if (state_ == S_CLOSING)
             {
@@ -421,16 +417,10 @@ namespace gcomm
             // upper layers.
             if ((socket_->state() == gcomm::Socket::S_CONNECTED ||
                  socket_->state() == gcomm::Socket::S_CLOSING) &&
-                socket_->send_q_.empty() == false)
+                socket_->send_q_.empty() == false &&
+                socket_->write_q_.empty() == true)
             {
-                const gcomm::Datagram& dg(socket_->send_q_.front());
-                gu::array<asio::const_buffer, 2>::type cbs;
-                cbs[0] = asio::const_buffer(dg.header()
-                                            + dg.header_offset(),
-                                            dg.header_len());
-                cbs[1] = asio::const_buffer(dg.payload().data(),
-                                            dg.payload().size());
-                socket_->write_one(cbs);
+                socket_->start_write();
             }
         }
     private:
@@ -469,9 +459,11 @@ int gcomm::AsioTcpSocket::send(int segment, const Datagram& dg)
               priv_dg.header_size(),
               priv_dg.header_offset());
     send_q_.push_back(segment, priv_dg);
-    if (send_q_.size() == 1)
+    // Datagrams queued while a write is in progress are picked up
+    // by write_handler()
+    if (send_q_.size() == 1 && write_q_.empty() == true)
     {
-        net_.io_service_.post(AsioPostForSendHandler(shared_from_this()));
+        strand_.post(AsioPostForSendHandler(shared_from_this()));
     }
     return 0;
 }
@@ -673,10 +665,11 @@ void gcomm::AsioTcpSocket::read_one(
                                shared_from_this(),
                                asio::placeholders::error,
                                asio::placeholders::bytes_transferred),
-                   boost::bind(&AsioTcpSocket::read_handler,
-                               shared_from_this(),
-                               asio::placeholders::error,
-                               asio::placeholders::bytes_transferred));
+                   strand_.wrap(
+                       boost::bind(&AsioTcpSocket::read_handler,
+                                   shared_from_this(),
+                                   asio::placeholders::error,
+                                   asio::placeholders::bytes_transferred)));
     }
     else
     {
@@ -685,32 +678,89 @@ void gcomm::AsioTcpSocket::read_one(
                                shared_from_this(),
                                asio::placeholders::error,
                                asio::placeholders::bytes_transferred),
-                   boost::bind(&AsioTcpSocket::read_handler,
-                               shared_from_this(),
-                               asio::placeholders::error,
-                               asio::placeholders::bytes_transferred));
+                   strand_.wrap(
+                       boost::bind(&AsioTcpSocket::read_handler,
+                                   shared_from_this(),
+                                   asio::placeholders::error,
+                                   asio::placeholders::bytes_transferred)));
+    }
+}
+
+
+void gcomm::AsioTcpSocket::start_write()
+{
+    assert(write_q_.empty());
+    assert(send_q_.empty() == false);
+
+    write_q_bytes_ = 0;
+    do
+    {
+        write_q_.push_back(send_q_.front());
+        write_q_bytes_ += send_q_.front().len();
+        send_q_.pop_front();
+    }
+    while (send_q_.empty() == false &&
+           write_q_.size() < max_write_batch_size &&
+           write_q_bytes_ + send_q_.front().len() <= max_write_batch_bytes);
+
+    write_cbs_.clear();
+
+    if (ssl_socket_ != 0)
+    {
+        ssl_write_buf_.resize(write_q_bytes_);
+        size_t offset(0);
+        for (std::deque<Datagram>::const_iterator i(write_q_.begin());
+             i != write_q_.end(); ++i)
+        {
+            std::copy(i->header() + i->header_offset(),
+                      i->header() + i->header_size(),
+                      &ssl_write_buf_[0] + offset);
+            offset += i->header_len();
+            std::copy(i->payload().begin(), i->payload().end(),
+                      &ssl_write_buf_[0] + offset);
+            offset += i->payload().size();
+        }
+        assert(offset == write_q_bytes_);
+        write_cbs_.push_back(asio::const_buffer(&ssl_write_buf_[0],
+                                                ssl_write_buf_.size()));
+    }
+    else
+    {
+        for (std::deque<Datagram>::const_iterator i(write_q_.begin());
+             i != write_q_.end(); ++i)
+        {
+            write_cbs_.push_back(asio::const_buffer(i->header()
+                                                    + i->header_offset(),
+                                                    i->header_len()));
+            write_cbs_.push_back(asio::const_buffer(i->payload().data(),
+                                                    i->payload().size()));
+        }
     }
+
+    write_one(write_cbs_);
 }
 
 
 void gcomm::AsioTcpSocket::write_one(
-    const gu::array<asio::const_buffer, 2>::type& cbs)
+    const std::vector<asio::const_buffer>& cbs)
 {
     if (ssl_socket_ != 0)
     {
         async_write(*ssl_socket_, cbs,
-                    boost::bind(&AsioTcpSocket::write_handler,
-                                shared_from_this(),
-                                asio::placeholders::error,
-                                asio::placeholders::bytes_transferred));
+                    strand_.wrap(
+                        boost::bind(&AsioTcpSocket::write_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error,
+                                    asio::placeholders::bytes_transferred)));
     }
     else
     {
         async_write(socket_, cbs,
-                    boost::bind(&AsioTcpSocket::write_handler,
-                                shared_from_this(),
-                                asio::placeholders::error,
-                                asio::placeholders::bytes_transferred));
+                    strand_.wrap(
+                        boost::bind(&AsioTcpSocket::write_handler,
+                                    shared_from_this(),
+                                    asio::placeholders::error,
+                                    asio::placeholders::bytes_transferred)));
     }
 }
 
@@ -809,8 +859,8 @@ gcomm::SocketStats gcomm::AsioTcpSocket::stats() const
         Critical<AsioProtonet> crit(net_);
         ret.last_queued_since = (now - last_queued_tstamp_).get_nsecs();
         ret.last_delivered_since = (now - last_delivered_tstamp_).get_nsecs();
-        ret.send_queue_length = send_q_.size();
-        ret.send_queue_bytes = send_q_.queued_bytes();
+        ret.send_queue_length = send_q_.size() + write_q_.size();
+        ret.send_queue_bytes = send_q_.queued_bytes() + write_q_bytes_;
         ret.send_queue_segments = send_q_.segments();
     }
 #endif /* __linux__ || __FreeBSD__ */
@@ -837,6 +887,8 @@ void gcomm::AsioTcpAcceptor::accept_handler(
     SocketPtr socket,
     const asio::error_code& error)
 {
+    Critical<AsioProtonet> crit(net_);
+
     if (!error)
     {
         AsioTcpSocket* s(static_cast<AsioTcpSocket*>(socket.get()));
@@ -853,9 +905,10 @@ void gcomm::AsioTcpAcceptor::accept_handler(
                           << s->local_addr();
                 s->ssl_socket_->async_handshake(
                     asio::ssl::stream<asio::ip::tcp::socket>::server,
-                    boost::bind(&AsioTcpSocket::handshake_handler,
-                                s->shared_from_this(),
-                                asio::placeholders::error));
+                    s->strand_.wrap(
+                        boost::bind(&AsioTcpSocket::handshake_handler,
+                                    s->shared_from_this(),
+                                    asio::placeholders::error)));
                 s->state_ = Socket::S_CONNECTING;
             }
             else
@@ -86,7 +86,8 @@ private:
         last_queued_tstamp_ = last_delivered_tstamp_ = now;
     }
     void read_one(gu::array<asio::mutable_buffer, 1>::type& mbs);
-    void write_one(const gu::array<asio::const_buffer, 2>::type& cbs);
+    void start_write();
+    void write_one(const std::vector<asio::const_buffer>& cbs);
     void close_socket();
 
     // call to assign local/remote addresses at the point where it
@@ -102,6 +103,9 @@ private:
     socket() { return (ssl_socket_ ? ssl_socket_->lowest_layer() : socket_); }
 
     AsioProtonet&                             net_;
+    // Serializes handlers of this socket when the protonet runs several
+    // I/O threads: SSL stream must not be used concurrently.
+    asio::io_service::strand                  strand_;
     asio::ip::tcp::socket                     socket_;
     asio::ssl::stream<asio::ip::tcp::socket>* ssl_socket_;
     // Limit the number of queued bytes. This workaround to avoid queue
@@ -111,6 +115,17 @@ private:
     // datagrams with default gcomm MTU 32kB.
     static const size_t                       max_send_q_bytes = (1 << 25);
     gcomm::FairSendQueue                      send_q_;
+    // Datagrams taken from send_q_ for the write in progress. Queued
+    // datagrams are gathered into one write up to max_write_batch_bytes
+    // (at least one datagram is always written).
+    static const size_t                       max_write_batch_bytes = (1 << 16);
+    static const size_t                       max_write_batch_size  = 32;
+    std::deque<gcomm::Datagram>               write_q_;
+    size_t                                    write_q_bytes_;
+    std::vector<asio::const_buffer>           write_cbs_;
+    // SSL stream encrypts only the first buffer of a buffer sequence
+    // per record, so the batch is copied into a contiguous buffer.
+    std::vector<gu::byte_t>                   ssl_write_buf_;
     gu::datetime::Date                        last_queued_tstamp_;
     std::vector<gu::byte_t>                   recv_buf_;
     size_t                                    recv_offset_;
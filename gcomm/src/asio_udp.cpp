@@ -3,9 +3,11 @@
  */
 
 #include "asio_udp.hpp"
+#include "asio_tcp.hpp" // GCOMM_ASIO_AUTO_BUF_SIZE
 
 #include "gcomm/util.hpp"
 #include "gcomm/common.hpp"
+#include "gcomm/conf.hpp"
 
 #include "gu_array.hpp"
 
@@ -88,6 +90,7 @@ void gcomm::AsioUdpSocket::connect(const gu::URI& uri)
     gu::set_fd_options(socket_);
     asio::ip::udp::socket::non_blocking_io cmd(true);
     socket_.io_control(cmd);
+    set_buf_sizes();
 
     const asio::ip::address local_if(
         gu::make_address(
@@ -117,6 +120,25 @@ void gcomm::AsioUdpSocket::connect(const gu::URI& uri)
     state_ = S_CONNECTED;
 }
 
+// Datagrams which do not fit into socket buffers are dropped and must be
+// recovered by EVS retransmission, so honor configured buffer sizes.
+void gcomm::AsioUdpSocket::set_buf_sizes()
+{
+    const gu::Config& conf(net_.conf());
+
+    if (conf.get(Conf::SocketRecvBufSize) != GCOMM_ASIO_AUTO_BUF_SIZE)
+    {
+        socket_.set_option(asio::socket_base::receive_buffer_size(
+                               conf.get<size_t>(Conf::SocketRecvBufSize)));
+    }
+
+    if (conf.get(Conf::SocketSendBufSize) != GCOMM_ASIO_AUTO_BUF_SIZE)
+    {
+        socket_.set_option(asio::socket_base::send_buffer_size(
+                               conf.get<size_t>(Conf::SocketSendBufSize)));
+    }
+}
+
 void gcomm::AsioUdpSocket::close()
 {
     Critical<AsioProtonet> crit(net_);
@@ -196,7 +218,7 @@ void gcomm::AsioUdpSocket::read_handler(const asio::error_code& ec,
                     new gu::Buffer(&recv_buf_[0] + NetHeader::serial_size_,
                                    &recv_buf_[0] + NetHeader::serial_size_
                                    + hdr.len())));
-            if (net_.checksum_ == true && check_cs(hdr, dg))
+            if (net_.checksum_ != NetHeader::CS_NONE && check_cs(hdr, dg))
             {
                 log_warn << "checksum failed, hdr: len=" << hdr.len()
                          << " has_crc32="  << hdr.has_crc32()
@@ -48,6 +48,8 @@ public:
     SocketId id() const { return &socket_; }
     SocketStats stats() const { return SocketStats(); }
 private:
+    void set_buf_sizes();
+
     AsioProtonet&            net_;
     State                    state_;
     asio::ip::udp::socket    socket_;
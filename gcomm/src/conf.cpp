@@ -24,6 +24,8 @@ std::string const gcomm::Conf::SocketRecvBufSize =
     SocketPrefix + "recv_buf_size";
 std::string const gcomm::Conf::SocketSendBufSize =
     SocketPrefix + "send_buf_size";
+std::string const gcomm::Conf::SocketIoThreads =
+    SocketPrefix + "io_threads";
 
 // GMCast
 std::string const gcomm::Conf::GMCastScheme = "gmcast";
@@ -133,6 +135,7 @@ gcomm::Conf::register_params(gu::Config& cnf)
     GCOMM_CONF_ADD_DEFAULT(SocketChecksum);
     GCOMM_CONF_ADD_DEFAULT(SocketRecvBufSize);
     GCOMM_CONF_ADD_DEFAULT(SocketSendBufSize);
+    GCOMM_CONF_ADD_DEFAULT(SocketIoThreads);
 
     GCOMM_CONF_ADD_DEFAULT(GMCastVersion);
     GCOMM_CONF_ADD        (GMCastGroup);
@@ -68,6 +68,15 @@ uint32_t
 gcomm::crc32(gcomm::NetHeader::checksum_t const type,
              const gcomm::Datagram& dg, size_t offset)
 {
+    // only checksums of the whole datagram are memoized
+    bool const whole(offset == 0);
+
+    if (whole && dg.crc32_type_ == type && type != NetHeader::CS_NONE)
+    {
+        return dg.crc32_;
+    }
+
+    uint32_t ret;
     gu::byte_t lenb[4];
 
     gu::serialize4(static_cast<int32_t>(dg.len() - offset),
@@ -93,7 +102,7 @@ gcomm::crc32(gcomm::NetHeader::checksum_t const type,
         crc.process_block(dg.payload_->data() + offset,
                           dg.payload_->data() + dg.payload_->size());
 
-        return crc.checksum();
+        ret = crc.checksum();
     }
     else if (NetHeader::CS_CRC32C == type)
     {
@@ -114,9 +123,19 @@ gcomm::crc32(gcomm::NetHeader::checksum_t const type,
 
         crc.append (dg.payload_->data() + offset, dg.payload_->size() - offset);
 
-        return crc();
+        ret = crc();
+    }
+    else
+    {
+        gu_throw_error(EINVAL) << "Unsupported checksum algorithm: " << type;
+    }
+
+    if (whole)
+    {
+        dg.crc32_type_ = type;
+        dg.crc32_      = ret;
     }
 
-    gu_throw_error(EINVAL) << "Unsupported checksum algorithm: " << type;
+    return ret;
 }
 
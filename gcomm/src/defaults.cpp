@@ -21,6 +21,7 @@ namespace gcomm
         GCOMM_ASIO_AUTO_BUF_SIZE;
     std::string const Defaults::SocketSendBufSize       =
         GCOMM_ASIO_AUTO_BUF_SIZE;
+    std::string const Defaults::SocketIoThreads         = "1";
     std::string const Defaults::GMCastVersion           = "0";
     std::string const Defaults::GMCastTcpPort           = BASE_PORT_DEFAULT;
     std::string const Defaults::GMCastSegment           = "0";
@@ -16,6 +16,7 @@ namespace gcomm
         static std::string const SocketChecksum           ;
         static std::string const SocketRecvBufSize        ;
         static std::string const SocketSendBufSize        ;
+        static std::string const SocketIoThreads          ;
         static std::string const GMCastVersion            ;
         static std::string const GMCastTcpPort            ;
         static std::string const GMCastSegment            ;
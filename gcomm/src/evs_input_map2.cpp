@@ -10,6 +10,7 @@
 #include "gu_buffer.hpp"
 #include <stdexcept>
 #include <numeric>
+#include <new>
 
 
 //////////////////////////////////////////////////////////////////////////
@@ -90,6 +91,18 @@ std::ostream& gcomm::evs::operator<<(std::ostream& os, const InputMapMsg& m)
 }
 
 
+std::ostream& gcomm::evs::operator<<(std::ostream& os,
+                                     const InputMapMsgRing& r)
+{
+    for (InputMapMsgRing::iterator i(r.begin()); i != r.end(); ++i)
+    {
+        os << "\t" << InputMapMsgRing::key(i) << ","
+           << InputMapMsgRing::value(i) << "\n";
+    }
+    return os;
+}
+
+
 std::ostream& gcomm::evs::operator<<(std::ostream& os, const InputMap& im)
 {
     return (os << "evs::input_map: {"
@@ -106,6 +119,148 @@ std::ostream& gcomm::evs::operator<<(std::ostream& os, const InputMap& im)
 
 
 
+//////////////////////////////////////////////////////////////////////////
+//
+// InputMapMsgRing
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+gcomm::evs::InputMapMsgRing::iterator
+gcomm::evs::InputMapMsgRing::insert_unique(const InputMapMsgKey& k,
+                                           const InputMapMsg&    msg)
+{
+    seqno_t const seq(k.seq());
+    size_t  const idx(k.index());
+
+    gcomm_assert(seq >= 0);
+
+    if (used(seq, idx))
+    {
+        gu_throw_fatal << "duplicate entry "
+                       << "key=" << k << " "
+                       << "value=" << msg << " "
+                       << "map=" << *this;
+    }
+
+    seqno_t const lo(size_ > 0 ? std::min(begin_, seq) : seq);
+    seqno_t const hi(size_ > 0 ? std::max(end_, seq + 1) : seq + 1);
+    size_t  const rows(slots_.empty() ? 0 : mask_ + 1);
+
+    if (size_t(hi - lo) > rows || idx >= cols_)
+    {
+        size_t new_rows(std::max(rows, size_t(16)));
+        while (new_rows < size_t(hi - lo)) new_rows <<= 1;
+        gu_trace(reshape(new_rows, std::max(cols_, idx + 1)));
+    }
+
+    Slot& s(slot(seq, idx));
+    new (s.buf_.buf_) InputMapMsg(msg);
+    s.used_ = true;
+    ++row_used_[row(seq)];
+    ++size_;
+    begin_ = lo;
+    end_   = hi;
+
+    return iterator(this, seq, idx);
+}
+
+
+void gcomm::evs::InputMapMsgRing::erase(iterator i)
+{
+    gcomm_assert(used(i.seq_, i.idx_));
+
+    Slot& s(slot(i.seq_, i.idx_));
+    s.msg().~InputMapMsg();
+    s.used_ = false;
+    --row_used_[row(i.seq_)];
+    --size_;
+
+    if (size_ == 0)
+    {
+        begin_ = end_ = 0;
+        return;
+    }
+
+    // shrink the window to used rows, some row is still used
+    while (row_used_[row(begin_)]  == 0) ++begin_;
+    while (row_used_[row(end_ - 1)] == 0) --end_;
+}
+
+
+void gcomm::evs::InputMapMsgRing::clear()
+{
+    for (seqno_t seq(begin_); size_ > 0 && seq < end_; ++seq)
+    {
+        for (size_t idx(0); idx < cols_; ++idx)
+        {
+            Slot& s(slot(seq, idx));
+            if (s.used_)
+            {
+                s.msg().~InputMapMsg();
+                s.used_ = false;
+                --size_;
+            }
+        }
+        row_used_[row(seq)] = 0;
+    }
+    assert(size_ == 0);
+    begin_ = end_ = 0;
+}
+
+
+void gcomm::evs::InputMapMsgRing::reshape(size_t const rows,
+                                          size_t const cols)
+{
+    assert(rows > 0 && (rows & (rows - 1)) == 0);
+
+    std::vector<Slot>   slots(rows * cols);
+    std::vector<size_t> row_used(rows, 0);
+    size_t const        mask(rows - 1);
+
+    // copy messages first, so that the index is intact on exception
+    try
+    {
+        for (seqno_t seq(begin_); size_ > 0 && seq < end_; ++seq)
+        {
+            for (size_t idx(0); idx < cols_; ++idx)
+            {
+                const Slot& from(slot(seq, idx));
+                if (from.used_)
+                {
+                    size_t const r(size_t(seq) & mask);
+                    Slot& to(slots[r*cols + idx]);
+                    new (to.buf_.buf_) InputMapMsg(from.msg());
+                    to.used_ = true;
+                    ++row_used[r];
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        for (size_t i(0); i < slots.size(); ++i)
+        {
+            if (slots[i].used_) slots[i].msg().~InputMapMsg();
+        }
+        throw;
+    }
+
+    size_t  const size(size_);
+    seqno_t const begin(begin_);
+    seqno_t const end(end_);
+    clear();
+    size_  = size;
+    begin_ = begin;
+    end_   = end;
+
+    slots_.swap(slots);
+    row_used_.swap(row_used);
+    cols_ = cols;
+    mask_ = mask;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //
 // Constructors/destructors
@@ -333,7 +488,9 @@ gcomm::evs::InputMap::insert(const size_t uuid,
 
 void gcomm::evs::InputMap::erase(iterator i)
 {
-    gu_trace(recovery_index_->insert_unique(*i));
+    gu_trace(recovery_index_->insert_unique(
+                 std::make_pair(InputMapMsgIndex::key(i),
+                                InputMapMsgIndex::value(i))));
     gu_trace(msg_index_->erase(i));
 }
 
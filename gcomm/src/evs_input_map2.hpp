@@ -35,6 +35,8 @@ namespace gcomm
     {
         class InputMapMsg;
         std::ostream& operator<<(std::ostream&, const InputMapMsg&);
+        class InputMapMsgRing;
+        std::ostream& operator<<(std::ostream&, const InputMapMsgRing&);
         class InputMapMsgIndex;
         class InputMapNode;
         std::ostream& operator<<(std::ostream&, const InputMapNode&);
@@ -92,7 +94,234 @@ private:
 };
 
 
-#if defined(GALERA_USE_BOOST_POOL_ALLOC)
+/*!
+ * Message index with the same interface and (seq, index) iteration order as
+ * the std::map based index, backed by a circular array of message slots.
+ * A row of the array holds one slot per node for a given seqno, so
+ * insert, find and erase are O(1) and iteration in delivery order is a
+ * linear walk over contiguous slots. Rows are reused as the seqno window
+ * advances, the array is reallocated only if the window or the number of
+ * nodes grows. Iterators are (seq, index) positions and so stay valid over
+ * insertions.
+ */
+class gcomm::evs::InputMapMsgRing
+{
+public:
+
+    typedef InputMapMsgKey key_type;
+    typedef InputMapMsg    mapped_type;
+
+    class iterator
+    {
+    public:
+        iterator() : ring_(0), seq_(-1), idx_(0) { }
+
+        iterator& operator++()
+        {
+            ++idx_;
+            ring_->next(seq_, idx_);
+            return *this;
+        }
+
+        bool operator==(const iterator& cmp) const
+        {
+            return (seq_ == cmp.seq_ && idx_ == cmp.idx_);
+        }
+
+        bool operator!=(const iterator& cmp) const
+        {
+            return !(*this == cmp);
+        }
+
+    private:
+        friend class InputMapMsgRing;
+
+        iterator(const InputMapMsgRing* ring, seqno_t seq, size_t idx)
+            : ring_(ring), seq_(seq), idx_(idx)
+        { }
+
+        const InputMapMsgRing* ring_;
+        seqno_t                seq_;  /* -1 for end() */
+        size_t                 idx_;
+    };
+
+    typedef iterator const_iterator;
+
+    InputMapMsgRing()
+        :
+        slots_   (),
+        row_used_(),
+        cols_    (0),
+        mask_    (0),
+        begin_   (0),
+        end_     (0),
+        size_    (0)
+    { }
+
+    ~InputMapMsgRing() { clear(); }
+
+    iterator begin() const
+    {
+        seqno_t seq(begin_);
+        size_t  idx(0);
+        next(seq, idx);
+        return iterator(this, seq, idx);
+    }
+
+    iterator end() const { return iterator(this, -1, 0); }
+
+    iterator find(const InputMapMsgKey& k) const
+    {
+        return (used(k.seq(), k.index()) ?
+                iterator(this, k.seq(), k.index()) : end());
+    }
+
+    iterator find_checked(const InputMapMsgKey& k) const
+    {
+        iterator const ret(find(k));
+        if (ret == end())
+        {
+            gu_throw_fatal << "element " << k << " not found";
+        }
+        return ret;
+    }
+
+    /* first element not less than k */
+    iterator lower_bound(const InputMapMsgKey& k) const
+    {
+        seqno_t seq(k.seq());
+        size_t  idx(k.index());
+        if (seq < begin_)
+        {
+            seq = begin_;
+            idx = 0;
+        }
+        next(seq, idx);
+        return iterator(this, seq, idx);
+    }
+
+    iterator insert_unique(const InputMapMsgKey& k, const InputMapMsg& msg);
+
+    template <typename P>
+    iterator insert_unique(const P& p)
+    {
+        return insert_unique(p.first, p.second);
+    }
+
+    void erase(iterator i);
+
+    void erase(iterator i, iterator j)
+    {
+        while (i != j)
+        {
+            iterator const next(i);
+            ++i;
+            erase(next);
+        }
+    }
+
+    /* destroys all messages, allocated slots are kept for reuse */
+    void clear();
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return (size_ == 0); }
+
+    static InputMapMsgKey key(const iterator& i)
+    {
+        return InputMapMsgKey(i.idx_, i.seq_);
+    }
+
+    static const InputMapMsg& value(const iterator& i)
+    {
+        return i.ring_->slot(i.seq_, i.idx_).msg();
+    }
+
+private:
+
+    InputMapMsgRing(const InputMapMsgRing&);
+    void operator=(const InputMapMsgRing&);
+
+    /* message storage, constructed in place while used_ */
+    struct Slot
+    {
+        Slot() : used_(false) { }
+
+        InputMapMsg& msg()
+        {
+            return *reinterpret_cast<InputMapMsg*>(buf_.buf_);
+        }
+
+        const InputMapMsg& msg() const
+        {
+            return *reinterpret_cast<const InputMapMsg*>(buf_.buf_);
+        }
+
+        bool used_;
+        union
+        {
+            gu::byte_t buf_[sizeof(InputMapMsg)];
+            long long  align_ll_;
+            double     align_d_;
+            void*      align_p_;
+        } buf_;
+    };
+
+    size_t row(seqno_t const seq) const { return (size_t(seq) & mask_); }
+
+    Slot& slot(seqno_t const seq, size_t const idx)
+    {
+        return slots_[row(seq)*cols_ + idx];
+    }
+
+    const Slot& slot(seqno_t const seq, size_t const idx) const
+    {
+        return slots_[row(seq)*cols_ + idx];
+    }
+
+    bool used(seqno_t const seq, size_t const idx) const
+    {
+        return (seq >= begin_ && seq < end_ && idx < cols_ &&
+                slot(seq, idx).used_);
+    }
+
+    /* Advances (seq, idx) to the first used slot at or after it, or to end()
+     * position if there is none. */
+    void next(seqno_t& seq, size_t& idx) const
+    {
+        for (; seq < end_; ++seq, idx = 0)
+        {
+            size_t const r(row(seq));
+            if (row_used_[r] == 0) continue;
+            const Slot* const s(&slots_[r*cols_]);
+            for (; idx < cols_; ++idx)
+            {
+                if (s[idx].used_) return;
+            }
+        }
+        seq = -1;
+        idx = 0;
+    }
+
+    /* reallocates slots for rows (power of 2) x cols, moving messages */
+    void reshape(size_t rows, size_t cols);
+
+    std::vector<Slot>   slots_;
+    std::vector<size_t> row_used_; /* number of used slots in row */
+    size_t              cols_;     /* slots per row */
+    size_t              mask_;     /* number of rows - 1 */
+    seqno_t             begin_;    /* lowest seqno in the index */
+    seqno_t             end_;      /* highest seqno in the index + 1 */
+    size_t              size_;
+};
+
+
+#if defined(GCOMM_EVS_INPUT_MAP_RING)
+
+class gcomm::evs::InputMapMsgIndex : public InputMapMsgRing
+{};
+
+#elif defined(GALERA_USE_BOOST_POOL_ALLOC)
 
 #include <boost/pool/pool_alloc.hpp>
 
@@ -170,6 +170,7 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
     bytes_since_request_user_msg_feedback_(),
     output_(),
     send_buf_(),
+    msg_buf_pool_(),
     max_output_size_(128),
     mtu_(mtu),
     use_aggregate_(param<bool>(conf, uri, Conf::EvsUseAggregate, "true")),
@@ -236,6 +237,38 @@ gcomm::evs::Proto::~Proto()
 }
 
 
+gu::SharedBuffer gcomm::evs::Proto::get_msg_buf(size_t const len)
+{
+    for (std::vector<gu::SharedBuffer>::iterator i(msg_buf_pool_.begin());
+         i != msg_buf_pool_.end(); ++i)
+    {
+        if (i->use_count() == 1)
+        {
+            (*i)->resize(len);
+            return *i;
+        }
+    }
+
+    gu::SharedBuffer ret(new gu::Buffer(len));
+    if (msg_buf_pool_.size() < max_msg_buf_pool_size_)
+    {
+        msg_buf_pool_.push_back(ret);
+    }
+    return ret;
+}
+
+
+template <class M>
+gcomm::Datagram gcomm::evs::Proto::serialize_message(const M& msg)
+{
+    gu::SharedBuffer buf(get_msg_buf(msg.serial_size()));
+    size_t offset;
+    gu_trace(offset = msg.serialize(&(*buf)[0], buf->size(), 0));
+    gcomm_assert(offset == buf->size());
+    return Datagram(buf);
+}
+
+
 bool
 gcomm::evs::Proto::set_param(const std::string& key, const std::string& val, 
                             Protolay::sync_param_cb_t& sync_param_cb)
@@ -614,11 +647,9 @@ void gcomm::evs::Proto::handle_retrans_timer()
                 install_message_->source() == uuid())
             {
                 evs_log_debug(D_INSTALL_MSGS) << "retrans install";
-                gu::Buffer buf;
                 install_message_->set_flags(
                     install_message_->flags() | Message::F_RETRANS);
-                (void)serialize(*install_message_, buf);
-                Datagram dg(buf);
+                Datagram dg(serialize_message(*install_message_));
                 // Must not be sent as delegate, newly joining node
                 // will filter them out in handle_msg().
                 gu_trace(send_down(dg, ProtoDownMeta()));
@@ -1734,9 +1765,7 @@ void gcomm::evs::Proto::send_gap(EVS_CALLER_ARG,
                   flags);
 
     evs_log_debug(D_GAP_MSGS) << EVS_LOG_METHOD << gm;
-    gu::Buffer buf;
-    serialize(gm, buf);
-    Datagram dg(buf);
+    Datagram dg(serialize_message(gm));
     int err = send_down(dg, ProtoDownMeta(range_uuid));
     if (err != 0)
     {
@@ -1890,9 +1919,7 @@ void gcomm::evs::Proto::send_join(bool handle)
 
     JoinMessage jm(create_join());
 
-    gu::Buffer buf;
-    serialize(jm, buf);
-    Datagram dg(buf);
+    Datagram dg(serialize_message(jm));
     int err = send_down(dg, ProtoDownMeta());
 
     if (err != 0)
@@ -1947,9 +1974,7 @@ void gcomm::evs::Proto::send_leave(bool handle)
 
     evs_log_debug(D_LEAVE_MSGS) << "sending leave msg " << lm;
 
-    gu::Buffer buf;
-    serialize(lm, buf);
-    Datagram dg(buf);
+    Datagram dg(serialize_message(lm));
     int err = send_down(dg, ProtoDownMeta());
     if (err != 0)
     {
@@ -2033,9 +2058,7 @@ void gcomm::evs::Proto::send_install(EVS_CALLER_ARG)
     evs_log_info(I_STATE) << "sending install message" << imsg;
     gcomm_assert(consensus_.is_consistent(imsg));
 
-    gu::Buffer buf;
-    serialize(imsg, buf);
-    Datagram dg(buf);
+    Datagram dg(serialize_message(imsg));
     int err = send_down(dg, ProtoDownMeta());
     if (err != 0)
     {
@@ -2055,9 +2078,7 @@ void gcomm::evs::Proto::send_delayed_list()
     {
         elm.add(i->first, i->second.state_change_cnt());
     }
-    gu::Buffer buf;
-    serialize(elm, buf);
-    Datagram dg(buf);
+    Datagram dg(serialize_message(elm));
     (void)send_down(dg, ProtoDownMeta());
     handle_delayed_list(elm, self_i_);
 }
@@ -3270,9 +3291,7 @@ void gcomm::evs::Proto::send_request_retrans_gap(const UUID& target,
                   origin,
                   range,
                   Message::F_RETRANS);
-    gu::Buffer buf;
-    serialize(gm, buf);
-    Datagram dg(buf);
+    Datagram dg(serialize_message(gm));
     int err = send_down(dg, ProtoDownMeta(target));
     if (err != 0)
     {
@@ -3999,9 +4018,7 @@ void gcomm::evs::Proto::retrans_leaves(const MessageNodeList& node_list)
                                      lm.fifo_seq(),
                                      Message::F_RETRANS | Message::F_SOURCE);
 
-                gu::Buffer buf;
-                serialize(send_lm, buf);
-                Datagram dg(buf);
+                Datagram dg(serialize_message(send_lm));
                 gu_trace(send_delegate(dg, UUID::nil()));
             }
         }
@@ -169,6 +169,10 @@ public:
     int send_user(const seqno_t);
     void complete_user(const seqno_t);
     int send_delegate(Datagram&, const UUID& target);
+    // Serialize protocol message into datagram payload taken from
+    // msg_buf_pool_.
+    template <class M> Datagram serialize_message(const M& msg);
+    gu::SharedBuffer get_msg_buf(size_t len);
     bool gap_rate_limit(const UUID&, const Range&) const;
     // Send GAP message.
     // @param range_uuid If non-nil, the gap message will contain request for
@@ -575,6 +579,10 @@ private:
     } output_;
 
     std::vector<gu::byte_t> send_buf_;
+    // Payload buffers for protocol messages. A buffer is reused once
+    // the transport has released all datagrams referring to it.
+    std::vector<gu::SharedBuffer> msg_buf_pool_;
+    static const size_t max_msg_buf_pool_size_ = 16;
     uint32_t max_output_size_;
     size_t mtu_;
     bool use_aggregate_;
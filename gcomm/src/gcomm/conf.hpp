@@ -73,6 +73,13 @@ namespace gcomm
          */
         static std::string const SocketSendBufSize;
 
+        /*!
+         * @brief Number of threads doing socket I/O (and SSL encryption).
+         * Protocol processing is still done by one thread at a time.
+         * Default is 1.
+         */
+        static std::string const SocketIoThreads;
+
         /*!
          * @brief GMCast scheme for transport URI ("gmcast")
          */
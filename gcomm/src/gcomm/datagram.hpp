@@ -136,7 +136,7 @@ namespace gcomm
         return offset;
     }
 
-    inline size_t serial_size(const NetHeader& hdr)
+    inline size_t serial_size(const NetHeader&)
     {
         return NetHeader::serial_size_;
     }
@@ -155,7 +155,9 @@ namespace gcomm
             header_       (),
             header_offset_(header_size_),
             payload_      (new gu::Buffer()),
-            offset_       (0)
+            offset_       (0),
+            crc32_type_   (NetHeader::CS_NONE),
+            crc32_        (0)
         { }
         /*!
          * @brief Construct new datagram from byte buffer
@@ -171,7 +173,9 @@ namespace gcomm
             header_       (),
             header_offset_(header_size_),
             payload_      (new gu::Buffer(buf)),
-            offset_       (offset)
+            offset_       (offset),
+            crc32_type_   (NetHeader::CS_NONE),
+            crc32_        (0)
         {
             assert(offset_ <= payload_->size());
         }
@@ -181,7 +185,9 @@ namespace gcomm
             header_       (),
             header_offset_(header_size_),
             payload_      (buf),
-            offset_       (offset)
+            offset_       (offset),
+            crc32_type_   (NetHeader::CS_NONE),
+            crc32_        (0)
         {
             assert(offset_ <= payload_->size());
         }
@@ -200,7 +206,9 @@ namespace gcomm
             // header_(dgram.header_),
             header_offset_(dgram.header_offset_),
             payload_(dgram.payload_),
-            offset_(off == std::numeric_limits<size_t>::max() ? dgram.offset_ : off)
+            offset_(off == std::numeric_limits<size_t>::max() ? dgram.offset_ : off),
+            crc32_type_(NetHeader::CS_NONE),
+            crc32_(0)
         {
             assert(offset_ <= dgram.len());
             memcpy(header_ + header_offset_,
@@ -215,6 +223,7 @@ namespace gcomm
 
         void normalize()
         {
+            reset_crc32();
             const gu::SharedBuffer old_payload(payload_);
             payload_ = gu::SharedBuffer(new gu::Buffer);
             payload_->reserve(header_len() + old_payload->size() - offset_);
@@ -238,7 +247,7 @@ namespace gcomm
             offset_ = 0;
         }
 
-        gu::byte_t* header() { return header_; }
+        gu::byte_t* header() { reset_crc32(); return header_; }
         const gu::byte_t* header() const { return header_; }
         size_t header_size()   const { return header_size_; }
         size_t header_len()    const { return (header_size_ - header_offset_); }
@@ -248,6 +257,7 @@ namespace gcomm
         {
             // assert(off <= header_size_);
             if (off > header_size_) gu_throw_fatal << "out of hdrspace";
+            reset_crc32();
             header_offset_ = off;
         }
 
@@ -260,6 +270,7 @@ namespace gcomm
         gu::Buffer& payload()
         {
             assert(payload_);
+            reset_crc32();
             return *payload_;
         }
 
@@ -275,11 +286,18 @@ namespace gcomm
         friend uint16_t crc16(const Datagram&, size_t);
         friend uint32_t crc32(NetHeader::checksum_t, const Datagram&, size_t);
 
+        void reset_crc32() { crc32_type_ = NetHeader::CS_NONE; }
+
         static const size_t header_size_ = 128;
         gu::byte_t          header_[header_size_];
         size_t              header_offset_;
         gu::SharedBuffer    payload_;
         size_t              offset_;
+        // Checksum of the whole datagram memoized by crc32() so that
+        // fanning the same datagram out to several sockets computes it
+        // only once. Reset by every non-const accessor.
+        mutable NetHeader::checksum_t crc32_type_;
+        mutable uint32_t              crc32_;
     };
 
     uint16_t crc16(const Datagram& dg, size_t offset = 0);
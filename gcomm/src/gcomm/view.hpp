@@ -122,8 +122,8 @@ namespace gcomm
         Node(SegmentId segment = 0) : segment_(segment)
         { }
         SegmentId segment() const { return segment_; }
-        bool operator==(const Node& cmp) const { return true; }
-        bool operator<(const Node& cmp) const { return true; }
+        bool operator==(const Node&) const { return true; }
+        bool operator<(const Node&) const { return true; }
         std::ostream& write_stream(std::ostream& os) const
         {
             os << static_cast<int>(segment_);
@@ -326,10 +326,16 @@ void gcomm::GMCast::connect()
 
     if (!mcast_addr_.empty())
     {
+        const std::string if_addr(gu::URI(listen_addr_).get_host());
+        // When listening on loopback interface all group members must be
+        // running on this host, so multicast loopback must be enabled
+        // for them to see each other's messages. Own messages looped
+        // back are discarded in handle_up().
+        const bool if_loop(gu::make_address(if_addr).is_loopback());
         gu::URI mcast_uri(
             mcast_addr_ + '?'
-            + gcomm::Socket::OptIfAddr + '='
-            + gu::URI(listen_addr_).get_host()+'&'
+            + gcomm::Socket::OptIfAddr + '=' + if_addr + '&'
+            + gcomm::Socket::OptIfLoop + '=' + gu::to_string(if_loop) + '&'
             + gcomm::Socket::OptNonBlocking + "=1&"
             + gcomm::Socket::OptMcastTTL    + '=' + gu::to_string(mcast_ttl_)
             );
@@ -1437,6 +1443,16 @@ void gcomm::GMCast::handle_up(const void*        id,
 
         if (msg.type() >= Message::GMCAST_T_USER_BASE)
         {
+            if (msg.source_uuid() == uuid())
+            {
+                // own message looped back
+                return;
+            }
+            if (evict_list().empty() == false &&
+                evict_list().find(msg.source_uuid()) != evict_list().end())
+            {
+                return;
+            }
             gu_trace(send_up(Datagram(dg, dg.offset() + msg.serial_size()),
                              ProtoUpMeta(msg.source_uuid())));
         }
@@ -455,6 +455,101 @@ START_TEST(test_input_map_gap_range_list)
 }
 END_TEST
 
+// Ring buffer message index must behave as std::map based index
+START_TEST(test_input_map_msg_ring)
+{
+    log_info << "START";
+    init_rand();
+    typedef Map<InputMapMsgKey, InputMapMsg> Tree;
+    Tree tree;
+    InputMapMsgRing ring;
+    ViewId view_id(V_REG, UUID(1), 1);
+    seqno_t base(0);
+    size_t n_nodes(3);
+
+    for (size_t step(0); step < 20000; ++step)
+    {
+        // add nodes and widen seqno window on the way
+        if (step == 5000) n_nodes = 7;
+        seqno_t const window(step < 10000 ? 8 : 100);
+
+        switch (rand() % 4)
+        {
+        case 0:
+        case 1:
+        {
+            size_t const idx(rand() % n_nodes);
+            seqno_t const seq(base + rand() % window);
+            InputMapMsgKey const key(idx, seq);
+            if (tree.find(key) == tree.end())
+            {
+                UserMessage const um(0, UUID(int32_t(idx + 1)), view_id, seq);
+                tree.insert_unique(make_pair(key, InputMapMsg(um, Datagram())));
+                InputMapMsgRing::iterator const i(
+                    ring.insert_unique(make_pair(key,
+                                                 InputMapMsg(um, Datagram()))));
+                ck_assert(InputMapMsgRing::value(i).msg() == um);
+            }
+            else
+            {
+                ck_assert(ring.find(key) != ring.end());
+            }
+            break;
+        }
+        case 2:
+            if (tree.empty() == false)
+            {
+                ck_assert(ring.begin() != ring.end());
+                ck_assert(InputMapMsgRing::value(ring.begin()).msg() ==
+                          Tree::value(tree.begin()).msg());
+                tree.erase(tree.begin());
+                ring.erase(ring.begin());
+            }
+            break;
+        case 3:
+        {
+            InputMapMsgKey const key(rand() % n_nodes,
+                                     base + rand() % (window + 2) - 1);
+            Tree::iterator const ti(tree.lower_bound(key));
+            InputMapMsgRing::iterator const ri(ring.lower_bound(key));
+            ck_assert((ti == tree.end()) == (ri == ring.end()));
+            if (ti != tree.end())
+            {
+                ck_assert(Tree::key(ti).seq() == InputMapMsgRing::key(ri).seq());
+                ck_assert(Tree::key(ti).index() ==
+                          InputMapMsgRing::key(ri).index());
+            }
+            break;
+        }
+        }
+
+        if (step % 100 == 99)
+        {
+            // purge below new base like recovery index cleanup does
+            base += rand() % window;
+            InputMapMsgKey const key(0, base);
+            tree.erase(tree.begin(), tree.lower_bound(key));
+            ring.erase(ring.begin(), ring.lower_bound(key));
+
+            ck_assert(ring.size() == tree.size());
+            Tree::iterator ti(tree.begin());
+            for (InputMapMsgRing::iterator ri(ring.begin()); ri != ring.end();
+                 ++ri, ++ti)
+            {
+                ck_assert(ti != tree.end());
+                ck_assert(InputMapMsgRing::value(ri).msg() ==
+                          Tree::value(ti).msg());
+            }
+            ck_assert(ti == tree.end());
+        }
+    }
+
+    ring.clear();
+    ck_assert(ring.empty() == true);
+    ck_assert(ring.begin() == ring.end());
+}
+END_TEST
+
 static Datagram* get_msg(DummyTransport* tp, Message* msg, bool release = true)
 {
     Datagram* rb = tp->out();
@@ -2550,6 +2645,10 @@ Suite* evs2_suite()
     tcase_add_test(tc, test_input_map_gap_range_list);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_input_map_msg_ring");
+    tcase_add_test(tc, test_input_map_msg_ring);
+    suite_add_tcase(s, tc);
+
     tc = tcase_create("test_proto_single_join");
     tcase_add_test(tc, test_proto_single_join);
     suite_add_tcase(s, tc);
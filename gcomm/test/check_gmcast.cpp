@@ -43,6 +43,110 @@ START_TEST(test_gmcast_multicast)
 END_TEST
 
 
+// Multicast data path over loopback interface: user messages between
+// members listening on loopback are sent once via multicast socket,
+// own looped back messages are not delivered.
+class McastUser : public Toplay
+{
+public:
+    McastUser(Protonet& pnet, const std::string& remote_addr)
+        :
+        Toplay(pnet.conf()),
+        tp_(0),
+        recvd_(0),
+        pstack_()
+    {
+        std::string uri("gmcast://" + remote_addr + "?");
+        uri += "gmcast.group=mcast_test";
+        uri += "&gmcast.mcast_addr=239.192.0.11&gmcast.mcast_port=14567";
+        uri += "&gmcast.listen_addr=tcp://127.0.0.1:0";
+        tp_ = Transport::create(pnet, uri);
+        pstack_.push_proto(tp_);
+        pstack_.push_proto(this);
+        pnet.insert(&pstack_);
+        tp_->connect();
+    }
+
+    ~McastUser()
+    {
+        pstack_.pop_proto(this);
+        pstack_.pop_proto(tp_);
+        tp_->close();
+        delete tp_;
+    }
+
+    void send()
+    {
+        byte_t buf[16];
+        memset(buf, 0xa5, sizeof(buf));
+        Datagram dg(Buffer(buf, buf + sizeof(buf)));
+        send_down(dg, ProtoDownMeta());
+    }
+
+    void handle_up(const void*, const Datagram&, const ProtoUpMeta&)
+    {
+        recvd_++;
+    }
+
+    size_t recvd() const { return recvd_; }
+    void set_recvd(size_t val) { recvd_ = val; }
+    Protostack& pstack() { return pstack_; }
+    std::string listen_addr() const { return tp_->listen_addr(); }
+
+private:
+    McastUser(const McastUser&);
+    void operator=(const McastUser&);
+
+    Transport* tp_;
+    size_t     recvd_;
+    Protostack pstack_;
+};
+
+START_TEST(test_gmcast_multicast_loopback)
+{
+    log_info << "START test_gmcast_multicast_loopback";
+    gu::Config conf;
+    gu::ssl_register_params(conf);
+    gcomm::Conf::register_params(conf);
+    auto_ptr<Protonet> pnet(Protonet::create(conf));
+
+    McastUser u1(*pnet, "");
+    McastUser u2(*pnet, u1.listen_addr().erase(0, strlen("tcp://")));
+
+    for (size_t i(0); i < 100 && (u1.recvd() == 0 || u2.recvd() == 0); ++i)
+    {
+        u1.send();
+        u2.send();
+        pnet->event_loop(Sec/10);
+    }
+    ck_assert(u1.recvd() != 0);
+    ck_assert(u2.recvd() != 0);
+
+    // drain messages in flight
+    pnet->event_loop(Sec/2);
+    u1.set_recvd(0);
+    u2.set_recvd(0);
+
+    const size_t n_msgs(30);
+    for (size_t i(0); i < n_msgs; ++i)
+    {
+        u1.send();
+    }
+    for (size_t i(0); i < 10 && u2.recvd() < n_msgs; ++i)
+    {
+        pnet->event_loop(Sec/10);
+    }
+
+    // each message exactly once, not both via multicast and tcp
+    ck_assert_msg(u2.recvd() == n_msgs, "u2 recvd %zu", u2.recvd());
+    ck_assert_msg(u1.recvd() == 0, "u1 recvd %zu", u1.recvd());
+
+    pnet->erase(&u2.pstack());
+    pnet->erase(&u1.pstack());
+}
+END_TEST
+
+
 START_TEST(test_gmcast_w_user_messages)
 {
     class User : public Toplay
@@ -491,6 +595,11 @@ Suite* gmcast_suite()
         suite_add_tcase(s, tc);
     }
 
+    tc = tcase_create("test_gmcast_multicast_loopback");
+    tcase_add_test(tc, test_gmcast_multicast_loopback);
+    tcase_set_timeout(tc, 30);
+    suite_add_tcase(s, tc);
+
     tc = tcase_create("test_gmcast_w_user_messages");
     tcase_add_test(tc, test_gmcast_w_user_messages);
     tcase_set_timeout(tc, 30);
@@ -124,6 +124,41 @@ START_TEST(test_datagram)
 END_TEST
 
 
+START_TEST(test_datagram_crc32)
+{
+    gu::byte_t b[128];
+    for (gu::byte_t i = 0; i < sizeof(b); ++i)
+    {
+        b[i] = i;
+    }
+    gu::Buffer buf(b, b + sizeof(b));
+
+    gcomm::Datagram dg(buf);
+    const uint32_t cs(gcomm::crc32(NetHeader::CS_CRC32, dg));
+    // memoized value
+    ck_assert(gcomm::crc32(NetHeader::CS_CRC32, dg) == cs);
+    // checksum with offset is not memoized
+    ck_assert(gcomm::crc32(NetHeader::CS_CRC32, dg, 16) != cs);
+    ck_assert(gcomm::crc32(NetHeader::CS_CRC32, dg) == cs);
+
+    // header change must invalidate memoized checksum
+    dg.set_header_offset(dg.header_offset() - 4);
+    memset(dg.header() + dg.header_offset(), 0xab, 4);
+    const uint32_t cs_hdr(gcomm::crc32(NetHeader::CS_CRC32, dg));
+    ck_assert(cs_hdr != cs);
+    ck_assert(cs_hdr == gcomm::crc32(NetHeader::CS_CRC32, Datagram(dg)));
+    dg.set_header_offset(dg.header_offset() + 4);
+    ck_assert(gcomm::crc32(NetHeader::CS_CRC32, dg) == cs);
+
+    // payload change must invalidate memoized checksum
+    dg.payload()[0] = 0xff;
+    const uint32_t cs_pl(gcomm::crc32(NetHeader::CS_CRC32, dg));
+    ck_assert(cs_pl != cs);
+    ck_assert(cs_pl == gcomm::crc32(NetHeader::CS_CRC32, Datagram(dg)));
+}
+END_TEST
+
+
 
 
 START_TEST(test_view_state)
@@ -189,6 +224,10 @@ Suite* util_suite()
     tcase_add_test(tc, test_datagram);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("test_datagram_crc32");
+    tcase_add_test(tc, test_datagram_crc32);
+    suite_add_tcase(s, tc);
+
     tc = tcase_create("test_view_state");
     tcase_add_test(tc, test_view_state);
     suite_add_tcase(s, tc);
@@ -6,10 +6,12 @@
 #include "gcomm/protonet.hpp"
 #include "gcomm/datagram.hpp"
 #include "gcomm/conf.hpp"
+#include "gcomm/protostack.hpp"
 
 #include "check_gcomm.hpp"
 
 #include "gu_logger.hpp"
+#include "gu_atomic.h"
 
 #ifdef HAVE_ASIO_HPP
 #include "asio_protonet.hpp"
@@ -17,9 +19,11 @@
 
 
 #include <vector>
+#include <map>
 #include <fstream>
 #include <limits>
 #include <cstdlib>
+#include <cstring>
 #include <check.h>
 
 using std::vector;
@@ -68,6 +72,111 @@ START_TEST(test_asio)
 
 }
 END_TEST
+
+// Accepts connections and checks that datagrams from each connection
+// are delivered in order and never concurrently.
+class IoThreadsReceiver : public Protolay
+{
+public:
+    IoThreadsReceiver(gu::Config& conf, Acceptor& acc)
+        :
+        Protolay(conf),
+        acc_(acc),
+        sockets_(),
+        next_(),
+        received_(0),
+        inside_(0),
+        failed_(false)
+    { }
+
+    int handle_down(Datagram&, const ProtoDownMeta&) { return 0; }
+
+    void handle_up(const void* id, const Datagram& dg, const ProtoUpMeta& um)
+    {
+        if (gu_atomic_fetch_and_add(&inside_, 1) != 0) failed_ = true;
+
+        if (id == acc_.id())
+        {
+            sockets_.push_back(acc_.accept());
+        }
+        else if (dg.len() > 0)
+        {
+            uint32_t seq;
+            ::memcpy(&seq, &dg.payload()[0], sizeof(seq));
+            if (seq != next_[id]++) failed_ = true;
+            ++received_;
+        }
+
+        gu_atomic_fetch_and_sub(&inside_, 1);
+    }
+
+    size_t received() const { return received_; }
+    bool   failed()   const { return failed_; }
+
+private:
+    Acceptor&                       acc_;
+    std::vector<SocketPtr>          sockets_;
+    std::map<const void*, uint32_t> next_;
+    size_t                          received_;
+    int                             inside_;
+    bool                            failed_;
+};
+
+START_TEST(test_asio_io_threads)
+{
+    gu::Config conf;
+    gu::ssl_register_params(conf);
+    gcomm::Conf::register_params(conf);
+    conf.set(gcomm::Conf::SocketIoThreads, "4");
+    AsioProtonet pn(conf);
+    string uri_str("tcp://127.0.0.1:0");
+
+    Acceptor* acc = pn.acceptor(uri_str);
+    acc->listen(uri_str);
+    uri_str = acc->listen_addr();
+
+    IoThreadsReceiver rcv(conf, *acc);
+    Protostack pstack;
+    pstack.push_proto(&rcv);
+    pn.insert(&pstack);
+
+    vector<SocketPtr> cls;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        cls.push_back(pn.socket(uri_str));
+        cls.back()->connect(uri_str);
+    }
+    for (size_t i = 0; i < 10; ++i)
+    {
+        pn.event_loop(gu::datetime::Sec/10);
+    }
+
+    size_t const n_msgs(1000);
+    vector<byte_t> buf(1024);
+    for (uint32_t seq = 0; seq < n_msgs; ++seq)
+    {
+        ::memcpy(&buf[0], &seq, sizeof(seq));
+        for (size_t i = 0; i < cls.size(); ++i)
+        {
+            ck_assert(cls[i]->state() == Socket::S_CONNECTED);
+            Datagram dg(Buffer(&buf[0], &buf[0] + buf.size()));
+            ck_assert(cls[i]->send(0, dg) == 0);
+        }
+    }
+
+    for (size_t i = 0; i < 100 && rcv.received() < n_msgs*cls.size(); ++i)
+    {
+        pn.event_loop(gu::datetime::Sec/10);
+    }
+
+    ck_assert_msg(rcv.received() == n_msgs*cls.size(),
+                  "received %zu", rcv.received());
+    ck_assert(!rcv.failed());
+
+    pn.erase(&pstack);
+    delete acc;
+}
+END_TEST
 #endif // HAVE_ASIO_HPP
 
 START_TEST(test_protonet)
@@ -94,6 +203,10 @@ Suite* util_nondet_suite()
     tc = tcase_create("test_asio");
     tcase_add_test(tc, test_asio);
     suite_add_tcase(s, tc);
+
+    tc = tcase_create("test_asio_io_threads");
+    tcase_add_test(tc, test_asio_io_threads);
+    suite_add_tcase(s, tc);
 #endif // HAVE_ASIO_HPP
 
     tc = tcase_create("test_protonet");
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/**
+ * This is to benchmark EVS input map message index operations, comparing
+ * std::map based index with the ring buffer index (InputMapMsgRing, used
+ * when built with GCOMM_EVS_INPUT_MAP_RING).
+ *
+ * Index is driven like InputMap does it during normal operation: each node
+ * has a window of undelivered messages in the message index, messages are
+ * delivered from the head of the index and moved to the recovery index,
+ * which is cleaned up to safe seqno. Some delivered messages are looked up
+ * from the recovery index as if for retransmission.
+ *
+ * Usage: evs_input_map_bench [nodes] [window] [seqnos]
+ */
+
+#define NDEBUG 1
+
+#include "evs_input_map2.hpp"
+
+#include <sys/time.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace gcomm;
+using namespace gcomm::evs;
+
+typedef Map<InputMapMsgKey, InputMapMsg> InputMapMsgTree;
+
+static double time_diff(const struct timeval& l,
+                        const struct timeval& r)
+{
+    double const left(double(l.tv_usec)*1.0e-06 + l.tv_sec);
+    double const right(double(r.tv_usec)*1.0e-06 + r.tv_sec);
+    return left - right;
+}
+
+template <class Index>
+static void
+run(const char* const name, const std::vector<UUID>& uuids,
+    size_t const window, seqno_t const seqnos)
+{
+    static seqno_t const safe_lag(16);
+
+    size_t const nodes(uuids.size());
+    ViewId const view_id(V_REG, uuids[0], 1);
+    Datagram const dg(gu::SharedBuffer(new gu::Buffer(128)));
+
+    Index msg_index;
+    Index recovery_index;
+
+    size_t found(0);
+    struct timeval tv_begin, tv_end;
+
+    gettimeofday(&tv_begin, NULL);
+    for (seqno_t seq(0); seq < seqnos + seqno_t(window); ++seq)
+    {
+        /* messages of the current seqno arrive, rotating node order */
+        for (size_t n(0); seq < seqnos && n < nodes; ++n)
+        {
+            size_t const idx((n + seq) % nodes);
+            UserMessage const msg(0, uuids[idx], view_id, seq, seq - 1, 0,
+                                  O_SAFE);
+            msg_index.insert_unique(
+                std::make_pair(InputMapMsgKey(idx, seq), InputMapMsg(msg, dg)));
+        }
+
+        /* deliver messages which fell out of the window */
+        seqno_t const deliver_seq(seq - window);
+        typename Index::iterator i;
+        while ((i = msg_index.begin()) != msg_index.end() &&
+               Index::key(i).seq() <= deliver_seq)
+        {
+            recovery_index.insert_unique(
+                std::make_pair(Index::key(i), Index::value(i)));
+            msg_index.erase(i);
+        }
+
+        /* retransmission lookup of a recently delivered message */
+        if (deliver_seq >= 0)
+        {
+            found += (recovery_index.find(
+                          InputMapMsgKey(seq % nodes, deliver_seq)) !=
+                      recovery_index.end());
+        }
+
+        /* safe messages are removed from recovery index */
+        seqno_t const safe_seq(deliver_seq - safe_lag);
+        if (safe_seq >= 0)
+        {
+            recovery_index.erase(recovery_index.begin(),
+                                 recovery_index.lower_bound(
+                                     InputMapMsgKey(0, safe_seq + 1)));
+        }
+    }
+    gettimeofday(&tv_end, NULL);
+
+    double const t(time_diff(tv_end, tv_begin));
+    size_t const msgs(nodes * seqnos);
+
+    std::cout << name << ": " << t * 1.0e9 / msgs << " ns/msg"
+              << ", found " << found
+              << ", left " << msg_index.size() << '/' << recovery_index.size()
+              << std::endl;
+}
+
+template <typename T>
+static void read_arg(char* argv[], int const i, T& val)
+{
+    std::istringstream is(argv[i]);
+    is >> val;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t  nodes(3);
+    size_t  window(64);
+    seqno_t seqnos(1 << 18);
+
+    if (argc >= 2) read_arg(argv, 1, nodes);
+    if (argc >= 3) read_arg(argv, 2, window);
+    if (argc >= 4) read_arg(argv, 3, seqnos);
+
+    if (0 == nodes)
+    {
+        std::cerr << "Number of nodes must be positive" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Running with parameters: nodes = " << nodes
+              << ", window = " << window
+              << ", seqnos = " << seqnos << std::endl;
+
+    std::vector<UUID> uuids;
+    for (size_t i(0); i < nodes; ++i)
+    {
+        uuids.push_back(UUID(int32_t(i + 1)));
+    }
+
+    run<InputMapMsgTree>("map ", uuids, window, seqnos);
+    run<InputMapMsgRing>("ring", uuids, window, seqnos);
+
+    return 0;
+}
@@ -24,6 +24,7 @@
 #include "gcs_seqno.hpp"
 #include "gcs_core.hpp"
 #include "gcs_fifo_lite.hpp"
+#include "gcs_recv_q.hpp"
 #include "gcs_sm.hpp"
 #include "gcs_gcache.hpp"
 
@@ -128,9 +129,10 @@ struct gcs_conn
     gu_thread_t      send_thread;
 
     /* A queue for threads waiting for received actions */
-    gu_fifo_t*   recv_q;
-    ssize_t      recv_q_size;
-    gu_thread_t  recv_thread;
+    gcs_recv_q_t* recv_q;
+    ssize_t       recv_q_size;
+    gu_mutex_t    recv_lock; // slave queue state: sync, FC limits
+    gu_thread_t   recv_thread;
 
     /* Message receiving timeout - absolute date in nanoseconds */
     long long    timeout;
@@ -180,14 +182,18 @@ struct gcs_conn
 
     /* sync control */
     bool         sync_sent_;
-    bool         sync_sent() const
+    bool         sync_sent()
     {
-        assert(gu_fifo_locked(recv_q));
+#ifdef GU_DEBUG_MUTEX
+        assert(gu_mutex_owned(&recv_lock));
+#endif
         return sync_sent_;
     }
     void         sync_sent(bool const val)
     {
-        assert(gu_fifo_locked(recv_q));
+#ifdef GU_DEBUG_MUTEX
+        assert(gu_mutex_owned(&recv_lock));
+#endif
         sync_sent_ = val;
     }
 
@@ -197,6 +203,10 @@ struct gcs_conn
 
     int inner_close_count; // how many times _close has been called.
     int outer_close_count; // how many times gcs_close has been called.
+
+    /* action batching */
+    gu_mutex_t        batch_lock;
+    struct gcs_batch* batch;   // batch open for new members, if any
 };
 
 // Oh C++, where art thou?
@@ -206,19 +216,62 @@ struct gcs_recv_act
     gcs_seqno_t         local_id;
 };
 
+struct gcs_batch;
+
 struct gcs_repl_act
 {
     const struct gu_buf* act_in;
     struct gcs_action*   action;
+    struct gcs_batch*    batch; // batch this action was sent in, if any
+    const void*          orig_buf; // action buffer before replication
+    gcs_repl_cb_t        cb;    // completion callback for async replication
+    void*                cb_ctx;
     gu_mutex_t           wait_mutex;
     gu_cond_t            wait_cond;
     gcs_repl_act(const struct gu_buf* a_act_in, struct gcs_action* a_action)
       :
         act_in(a_act_in),
-        action(a_action)
+        action(a_action),
+        batch(NULL),
+        orig_buf(a_action->buf),
+        cb(NULL),
+        cb_ctx(NULL)
     { }
 };
 
+/* Ordered actions from concurrent gcs_replv() callers coalesced into a single
+ * group message. Owned by its members, the last one to leave deletes it. */
+struct gcs_batch
+{
+    std::vector<struct gcs_repl_act*> acts;  // members in send order
+    std::vector<long>                 rets;  // send result for each member
+    std::vector<uint32_t>             sizes; // packed action size table
+    std::vector<struct gu_buf>        bufs;  // size table and action buffers
+    size_t    size;   // size of the packed action
+    int       refs;   // members still using the batch
+    bool      sent;   // rets are valid
+    gu_cond_t sent_cond;
+    gu_cond_t full_cond;
+
+    gcs_batch()
+        : acts(), rets(), sizes(), bufs(), size(0), refs(0), sent(false)
+    {
+        gu_cond_init (&sent_cond, NULL);
+        gu_cond_init (&full_cond, NULL);
+    }
+
+    ~gcs_batch()
+    {
+        gu_cond_destroy (&sent_cond);
+        gu_cond_destroy (&full_cond);
+    }
+
+    const struct gu_buf* local() const
+    {
+        return bufs.empty() ? NULL : &bufs[0];
+    }
+};
+
 /*! Releases resources associated with parameters */
 static void
 _cleanup_params (gcs_conn_t* conn)
@@ -312,7 +365,8 @@ gcs_create (gu_config_t* const conf, gcache_t* const gcache,
         else
         {
             gu_debug ("Requesting recv queue len: %zu", recv_q_len);
-            conn->recv_q = gu_fifo_create (recv_q_len, sizeof(struct gcs_recv_act));
+            conn->recv_q = gcs_recv_q_create (recv_q_len,
+                                              sizeof(struct gcs_recv_act));
         }
     }
     if (!conn->recv_q) {
@@ -338,12 +392,14 @@ gcs_create (gu_config_t* const conf, gcache_t* const gcache,
         GCS_CONN_DONOR : GCS_CONN_JOINED;
 
     gu_mutex_init (&conn->fc_lock, NULL);
+    gu_mutex_init (&conn->recv_lock, NULL);
+    gu_mutex_init (&conn->batch_lock, NULL);
 
     return conn; // success
 
 sm_create_failed:
 
-    gu_fifo_destroy (conn->recv_q);
+    gcs_recv_q_destroy (conn->recv_q);
 
 recv_q_failed:
 
@@ -416,7 +472,9 @@ gcs_send_fc_event (gcs_conn_t* conn, bool stop)
     return gcs_core_send_fc (conn->core, &fc, sizeof(fc));
 }
 
-/* To be called under slave queue lock. Returns true if FC_STOP must be sent */
+/* Returns true if FC_STOP must be sent, leaving fc_lock locked.
+ * Called by recv thread without other locks: slave queue length may change
+ * concurrently, so stop_sent is rechecked under fc_lock. */
 static inline bool
 gcs_fc_stop_begin (gcs_conn_t* conn)
 {
@@ -479,7 +537,9 @@ gcs_fc_stop_end (gcs_conn_t* conn)
     return ret;
 }
 
-/* To be called under slave queue lock. Returns true if FC_CONT must be sent */
+/* Returns true if FC_CONT must be sent, leaving fc_lock locked.
+ * Called by gcs_recv() callers concurrently, stop_sent is rechecked under
+ * fc_lock. */
 static inline bool
 gcs_fc_cont_begin (gcs_conn_t* conn)
 {
@@ -541,7 +601,7 @@ gcs_fc_cont_end (gcs_conn_t* conn)
     return ret;
 }
 
-/* To be called under slave queue lock. Returns true if SYNC must be sent */
+/* To be called under recv_lock. Returns true if SYNC must be sent */
 static inline bool
 gcs_send_sync_begin (gcs_conn_t* conn)
 {
@@ -583,9 +643,9 @@ gcs_send_sync_end (gcs_conn_t* conn)
         ret = 0;
     }
     else {
-        gu_fifo_lock(conn->recv_q);
+        gu_mutex_lock (&conn->recv_lock);
         conn->sync_sent(false);
-        gu_fifo_release(conn->recv_q);
+        gu_mutex_unlock (&conn->recv_lock);
     }
 
     ret = gcs_check_error (ret, "Failed to send SYNC signal");
@@ -596,9 +656,9 @@ gcs_send_sync_end (gcs_conn_t* conn)
 static inline long
 gcs_send_sync (gcs_conn_t* conn)
 {
-    gu_fifo_lock(conn->recv_q);
+    gu_mutex_lock (&conn->recv_lock);
     bool const send_sync(gcs_send_sync_begin (conn));
-    gu_fifo_release(conn->recv_q);
+    gu_mutex_unlock (&conn->recv_lock);
 
     if (send_sync) {
         return gcs_send_sync_end (conn);
@@ -830,17 +890,17 @@ gcs_become_joined (gcs_conn_t* conn)
 static void
 gcs_become_synced (gcs_conn_t* conn)
 {
-    gu_fifo_lock(conn->recv_q);
+    gu_mutex_lock (&conn->recv_lock);
     {
         gcs_shift_state (conn, GCS_CONN_SYNCED);
         conn->sync_sent(false);
     }
-    gu_fifo_release(conn->recv_q);
+    gu_mutex_unlock (&conn->recv_lock);
     gu_debug("Become synced, FC offset %ld", conn->fc_offset);
     conn->fc_offset = 0;
 }
 
-/* to be called under protection of both recv_q and fc_lock */
+/* to be called under protection of both recv_lock and fc_lock */
 static void
 _set_fc_limits (gcs_conn_t* conn)
 {
@@ -854,8 +914,8 @@ _set_fc_limits (gcs_conn_t* conn)
 
     /* The upper/lower limits cannot exceed the number of items in the
      * receive queue, so bound them by the max length. */
-    conn->upper_limit = std::min(conn->upper_limit, gu_fifo_max_length(conn->recv_q));
-    conn->lower_limit = std::min(conn->lower_limit, gu_fifo_max_length(conn->recv_q));
+    conn->upper_limit = std::min(conn->upper_limit, gcs_recv_q_max_length(conn->recv_q));
+    conn->lower_limit = std::min(conn->lower_limit, gcs_recv_q_max_length(conn->recv_q));
 
     gu_info ("Flow-control interval: [%ld, %ld]",
              conn->lower_limit, conn->upper_limit);
@@ -931,7 +991,7 @@ gcs_handle_act_conf (gcs_conn_t* conn, const void* action)
 
     conn->my_idx = conf->my_idx;
 
-    gu_fifo_lock(conn->recv_q);
+    gu_mutex_lock (&conn->recv_lock);
     {
         /* reset flow control as membership is most likely changed */
         if (!gu_mutex_lock (&conn->fc_lock)) {
@@ -969,7 +1029,7 @@ gcs_handle_act_conf (gcs_conn_t* conn, const void* action)
 
         conn->sync_sent(false);
     }
-    gu_fifo_release (conn->recv_q);
+    gu_mutex_unlock (&conn->recv_lock);
 
     if (conf->conf_id < 0) {
         if (0 == conf->memb_num) {
@@ -1133,9 +1193,9 @@ gcs_handle_actions (gcs_conn_t*          conn,
         break;
     case GCS_ACT_SYNC:
         if (rcvd->id < 0) {
-            gu_fifo_lock(conn->recv_q);
+            gu_mutex_lock (&conn->recv_lock);
             conn->sync_sent(false);
-            gu_fifo_release(conn->recv_q);
+            gu_mutex_unlock (&conn->recv_lock);
             gcs_send_sync(conn);
         } else {
             ret = gcs_handle_state_change (conn, &rcvd->act);
@@ -1150,10 +1210,11 @@ gcs_handle_actions (gcs_conn_t*          conn,
 }
 
 static inline void
-GCS_FIFO_PUSH_TAIL (gcs_conn_t* conn, ssize_t size)
+GCS_FIFO_PUSH_TAIL (gcs_conn_t* conn, const struct gcs_recv_act* act)
 {
-    conn->recv_q_size += size;
-    gu_fifo_push_tail(conn->recv_q);
+    gu_atomic_fetch_and_add (&conn->recv_q_size, act->rcvd.act.buf_len);
+    /* configuration change must be processed by application alone */
+    gcs_recv_q_push_tail (conn->recv_q, GCS_ACT_CONF == act->rcvd.act.type);
 }
 
 /* Returns true if timeout was handled and false otherwise */
@@ -1221,6 +1282,79 @@ _check_recv_queue_growth (gcs_conn_t* conn, ssize_t size)
     }
 }
 
+/*! Checks the outcome of replication after the action was delivered or purged
+ *  from repl_q, releasing the buffer of a failed action.
+ *
+ *  @return 0 on success, negative error code otherwise */
+static long
+_repl_result (gcs_conn_t* conn, struct gcs_repl_act* repl_act)
+{
+    struct gcs_action* const act = repl_act->action;
+    long ret = 0;
+
+#ifndef GCS_FOR_GARB
+    /* assert (act->buf != 0); */
+    if (act->buf == 0)
+    {
+        /* Recv thread purged repl_q before action was delivered */
+        return -ENOTCONN;
+    }
+#else
+    assert (act->buf == 0);
+#endif /* GCS_FOR_GARB */
+
+    if (act->seqno_g < 0) {
+        assert (GCS_SEQNO_ILL    == act->seqno_l ||
+                GCS_ACT_TORDERED != act->type);
+
+        if (act->seqno_g == GCS_SEQNO_ILL) {
+            /* action was not replicated for some reason */
+            assert (repl_act->orig_buf == act->buf);
+            ret = -EINTR;
+        }
+        else {
+            /* core provided an error code in global seqno */
+            assert (repl_act->orig_buf != act->buf);
+            ret = act->seqno_g;
+            act->seqno_g = GCS_SEQNO_ILL;
+        }
+
+        if (repl_act->orig_buf != act->buf) // action was allocated in gcache
+        {
+            gu_debug("Freeing gcache buffer %p after receiving %d",
+                     act->buf, ret);
+            gcs_gcache_free (conn->gcache, act->buf);
+            act->buf = repl_act->orig_buf;
+        }
+    }
+
+    return ret;
+}
+
+/*! Wakes up gcs_replv() caller waiting for the action or, if the action was
+ *  submitted by gcs_replv_async(), runs its completion callback */
+static void
+_repl_complete (gcs_conn_t* conn, struct gcs_repl_act* repl_act)
+{
+    if (repl_act->cb)
+    {
+        long const err(_repl_result (conn, repl_act));
+        struct gcs_action* const act = repl_act->action;
+
+        repl_act->cb (repl_act->cb_ctx, act, err ? err : act->size);
+
+        gu_mutex_destroy (&repl_act->wait_mutex);
+        gu_cond_destroy  (&repl_act->wait_cond);
+        delete repl_act;
+    }
+    else
+    {
+        gu_mutex_lock   (&repl_act->wait_mutex);
+        gu_cond_signal  (&repl_act->wait_cond);
+        gu_mutex_unlock (&repl_act->wait_mutex);
+    }
+}
+
 static long
 _close(gcs_conn_t* conn, bool join_recv_thread)
 {
@@ -1270,9 +1404,7 @@ _close(gcs_conn_t* conn, bool join_recv_thread)
             /* This will wake up repl threads in repl_q -
              * they'll quit on their own,
              * they don't depend on the conn object after waking */
-            gu_mutex_lock   (&act->wait_mutex);
-            gu_cond_signal  (&act->wait_cond);
-            gu_mutex_unlock (&act->wait_mutex);
+            _repl_complete (conn, act);
         }
         gcs_fifo_lite_close (conn->repl_q);
 
@@ -1280,8 +1412,188 @@ _close(gcs_conn_t* conn, bool join_recv_thread)
         // FIXME: this can block waiting for applicaiton threads to fetch all
         // items. In certain situations this can block forever. Ticket #113
         gu_info ("Closing slave action queue.");
-        gu_fifo_close (conn->recv_q);
+        gcs_recv_q_close (conn->recv_q);
+    }
+
+    return ret;
+}
+
+/*! Delivers received action either to the waiting gcs_repl() caller or to
+ *  the slave queue.
+ *
+ *  @return 0 on success, negative error code otherwise */
+static long
+_deliver_act (gcs_conn_t* conn, const struct gcs_act_rcvd& rcvd)
+{
+    gcs_seqno_t this_act_id = GCS_SEQNO_ILL;
+    struct gcs_repl_act** repl_act_ptr;
+    long ret = 0;
+
+    /* deliver to application (note matching assert in the bottom-half of
+     * gcs_repl()) */
+    if (gu_likely (rcvd.act.type != GCS_ACT_TORDERED ||
+                   (rcvd.id > 0 && (conn->global_seqno = rcvd.id)))) {
+        /* successful delivery - increment local order */
+        this_act_id = gu_atomic_fetch_and_add(&conn->local_act_id, 1);
+    }
+
+    if (NULL != rcvd.local                                          &&
+        (repl_act_ptr = (struct gcs_repl_act**)
+         gcs_fifo_lite_get_head (conn->repl_q))                     &&
+        (gu_likely ((*repl_act_ptr)->act_in == rcvd.local ||
+                    ((*repl_act_ptr)->batch &&
+                     (*repl_act_ptr)->batch->local() == rcvd.local)) ||
+         /* at this point repl_q is locked and we need to unlock it and
+          * return false to fall to the 'else' branch; unlikely case */
+         (gcs_fifo_lite_release (conn->repl_q), false)))
+    {
+        /* local action from repl_q */
+        struct gcs_repl_act* repl_act = *repl_act_ptr;
+        gcs_fifo_lite_pop_head (conn->repl_q);
+
+        assert (repl_act->action->type == rcvd.act.type);
+        assert (repl_act->action->size == rcvd.act.buf_len ||
+                repl_act->action->type == GCS_ACT_STATE_REQ);
+
+        repl_act->action->buf     = rcvd.act.buf;
+        repl_act->action->seqno_g = rcvd.id;
+        repl_act->action->seqno_l = this_act_id;
+
+        _repl_complete (conn, repl_act);
+    }
+    else if (gu_likely(this_act_id >= 0))
+    {
+        /* remote/non-repl'ed action */
+        struct gcs_recv_act* recv_act =
+            (struct gcs_recv_act*)gcs_recv_q_get_tail (conn->recv_q);
+
+        if (gu_likely (NULL != recv_act)) {
+
+            recv_act->rcvd     = rcvd;
+            recv_act->local_id = this_act_id;
+
+            conn->queue_len = gcs_recv_q_length (conn->recv_q) + 1;
+            bool const send_stop(gcs_fc_stop_begin(conn));
+
+            // release queue
+            GCS_FIFO_PUSH_TAIL (conn, recv_act);
+
+            if (gu_unlikely(GCS_CONN_JOINER == conn->state && !send_stop)) {
+                ret = _check_recv_queue_growth (conn, rcvd.act.buf_len);
+                assert (ret <= 0);
+                if (ret < 0) return ret;
+            }
+
+            if (gu_unlikely(send_stop) && (ret = gcs_fc_stop_end(conn))) {
+                gu_error ("gcs_fc_stop() returned %d: %s",
+                          ret, strerror(-ret));
+                return ret;
+            }
+        }
+        else {
+            assert (GCS_CONN_CLOSED == conn->state);
+            return -EBADFD;
+        }
+//            gu_info("Received foreign action of type %d, size %d, id=%llu, "
+//                    "action %p", rcvd.act.type, rcvd.act.buf_len,
+//                    this_act_id, rcvd.act.buf);
+    }
+    else if (conn->my_idx == rcvd.sender_idx)
+    {
+        gu_fatal("Protocol violation: unordered local action not in repl_q:"
+                 " { {%p, %zd, %s}, %ld, %lld }.",
+                 rcvd.act.buf, rcvd.act.buf_len,
+                 gcs_act_type_to_str(rcvd.act.type), rcvd.sender_idx,
+                 rcvd.id);
+        assert(0);
+        return -ENOTRECOVERABLE;
     }
+    else
+    {
+        gu_fatal ("Protocol violation: unordered remote action: "
+                  "{ {%p, %zd, %s}, %ld, %lld }",
+                  rcvd.act.buf, rcvd.act.buf_len,
+                  gcs_act_type_to_str(rcvd.act.type), rcvd.sender_idx,
+                  rcvd.id);
+        assert (0);
+        return -ENOTRECOVERABLE;
+    }
+
+    return 0;
+}
+
+/*! Unpacks received batch into separate actions with consecutive seqnos and
+ *  delivers them one by one. Each action is copied into its own buffer, so
+ *  that it can be released independently.
+ *
+ *  @return 0 on success, negative error code otherwise */
+static long
+_deliver_batch (gcs_conn_t* conn, const struct gcs_act_rcvd& rcvd)
+{
+    assert (GCS_ACT_TORDERED == rcvd.act.type);
+    assert (rcvd.batch > 0);
+
+    long ret = 0;
+
+#ifndef GCS_FOR_GARB
+    const uint8_t* const buf  = static_cast<const uint8_t*>(rcvd.act.buf);
+    size_t const         tab  = rcvd.batch * sizeof(uint32_t);
+    const uint8_t*       data = buf + tab;
+
+    size_t total = tab;
+    for (int i = 0; i < rcvd.batch && total <= (size_t)rcvd.act.buf_len; ++i)
+    {
+        uint32_t size;
+        memcpy (&size, buf + i * sizeof(uint32_t), sizeof(size));
+        total += gtohl(size);
+    }
+
+    if (gu_unlikely(total != (size_t)rcvd.act.buf_len)) {
+        gu_fatal ("Protocol violation: batch of %d actions has size %zd, "
+                  "expected %zu", rcvd.batch, rcvd.act.buf_len, total);
+        assert (0);
+        gcs_gcache_free (conn->gcache, rcvd.act.buf);
+        return -ENOTRECOVERABLE;
+    }
+#endif /* GCS_FOR_GARB */
+
+    for (int i = 0; i < rcvd.batch; ++i)
+    {
+        struct gcs_act_rcvd act(rcvd);
+
+        act.batch = 0;
+        if (rcvd.id > 0) act.id = rcvd.id + i;
+
+#ifndef GCS_FOR_GARB
+        uint32_t size;
+        memcpy (&size, buf + i * sizeof(uint32_t), sizeof(size));
+        size = gtohl(size);
+
+        void* const act_buf = gcs_gcache_malloc (conn->gcache, size);
+
+        if (gu_unlikely(NULL == act_buf)) {
+            gu_fatal ("Could not allocate memory for batched action of "
+                      "size: %u", size);
+            ret = -ENOMEM;
+            break;
+        }
+
+        memcpy (act_buf, data, size);
+        data += size;
+
+        act.act.buf     = act_buf;
+        act.act.buf_len = size;
+#else
+        /* actions are not stored locally at all */
+        act.act.buf_len = 0;
+#endif /* GCS_FOR_GARB */
+
+        if (gu_unlikely((ret = _deliver_act (conn, act)) < 0)) break;
+    }
+
+#ifndef GCS_FOR_GARB
+    gcs_gcache_free (conn->gcache, rcvd.act.buf);
+#endif
 
     return ret;
 }
@@ -1312,8 +1624,6 @@ static void *gcs_recv_thread (void *arg)
 
     while (conn->state < GCS_CONN_CLOSED)
     {
-        gcs_seqno_t this_act_id = GCS_SEQNO_ILL;
-        struct gcs_repl_act** repl_act_ptr;
         struct gcs_act_rcvd   rcvd;
 
         ret = gcs_core_recv (conn->core, &rcvd, conn->timeout);
@@ -1334,16 +1644,16 @@ static void *gcs_recv_thread (void *arg)
                 /* In the case of inconsistency our concern is to report it to
                  * replicator ASAP. Current contents of the slave queue are
                  * meaningless. */
-                gu_fifo_clear(conn->recv_q);
+                gcs_recv_q_clear(conn->recv_q);
             }
 
             struct gcs_recv_act* err_act =
-                (struct gcs_recv_act*) gu_fifo_get_tail(conn->recv_q);
+                (struct gcs_recv_act*) gcs_recv_q_get_tail(conn->recv_q);
 
             err_act->rcvd     = rcvd;
             err_act->local_id = GCS_SEQNO_ILL;
 
-            GCS_FIFO_PUSH_TAIL (conn, rcvd.act.buf_len);
+            GCS_FIFO_PUSH_TAIL (conn, err_act);
 
             break;
         }
@@ -1366,98 +1676,14 @@ static void *gcs_recv_thread (void *arg)
             if (gu_likely(ret <= 0)) continue; // not for application
         }
 
-        /* deliver to application (note matching assert in the bottom-half of
-         * gcs_repl()) */
-        if (gu_likely (rcvd.act.type != GCS_ACT_TORDERED ||
-                       (rcvd.id > 0 && (conn->global_seqno = rcvd.id)))) {
-            /* successful delivery - increment local order */
-            this_act_id = gu_atomic_fetch_and_add(&conn->local_act_id, 1);
+        if (gu_unlikely(rcvd.batch > 0)) {
+            ret = _deliver_batch (conn, rcvd);
         }
-
-        if (NULL != rcvd.local                                          &&
-            (repl_act_ptr = (struct gcs_repl_act**)
-             gcs_fifo_lite_get_head (conn->repl_q))                     &&
-            (gu_likely ((*repl_act_ptr)->act_in == rcvd.local)  ||
-             /* at this point repl_q is locked and we need to unlock it and
-              * return false to fall to the 'else' branch; unlikely case */
-             (gcs_fifo_lite_release (conn->repl_q), false)))
-        {
-            /* local action from repl_q */
-            struct gcs_repl_act* repl_act = *repl_act_ptr;
-            gcs_fifo_lite_pop_head (conn->repl_q);
-
-            assert (repl_act->action->type == rcvd.act.type);
-            assert (repl_act->action->size == rcvd.act.buf_len ||
-                    repl_act->action->type == GCS_ACT_STATE_REQ);
-
-            repl_act->action->buf     = rcvd.act.buf;
-            repl_act->action->seqno_g = rcvd.id;
-            repl_act->action->seqno_l = this_act_id;
-
-            gu_mutex_lock   (&repl_act->wait_mutex);
-            gu_cond_signal  (&repl_act->wait_cond);
-            gu_mutex_unlock (&repl_act->wait_mutex);
+        else {
+            ret = _deliver_act (conn, rcvd);
         }
-        else if (gu_likely(this_act_id >= 0))
-        {
-            /* remote/non-repl'ed action */
-            struct gcs_recv_act* recv_act =
-                (struct gcs_recv_act*)gu_fifo_get_tail (conn->recv_q);
-
-            if (gu_likely (NULL != recv_act)) {
-
-                recv_act->rcvd     = rcvd;
-                recv_act->local_id = this_act_id;
-
-                conn->queue_len = gu_fifo_length (conn->recv_q) + 1;
-                bool const send_stop(gcs_fc_stop_begin(conn));
-
-                // release queue
-                GCS_FIFO_PUSH_TAIL (conn, rcvd.act.buf_len);
-
-                if (gu_unlikely(GCS_CONN_JOINER == conn->state && !send_stop)) {
-                    ret = _check_recv_queue_growth (conn, rcvd.act.buf_len);
-                    assert (ret <= 0);
-                    if (ret < 0) break;
-                }
 
-                if (gu_unlikely(send_stop) && (ret = gcs_fc_stop_end(conn))) {
-                    gu_error ("gcs_fc_stop() returned %d: %s",
-                              ret, strerror(-ret));
-                    break;
-                }
-            }
-            else {
-                assert (GCS_CONN_CLOSED == conn->state);
-                ret = -EBADFD;
-                break;
-            }
-//            gu_info("Received foreign action of type %d, size %d, id=%llu, "
-//                    "action %p", rcvd.act.type, rcvd.act.buf_len,
-//                    this_act_id, rcvd.act.buf);
-        }
-        else if (conn->my_idx == rcvd.sender_idx)
-        {
-            gu_fatal("Protocol violation: unordered local action not in repl_q:"
-                     " { {%p, %zd, %s}, %ld, %lld }.",
-                     rcvd.act.buf, rcvd.act.buf_len,
-                     gcs_act_type_to_str(rcvd.act.type), rcvd.sender_idx,
-                     rcvd.id);
-            assert(0);
-            ret = -ENOTRECOVERABLE;
-            break;
-        }
-        else
-        {
-            gu_fatal ("Protocol violation: unordered remote action: "
-                      "{ {%p, %zd, %s}, %ld, %lld }",
-                      rcvd.act.buf, rcvd.act.buf_len,
-                      gcs_act_type_to_str(rcvd.act.type), rcvd.sender_idx,
-                      rcvd.id);
-            assert (0);
-            ret = -ENOTRECOVERABLE;
-            break;
-        }
+        if (gu_unlikely(ret < 0)) break;
     }
 
     if (ret > 0) {
@@ -1510,7 +1736,7 @@ long gcs_open (gcs_conn_t* conn, const char* channel, const char* url,
             if (!(ret = gu_thread_create (&conn->recv_thread, NULL,
                                           gcs_recv_thread, conn))) {
                 gcs_fifo_lite_open(conn->repl_q);
-                gu_fifo_open(conn->recv_q);
+                gcs_recv_q_open(conn->recv_q);
                 gcs_shift_state (conn, GCS_CONN_OPEN);
                 gu_debug ("Opened channel '%s'", channel);
                 conn->inner_close_count = 0;
@@ -1606,7 +1832,7 @@ long gcs_destroy (gcs_conn_t *conn)
         // We should still cleanup resources
     }
 
-    gu_fifo_destroy (conn->recv_q);
+    gcs_recv_q_destroy (conn->recv_q);
 
     gu_cond_destroy (&tmp_cond);
     gcs_sm_destroy (conn->sm);
@@ -1623,6 +1849,9 @@ long gcs_destroy (gcs_conn_t *conn)
 
     /* This must not last for long */
     while (gu_mutex_destroy (&conn->fc_lock));
+    gu_mutex_destroy (&conn->recv_lock);
+    assert (NULL == conn->batch);
+    gu_mutex_destroy (&conn->batch_lock);
 
     _cleanup_params (conn);
 
@@ -1681,6 +1910,252 @@ fc_active(gcs_conn_t* conn)
     return conn->stop_count > 0;
 }
 
+/*! Queues action for delivery and sends it, must be called in send monitor
+ *
+ * @return action size or negative error code */
+static long
+_repl_send (gcs_conn_t* conn, struct gcs_repl_act* repl_act)
+{
+    struct gcs_action* const act = repl_act->action;
+#ifndef NDEBUG
+    size_t const             act_size = act->size;
+#endif
+    struct gcs_repl_act**    act_ptr;
+    long                     ret = -ENOTCONN;
+
+    if ((act_ptr = (struct gcs_repl_act**)gcs_fifo_lite_get_tail (conn->repl_q)))
+    {
+        *act_ptr = repl_act;
+        gcs_fifo_lite_push_tail (conn->repl_q);
+
+        // Keep on trying until something else comes out
+        while ((ret = gcs_core_send (conn->core, repl_act->act_in, act->size,
+                                     act->type)) == -ERESTART) {}
+
+        if (ret < 0) {
+            /* remove item from the queue, it will never be delivered */
+            gu_warn ("Send action {%p, %zd, %s} returned %ld (%s)",
+                     act->buf, act->size,gcs_act_type_to_str(act->type),
+                     ret, strerror(-ret));
+
+            if (!gcs_fifo_lite_remove (conn->repl_q)) {
+                gu_fatal ("Failed to remove unsent item from repl_q");
+                assert(0);
+                ret = -ENOTRECOVERABLE;
+            }
+        }
+        else {
+            /* async action may be already completed and released here */
+            assert (ret == (ssize_t)act_size);
+        }
+    }
+
+    return ret;
+}
+
+static inline bool
+_batch_supported (gcs_conn_t* conn)
+{
+    int const ver(gcs_core_group_protocol_version (conn->core));
+    return (ver >= GCS_ACT_PROTO_BATCH && ver <= GCS_ACT_PROTO_MAX);
+}
+
+/*! Whether action may be packed together with other actions */
+static inline bool
+_batch_eligible (gcs_conn_t* conn, const struct gcs_action* act)
+{
+    return (conn->params.max_batch > 1 &&
+            GCS_ACT_TORDERED == act->type &&
+            act->size + sizeof(uint32_t) <= (size_t)conn->params.max_packet_size
+            && _batch_supported (conn));
+}
+
+static void
+_batch_release (gcs_conn_t* conn, struct gcs_batch* batch)
+{
+    gu_mutex_lock (&conn->batch_lock);
+    bool const last(0 == --batch->refs);
+    gu_mutex_unlock (&conn->batch_lock);
+
+    if (last) delete batch;
+}
+
+/*! Sends batch members packed into one action, or one by one if group
+ *  protocol does not allow it any more. Must be called in send monitor. */
+static void
+_batch_send (gcs_conn_t* conn, struct gcs_batch* batch)
+{
+    size_t const n(batch->acts.size());
+
+    batch->rets.resize(n);
+
+    if (1 == n || !_batch_supported (conn)) {
+        for (size_t i(0); i < n; ++i) {
+            batch->rets[i] = _repl_send (conn, batch->acts[i]);
+        }
+        return;
+    }
+
+    /* size table goes first, followed by action buffers */
+    batch->sizes.resize(n);
+    batch->bufs.push_back(gu_buf());
+    batch->bufs[0].ptr  = &batch->sizes[0];
+    batch->bufs[0].size = n * sizeof(uint32_t);
+    batch->size = batch->bufs[0].size;
+
+    for (size_t i(0); i < n; ++i) {
+        const struct gu_buf* buf(batch->acts[i]->act_in);
+        size_t               left(batch->acts[i]->action->size);
+
+        batch->sizes[i] = htogl(left);
+        batch->size    += left;
+
+        for (; left > 0; ++buf) {
+            struct gu_buf const b = { buf->ptr, std::min<ssize_t>(buf->size,
+                                                                  left) };
+            batch->bufs.push_back(b);
+            left -= b.size;
+        }
+    }
+
+    long   ret(-ENOTCONN);
+    size_t queued(0);
+
+    for (; queued < n; ++queued) {
+        struct gcs_repl_act** const act_ptr((struct gcs_repl_act**)
+            gcs_fifo_lite_get_tail (conn->repl_q));
+
+        if (!act_ptr) break;
+
+        *act_ptr = batch->acts[queued];
+        gcs_fifo_lite_push_tail (conn->repl_q);
+    }
+
+    if (queued == n) {
+        while ((ret = gcs_core_send_batch (conn->core, batch->local(),
+                                           batch->size, n)) == -ERESTART) {}
+    }
+
+    if (ret < 0) {
+        /* remove items from the queue, they will never be delivered */
+        gu_warn ("Send batch of %zu actions, size %zu returned %ld (%s)",
+                 n, batch->size, ret, strerror(-ret));
+
+        for (; queued > 0; --queued) {
+            if (!gcs_fifo_lite_remove (conn->repl_q)) {
+                gu_fatal ("Failed to remove unsent item from repl_q");
+                assert(0);
+                ret = -ENOTRECOVERABLE;
+            }
+        }
+    }
+    else {
+        assert (ret == (ssize_t)batch->size);
+    }
+
+    for (size_t i(0); i < n; ++i) {
+        batch->rets[i] = ret < 0 ? ret : batch->acts[i]->action->size;
+    }
+}
+
+/*! Adds action to the batch open for new members, or opens a new one. The
+ *  thread that opened the batch leaves the monitor to let others in, then
+ *  enters it once again to send the whole batch. Must be called in send
+ *  monitor, which is left on return.
+ *
+ * @return action size or negative error code */
+static long
+_batch_replv (gcs_conn_t* conn, struct gcs_repl_act* repl_act)
+{
+    size_t const size(repl_act->action->size + sizeof(uint32_t));
+    long         ret;
+
+    gu_mutex_lock (&conn->batch_lock);
+
+    struct gcs_batch* batch(conn->batch);
+
+    if (batch && batch->size + size > (size_t)conn->params.max_packet_size) {
+        /* does not fit, don't wait for the batch and send right away */
+        gu_mutex_unlock (&conn->batch_lock);
+        ret = _repl_send (conn, repl_act);
+        gcs_sm_leave (conn->sm);
+        return ret;
+    }
+
+    bool const leader(NULL == batch);
+
+    if (leader) {
+        batch = new gcs_batch();
+        conn->batch = batch;
+    }
+
+    size_t const idx(batch->acts.size());
+
+    batch->acts.push_back(repl_act);
+    batch->size += size;
+    batch->refs++;
+    repl_act->batch = batch;
+
+    if ((long)batch->acts.size() >= conn->params.max_batch) {
+        conn->batch = NULL; // close for new members
+        gu_cond_signal (&batch->full_cond);
+    }
+
+    gu_mutex_unlock (&conn->batch_lock);
+
+    gcs_sm_leave (conn->sm);
+
+    if (leader) {
+        long long const window(conn->params.batch_window);
+
+        if (window > 0) {
+            long long const deadline(gu_time_calendar() + window * 1000);
+            struct timespec ts;
+            ts.tv_sec  = deadline / 1000000000;
+            ts.tv_nsec = deadline % 1000000000;
+
+            gu_mutex_lock (&conn->batch_lock);
+            while (conn->batch == batch &&
+                   0 == gu_cond_timedwait (&batch->full_cond,
+                                           &conn->batch_lock, &ts)) {}
+            gu_mutex_unlock (&conn->batch_lock);
+        }
+
+        ret = gcs_sm_enter (conn->sm, &repl_act->wait_cond, false, true);
+
+        gu_mutex_lock (&conn->batch_lock);
+        if (conn->batch == batch) conn->batch = NULL;
+        gu_mutex_unlock (&conn->batch_lock);
+
+        if (0 == ret) {
+            if (GCS_CONN_OPEN >= conn->state) {
+                _batch_send (conn, batch);
+            }
+            else {
+                ret = -ENOTCONN;
+            }
+
+            gcs_sm_leave (conn->sm);
+        }
+
+        if (ret < 0) batch->rets.assign(batch->acts.size(), ret);
+
+        gu_mutex_lock (&conn->batch_lock);
+        batch->sent = true;
+        gu_cond_broadcast (&batch->sent_cond);
+    }
+    else {
+        gu_mutex_lock (&conn->batch_lock);
+        while (!batch->sent) gu_cond_wait (&batch->sent_cond, &conn->batch_lock);
+    }
+
+    ret = batch->rets[idx];
+
+    gu_mutex_unlock (&conn->batch_lock);
+
+    return ret;
+}
+
 /* Puts action in the send queue and returns after it is replicated */
 long gcs_replv (gcs_conn_t*          const conn,      //!<in
                 const struct gu_buf* const act_in,    //!<in
@@ -1713,95 +2188,42 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
         // 2. avoids race with gcs_close() and gcs_destroy()
         if (!(ret = gcs_sm_enter (conn->sm, &repl_act.wait_cond, scheduled, true)))
         {
-            struct gcs_repl_act** act_ptr;
-
-//#ifndef NDEBUG
-            const void* const orig_buf = act->buf;
-//#endif
+            bool in_monitor(true);
 
             // some hack here to achieve one if() instead of two:
             // ret = -EAGAIN part is a workaround for #569
-            // if (conn->state >= GCS_CONN_CLOSE) or (act_ptr == NULL)
-            // ret will be -ENOTCONN
+            // if (conn->state >= GCS_CONN_CLOSE) ret will be -ENOTCONN
             if ((ret = -EAGAIN,
                  !fc_active(conn) || act->type != GCS_ACT_TORDERED) &&
-                (ret = -ENOTCONN, GCS_CONN_OPEN >= conn->state)     &&
-                (act_ptr = (struct gcs_repl_act**)gcs_fifo_lite_get_tail (conn->repl_q)))
+                (ret = -ENOTCONN, GCS_CONN_OPEN >= conn->state))
             {
-                *act_ptr = &repl_act;
-                gcs_fifo_lite_push_tail (conn->repl_q);
-
-                // Keep on trying until something else comes out
-                while ((ret = gcs_core_send (conn->core, act_in, act->size,
-                                             act->type)) == -ERESTART) {}
-
-                if (ret < 0) {
-                    /* remove item from the queue, it will never be delivered */
-                    gu_warn ("Send action {%p, %zd, %s} returned %d (%s)",
-                             act->buf, act->size,gcs_act_type_to_str(act->type),
-                             ret, strerror(-ret));
-
-                    if (!gcs_fifo_lite_remove (conn->repl_q)) {
-                        gu_fatal ("Failed to remove unsent item from repl_q");
-                        assert(0);
-                        ret = -ENOTRECOVERABLE;
-                    }
+                if (_batch_eligible (conn, act)) {
+                    ret = _batch_replv (conn, &repl_act);
+                    in_monitor = false;
                 }
                 else {
-                    assert (ret == (ssize_t)act->size);
+                    ret = _repl_send (conn, &repl_act);
                 }
             }
 
-            gcs_sm_leave (conn->sm);
+            if (in_monitor) gcs_sm_leave (conn->sm);
 
             assert(ret);
 
             /* now we can go waiting for action delivery */
             if (ret >= 0) {
                 gu_cond_wait (&repl_act.wait_cond, &repl_act.wait_mutex);
-#ifndef GCS_FOR_GARB
-                /* assert (act->buf != 0); */
-                if (act->buf == 0)
-                {
-                    /* Recv thread purged repl_q before action was delivered */
-                    ret = -ENOTCONN;
-                    goto out;
-                }
-#else
-                assert (act->buf == 0);
-#endif /* GCS_FOR_GARB */
 
-                if (act->seqno_g < 0) {
-                    assert (GCS_SEQNO_ILL    == act->seqno_l ||
-                            GCS_ACT_TORDERED != act->type);
-
-                    if (act->seqno_g == GCS_SEQNO_ILL) {
-                        /* action was not replicated for some reason */
-                        assert (orig_buf == act->buf);
-                        ret = -EINTR;
-                    }
-                    else {
-                        /* core provided an error code in global seqno */
-                        assert (orig_buf != act->buf);
-                        ret = act->seqno_g;
-                        act->seqno_g = GCS_SEQNO_ILL;
-                    }
-
-                    if (orig_buf != act->buf) // action was allocated in gcache
-                    {
-                        gu_debug("Freeing gcache buffer %p after receiving %d",
-                                 act->buf, ret);
-                        gcs_gcache_free (conn->gcache, act->buf);
-                        act->buf = orig_buf;
-                    }
-                }
+                long const err(_repl_result (conn, &repl_act));
+                if (err) ret = err;
             }
         }
-#ifndef GCS_FOR_GARB
-    out:
-#endif /* GCS_FOR_GARB */
+
         gu_mutex_unlock  (&repl_act.wait_mutex);
     }
+
+    if (repl_act.batch) _batch_release (conn, repl_act.batch);
+
     gu_mutex_destroy (&repl_act.wait_mutex);
     gu_cond_destroy  (&repl_act.wait_cond);
 
@@ -1813,6 +2235,60 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
     return ret;
 }
 
+long gcs_replv_async (gcs_conn_t*          const conn,
+                      const struct gu_buf* const act_in,
+                      struct gcs_action*   const act,
+                      gcs_repl_cb_t        const cb,
+                      void*                const ctx,
+                      bool                 const scheduled)
+{
+    if (gu_unlikely((size_t)act->size > GCS_MAX_ACT_SIZE)) return -EMSGSIZE;
+
+    long ret;
+
+    assert (act);
+    assert (act->size > 0);
+    assert (cb);
+
+    act->seqno_l = GCS_SEQNO_ILL;
+    act->seqno_g = GCS_SEQNO_ILL;
+
+    /* outlives the call, released after completion callback */
+    struct gcs_repl_act* const repl_act(new gcs_repl_act(act_in, act));
+
+    repl_act->cb     = cb;
+    repl_act->cb_ctx = ctx;
+
+    gu_mutex_init (&repl_act->wait_mutex, NULL);
+    gu_cond_init  (&repl_act->wait_cond,  NULL);
+
+    if (!(ret = gcs_sm_enter (conn->sm, &repl_act->wait_cond, scheduled, true)))
+    {
+        if ((ret = -EAGAIN,
+             !fc_active(conn) || act->type != GCS_ACT_TORDERED) &&
+            (ret = -ENOTCONN, GCS_CONN_OPEN >= conn->state))
+        {
+            /* not batched: batch members wait for each other to be sent */
+            ret = _repl_send (conn, repl_act);
+        }
+
+        gcs_sm_leave (conn->sm);
+
+        assert(ret);
+    }
+
+    /* on success repl_act belongs to recv thread, otherwise it was never
+     * queued and callback won't be called */
+    if (ret < 0)
+    {
+        gu_mutex_destroy (&repl_act->wait_mutex);
+        gu_cond_destroy  (&repl_act->wait_cond);
+        delete repl_act;
+    }
+
+    return ret;
+}
+
 long gcs_request_state_transfer (gcs_conn_t  *conn,
                                  int          version,
                                  const void  *req,
@@ -1922,46 +2398,38 @@ long gcs_desync (gcs_conn_t* conn, gcs_seqno_t* local)
     }
 }
 
-static inline void
-GCS_FIFO_POP_HEAD (gcs_conn_t* conn, ssize_t size)
-{
-    assert (conn->recv_q_size >= size);
-    conn->recv_q_size -= size;
-    gu_fifo_pop_head (conn->recv_q);
-}
-
 /* Returns when an action from another process is received */
 long gcs_recv (gcs_conn_t*        conn,
                struct gcs_action* action)
 {
-    int                  err;
-    struct gcs_recv_act* recv_act = NULL;
+    int                 err;
+    struct gcs_recv_act recv_act;
 
     assert (action);
 
-    if ((recv_act = (struct gcs_recv_act*)gu_fifo_get_head (conn->recv_q, &err)))
+    /* taking CONF action cancels further gets until gcs_resume_recv() */
+    if (!(err = gcs_recv_q_pop_head (conn->recv_q, &recv_act)))
     {
-        conn->queue_len = gu_fifo_length (conn->recv_q) - 1;
-        bool send_cont  = gcs_fc_cont_begin   (conn);
-        bool send_sync  = gcs_send_sync_begin (conn);
-
-        action->buf     = (void*)recv_act->rcvd.act.buf;
-        action->size    = recv_act->rcvd.act.buf_len;
-        action->type    = recv_act->rcvd.act.type;
-        action->seqno_g = recv_act->rcvd.id;
-        action->seqno_l = recv_act->local_id;
-
-        if (gu_unlikely (GCS_ACT_CONF == action->type)) {
-            err = gu_fifo_cancel_gets (conn->recv_q);
-            if (err) {
-                gu_fatal ("Internal logic error: failed to cancel recv_q "
-                          "\"gets\": %d (%s). Aborting.",
-                          err, strerror(-err));
-                gu_abort();
-            }
+        action->buf     = (void*)recv_act.rcvd.act.buf;
+        action->size    = recv_act.rcvd.act.buf_len;
+        action->type    = recv_act.rcvd.act.type;
+        action->seqno_g = recv_act.rcvd.id;
+        action->seqno_l = recv_act.local_id;
+
+        assert (conn->recv_q_size >= action->size);
+        gu_atomic_fetch_and_sub (&conn->recv_q_size, action->size);
+
+        conn->queue_len = gcs_recv_q_length (conn->recv_q);
+        bool send_sync(false);
+
+        if (gu_unlikely(GCS_CONN_JOINED == conn->state)) {
+            gu_mutex_lock (&conn->recv_lock);
+            send_sync = gcs_send_sync_begin (conn);
+            gu_mutex_unlock (&conn->recv_lock);
         }
 
-        GCS_FIFO_POP_HEAD (conn, action->size); // release the queue
+        /* leaves fc_lock locked if returns true */
+        bool const send_cont(gcs_fc_cont_begin (conn));
 
         if (gu_unlikely(send_cont) && (err = gcs_fc_cont_end(conn))) {
             // We have successfully received an action, but failed to send
@@ -2011,7 +2479,7 @@ gcs_resume_recv (gcs_conn_t* conn)
 {
     int ret = GCS_CLOSED_ERROR;
 
-    ret = gu_fifo_resume_gets (conn->recv_q);
+    ret = gcs_recv_q_resume_gets (conn->recv_q);
 
     if (ret) {
         if (conn->state < GCS_CONN_CLOSED) {
@@ -2111,11 +2579,11 @@ gcs_seqno_t gcs_local_sequence(gcs_conn_t* conn)
 void
 gcs_get_stats (gcs_conn_t* conn, struct gcs_stats* stats)
 {
-    gu_fifo_stats_get (conn->recv_q,
-                       &stats->recv_q_len,
-                       &stats->recv_q_len_max,
-                       &stats->recv_q_len_min,
-                       &stats->recv_q_len_avg);
+    gcs_recv_q_stats_get (conn->recv_q,
+                          &stats->recv_q_len,
+                          &stats->recv_q_len_max,
+                          &stats->recv_q_len_min,
+                          &stats->recv_q_len_avg);
 
     stats->recv_q_size = conn->recv_q_size;
 
@@ -2142,7 +2610,7 @@ gcs_get_stats (gcs_conn_t* conn, struct gcs_stats* stats)
 void
 gcs_flush_stats(gcs_conn_t* conn)
 {
-    gu_fifo_stats_flush(conn->recv_q);
+    gcs_recv_q_stats_flush(conn->recv_q);
     gcs_sm_stats_flush (conn->sm);
     conn->stats_fc_stop_sent = 0;
     conn->stats_fc_cont_sent = 0;
@@ -2179,7 +2647,7 @@ _set_fc_limit (gcs_conn_t* conn, const char* value)
 
         if (limit > LONG_MAX) limit = LONG_MAX;
 
-        gu_fifo_lock(conn->recv_q);
+        gu_mutex_lock (&conn->recv_lock);
         {
             if (!gu_mutex_lock (&conn->fc_lock)) {
                 conn->params.fc_base_limit = limit;
@@ -2193,7 +2661,7 @@ _set_fc_limit (gcs_conn_t* conn, const char* value)
                 abort();
             }
         }
-        gu_fifo_release (conn->recv_q);
+        gu_mutex_unlock (&conn->recv_lock);
 
         return 0;
     }
@@ -2212,7 +2680,7 @@ _set_fc_factor (gcs_conn_t* conn, const char* value)
 
         if (factor == conn->params.fc_resume_factor) return 0;
 
-        gu_fifo_lock(conn->recv_q);
+        gu_mutex_lock (&conn->recv_lock);
         {
             if (!gu_mutex_lock (&conn->fc_lock)) {
                 conn->params.fc_resume_factor = factor;
@@ -2226,7 +2694,7 @@ _set_fc_factor (gcs_conn_t* conn, const char* value)
                 abort();
             }
         }
-        gu_fifo_release (conn->recv_q);
+        gu_mutex_unlock (&conn->recv_lock);
 
         return 0;
     }
@@ -2365,6 +2833,46 @@ _set_max_throttle (gcs_conn_t* conn, const char* value)
     }
 }
 
+static long
+_set_max_batch (gcs_conn_t* conn, const char* value)
+{
+    long long batch;
+    const char* const endptr = gu_str2ll (value, &batch);
+
+    if (batch > 0 && batch <= GCS_ACT_BATCH_MAX && *endptr == '\0') {
+
+        if (batch == conn->params.max_batch) return 0;
+
+        gu_config_set_int64 (conn->config, GCS_PARAMS_MAX_BATCH, batch);
+        conn->params.max_batch = batch;
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
+static long
+_set_batch_window (gcs_conn_t* conn, const char* value)
+{
+    long long window;
+    const char* const endptr = gu_str2ll (value, &window);
+
+    if (window >= 0 && window <= LONG_MAX && *endptr == '\0') {
+
+        if (window == conn->params.batch_window) return 0;
+
+        gu_config_set_int64 (conn->config, GCS_PARAMS_BATCH_WINDOW, window);
+        conn->params.batch_window = window;
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
 bool gcs_register_params (gu_config_t* const conf)
 {
     return (gcs_params_register (conf) | gcs_core_register (conf));
@@ -2396,6 +2904,12 @@ long gcs_param_set  (gcs_conn_t* conn, const char* key, const char *value)
     else if (!strcmp (key, GCS_PARAMS_MAX_THROTTLE)) {
         return _set_max_throttle (conn, value);
     }
+    else if (!strcmp (key, GCS_PARAMS_MAX_BATCH)) {
+        return _set_max_batch (conn, value);
+    }
+    else if (!strcmp (key, GCS_PARAMS_BATCH_WINDOW)) {
+        return _set_batch_window (conn, value);
+    }
 #ifdef GCS_SM_DEBUG
     else if (!strcmp (key, GCS_PARAMS_SM_DUMP)) {
         gcs_sm_dump_state(conn->sm, stderr);
@@ -2419,3 +2933,11 @@ void gcs_join_notification(gcs_conn_t* conn)
 {
      conn->need_to_join = true;
 }
+
+#ifdef GCS_CORE_TESTING
+gcs_core_t*
+gcs_get_core (gcs_conn_t* conn)
+{
+    return conn->core;
+}
+#endif /* GCS_CORE_TESTING */
@@ -231,6 +231,41 @@ static inline long gcs_repl (gcs_conn_t*        const conn,
     return gcs_replv (conn, &buf, action, scheduled);
 }
 
+/*! Completion callback of gcs_replv_async(). Called exactly once for every
+ * successfully submitted action, from the GCS receive thread or, if the
+ * connection is being closed, from gcs_close(), so it must not block and must
+ * not call back into GCS. Receives the same return code as gcs_replv() would
+ * give, with the action filled in the same way.
+ *
+ * @param ctx    context pointer passed to gcs_replv_async()
+ * @param action replicated action
+ * @param ret    negative error code, action size in case of success */
+typedef void (*gcs_repl_cb_t) (void* ctx, struct gcs_action* action, long ret);
+
+/*! @brief Replicates a vector of buffers as a single action without waiting
+ * for its delivery. Same as gcs_replv(), but returns as soon as the action is
+ * sent and reports the outcome through the completion callback, so that a
+ * few threads can keep many actions in flight. Blocks only while waiting to
+ * enter the send monitor or if too many actions are already in flight.
+ * Action buffer vector and action struct must remain valid until the
+ * callback is called.
+ *
+ * @param conn      group connection handle
+ * @param act_in    action buffer vector (total size is passed in action)
+ * @param action    action struct
+ * @param cb        completion callback
+ * @param ctx       context pointer to pass to the callback
+ * @param scheduled whether the call was preceded by gcs_schedule()
+ * @return          negative error code, in which case the callback won't be
+ *                  called, action size in case of success
+ */
+extern long gcs_replv_async (gcs_conn_t*          conn,
+                             const struct gu_buf* act_in,
+                             struct gcs_action*   action,
+                             gcs_repl_cb_t        cb,
+                             void*                ctx,
+                             bool                 scheduled);
+
 /*! @brief Receives an action from group.
  * Blocks if no actions are available. Action buffer is allocated by GCS
  * and must be freed by application when action is no longer needed.
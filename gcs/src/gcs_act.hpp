@@ -35,14 +35,17 @@ struct gcs_act_rcvd
     const struct gu_buf* local; // local buffer vector if any
     gcs_seqno_t    id;          // global total order seqno
     int            sender_idx;
-    gcs_act_rcvd() : act(), local(NULL), id(GCS_SEQNO_ILL), sender_idx(-1) { }
+    int            batch;       // number of actions packed, 0 if not a batch
+    gcs_act_rcvd() : act(), local(NULL), id(GCS_SEQNO_ILL), sender_idx(-1),
+                     batch(0) { }
     gcs_act_rcvd(const gcs_act& a, const struct gu_buf* loc,
                  gcs_seqno_t i, int si)
         :
         act(a),
         local(loc),
         id(i),
-        sender_idx(si)
+        sender_idx(si),
+        batch(0)
     { }
 };
 
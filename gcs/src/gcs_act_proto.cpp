@@ -5,7 +5,6 @@
  */
 /*
  * Interface to action protocol
- * (to be extended to support protocol versions, currently supports only v0)
  */
 #include <errno.h>
 #include "gcs_act_proto.hpp"
@@ -22,10 +21,21 @@ bytes: 00 01                07 08       11 12       15 16       19 20
 PV - protocol version
 AT - action type
 
+  Version 1 header structure is the same except for
+
+bytes: 16 17 18 19
+      +--+--+--+--+
+      |AT|rv|BCNT |
+      +--+--+--+--+
+
+BCNT - number of actions packed into the action (0 if not a batch), they are
+       preceded by a table of their 32-bit sizes.
+
 */
 
 static const size_t PROTO_PV_OFFSET       = 0;
 static const size_t PROTO_AT_OFFSET       = 16;
+static const size_t PROTO_BATCH_OFFSET    = 18;
 static const size_t PROTO_DATA_OFFSET     = 20;
 // static const size_t PROTO_ACT_ID_OFFSET   = 0;
 // static const size_t PROTO_ACT_SIZE_OFFSET = 8;
@@ -71,6 +81,13 @@ gcs_act_proto_write (gcs_act_frag_t* frag, void* buf, size_t buf_len)
     ((uint8_t *)buf)[PROTO_PV_OFFSET] = frag->proto_ver;
     ((uint8_t *)buf)[PROTO_AT_OFFSET] = frag->act_type;
 
+    if (frag->proto_ver >= GCS_ACT_PROTO_BATCH) {
+        assert (frag->batch >= 0 && frag->batch <= GCS_ACT_BATCH_MAX);
+        ((uint8_t *)buf)[PROTO_AT_OFFSET + 1] = 0;
+        *(uint16_t*)((uint8_t*)buf + PROTO_BATCH_OFFSET) =
+            htogs((uint16_t)frag->batch);
+    }
+
     frag->frag     = (uint8_t*)buf + PROTO_DATA_OFFSET;
     frag->frag_len = buf_len - PROTO_DATA_OFFSET;
 
@@ -104,6 +121,8 @@ gcs_act_proto_read (gcs_act_frag_t* frag, const void* buf, size_t buf_len)
     frag->frag_no  = gtohl  (((uint32_t*)buf)[3]);
     frag->act_type = static_cast<gcs_act_type_t>(
         ((uint8_t*)buf)[PROTO_AT_OFFSET]);
+    frag->batch    = frag->proto_ver < GCS_ACT_PROTO_BATCH ? 0 :
+        gtohs(*(uint16_t*)((uint8_t*)buf + PROTO_BATCH_OFFSET));
     frag->frag     = ((uint8_t*)buf) + PROTO_DATA_OFFSET;
     frag->frag_len = buf_len - PROTO_DATA_OFFSET;
 
@@ -17,8 +17,14 @@
 #include <stdint.h>
 typedef uint8_t gcs_proto_t;
 
-/*! Supported protocol range (for now only version 0 is supported) */
-#define GCS_ACT_PROTO_MAX 0
+/*! Supported protocol range */
+#define GCS_ACT_PROTO_MAX 1
+
+/*! First protocol version which can pack several actions into one */
+#define GCS_ACT_PROTO_BATCH 1
+
+/*! Maximum number of actions in a batch */
+#define GCS_ACT_BATCH_MAX 0xffff
 
 /*! Internal action fragment data representation */
 typedef struct gcs_act_frag
@@ -30,6 +36,7 @@ typedef struct gcs_act_frag
     unsigned long  frag_no;
     gcs_act_type_t act_type;
     int            proto_ver;
+    int            batch;    // number of actions packed, 0 if not a batch
 }
 gcs_act_frag_t;
 
@@ -81,6 +81,7 @@ struct gcs_core
 
 #ifdef GCS_CORE_TESTING
     gu_lock_step_t  ls;        // to lock-step in unit tests
+    gu_lock_step_t  recv_ls;   // to lock-step receiving in unit tests
     gu_uuid_t state_uuid;
 #endif
 };
@@ -102,7 +103,7 @@ typedef struct causal_act
     gu_cond_t*   cond;
 } causal_act_t;
 
-static int const GCS_PROTO_MAX = 0;
+static int const GCS_PROTO_MAX = GCS_ACT_PROTO_MAX;
 
 gcs_core_t*
 gcs_core_create (gu_config_t* const conf,
@@ -144,6 +145,7 @@ gcs_core_create (gu_config_t* const conf,
                     core->send_act_no = 1; // 0 == no actions sent
 #ifdef GCS_CORE_TESTING
                     gu_lock_step_init (&core->ls);
+                    gu_lock_step_init (&core->recv_ls);
                     core->state_uuid = GU_UUID_NIL;
 #endif
                     return core; // success
@@ -300,11 +302,12 @@ core_msg_send_retry (gcs_core_t*    core,
     return ret;
 }
 
-ssize_t
-gcs_core_send (gcs_core_t*          const conn,
-               const struct gu_buf* const action,
-               size_t                     act_size,
-               gcs_act_type_t       const act_type)
+static ssize_t
+core_send (gcs_core_t*          const conn,
+           const struct gu_buf* const action,
+           size_t                     act_size,
+           gcs_act_type_t       const act_type,
+           int                  const batch)
 {
     ssize_t        ret  = 0;
     ssize_t        sent = 0;
@@ -330,6 +333,10 @@ gcs_core_send (gcs_core_t*          const conn,
     frg.act_id    = conn->send_act_no; /* incremented for every new action */
     frg.frag_no   = 0;
     frg.proto_ver = proto_ver;
+    frg.batch     = batch;
+
+    if (gu_unlikely(batch > 0 && proto_ver < GCS_ACT_PROTO_BATCH))
+        return -EPROTO;
 
     if ((ret = gcs_act_proto_write (&frg, conn->send_buf, conn->send_buf_len)))
         return ret;
@@ -457,6 +464,25 @@ out:
     return ret;
 }
 
+ssize_t
+gcs_core_send (gcs_core_t*          const conn,
+               const struct gu_buf* const action,
+               size_t               const act_size,
+               gcs_act_type_t       const act_type)
+{
+    return core_send (conn, action, act_size, act_type, 0);
+}
+
+ssize_t
+gcs_core_send_batch (gcs_core_t*          const conn,
+                     const struct gu_buf* const action,
+                     size_t               const act_size,
+                     int                  const batch)
+{
+    assert (batch > 0);
+    return core_send (conn, action, act_size, GCS_ACT_TORDERED, batch);
+}
+
 /* A helper for gcs_core_recv().
  * Deals with fetching complete message from backend
  * and reallocates recv buf if needed */
@@ -1104,6 +1130,10 @@ ssize_t gcs_core_recv (gcs_core_t*          conn,
             goto out; /* backend error while receiving message */
         }
 
+#ifdef GCS_CORE_TESTING
+        gu_lock_step_wait (&conn->recv_ls); // pause before handling message
+#endif
+
         switch (recv_msg->type) {
         case GCS_MSG_ACTION:
             ret = core_handle_act_msg(conn, recv_msg, recv_act);
@@ -1243,6 +1273,7 @@ long gcs_core_destroy (gcs_core_t* core)
 
 #ifdef GCS_CORE_TESTING
     gu_lock_step_destroy (&core->ls);
+    gu_lock_step_destroy (&core->recv_ls);
 #endif
 
     gu_free (core);
@@ -1459,6 +1490,18 @@ gcs_core_send_step (gcs_core_t* core, long timeout_ms)
     return gu_lock_step_cont (&core->ls, timeout_ms);
 }
 
+void
+gcs_core_recv_lock_step (gcs_core_t* core, bool enable)
+{
+    gu_lock_step_enable (&core->recv_ls, enable);
+}
+
+long
+gcs_core_recv_step (gcs_core_t* core, long timeout_ms)
+{
+    return gu_lock_step_cont (&core->recv_ls, timeout_ms);
+}
+
 void
 gcs_core_set_state_uuid (gcs_core_t* core, const gu_uuid_t* uuid)
 {
@@ -105,6 +105,20 @@ gcs_core_send (gcs_core_t*          core,
                size_t               act_size,
                gcs_act_type_t       act_type);
 
+/*
+ * gcs_core_send_batch() sends batch ordered actions packed into one
+ * (see gcs_act_proto.cpp for format) to be delivered as batch consecutive
+ * GCS_ACT_TORDERED actions. Requires group protocol version of at least
+ * GCS_ACT_PROTO_BATCH, otherwise returns -EPROTO.
+ *
+ * NOT THREAD SAFE! Access should be serialized.
+ */
+extern ssize_t
+gcs_core_send_batch (gcs_core_t*          core,
+                     const struct gu_buf* act,
+                     size_t               act_size,
+                     int                  batch);
+
 /*
  * gcs_core_recv() blocks until some action is received from group.
  *
@@ -192,6 +206,19 @@ gcs_core_send_lock_step (gcs_core_t* core, bool enable);
 extern long
 gcs_core_send_step (gcs_core_t* core, long timeout_ms);
 
+// switches receive lock-step mode on/off
+extern void
+gcs_core_recv_lock_step (gcs_core_t* core, bool enable);
+
+// step through action receive process (handle another received message).
+// returns positive number if there was a recv thread waiting for it.
+extern long
+gcs_core_recv_step (gcs_core_t* core, long timeout_ms);
+
+// returns the core of the connection
+extern gcs_core_t*
+gcs_get_core (gcs_conn_t* conn);
+
 extern void
 gcs_core_set_state_uuid (gcs_core_t* core, const gu_uuid_t* uuid);
 
@@ -1437,6 +1437,7 @@ gcs_group_ignore_action (gcs_group_t* group, struct gcs_act_rcvd* act)
     act->act.buf_len = 0;
     act->act.type    = GCS_ACT_ERROR;
     act->sender_idx  = -1;
+    act->batch       = 0;
     assert (GCS_SEQNO_ILL == act->id);
 }
 
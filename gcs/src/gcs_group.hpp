@@ -182,6 +182,7 @@ gcs_group_handle_act_msg (gcs_group_t*          const group,
 
         rcvd->act.type = frg->act_type;
         rcvd->sender_idx = sender_idx;
+        rcvd->batch = frg->batch;
 
         if (gu_likely(GCS_ACT_TORDERED  == rcvd->act.type &&
                       GCS_GROUP_PRIMARY == group->state   &&
@@ -190,8 +191,10 @@ gcs_group_handle_act_msg (gcs_group_t*          const group,
                       commonly_supported_version)) {
             /* Common situation -
              * increment and assign act_id only for totally ordered actions
-             * and only in PRIM (skip messages while in state exchange) */
+             * and only in PRIM (skip messages while in state exchange).
+             * Batch takes a seqno per packed action, starting with rcvd->id */
             rcvd->id = ++group->act_id_;
+            if (rcvd->batch > 1) group->act_id_ += rcvd->batch - 1;
         }
         else if (GCS_ACT_TORDERED  == rcvd->act.type) {
             /* Rare situations */
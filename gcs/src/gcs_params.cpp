@@ -6,6 +6,7 @@
 
 #include "gcs_params.hpp"
 #include "gcs_fc.hpp" // gcs_fc_hard_limit_fix
+#include "gcs_act_proto.hpp" // GCS_ACT_BATCH_MAX
 
 #include "gu_inttypes.hpp"
 
@@ -20,6 +21,8 @@ const char* const GCS_PARAMS_MAX_PKT_SIZE      = "gcs.max_packet_size";
 const char* const GCS_PARAMS_RECV_Q_HARD_LIMIT = "gcs.recv_q_hard_limit";
 const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT = "gcs.recv_q_soft_limit";
 const char* const GCS_PARAMS_MAX_THROTTLE      = "gcs.max_throttle";
+const char* const GCS_PARAMS_MAX_BATCH         = "gcs.max_batch";
+const char* const GCS_PARAMS_BATCH_WINDOW      = "gcs.batch_window";
 #ifdef GCS_SM_DEBUG
 const char* const GCS_PARAMS_SM_DUMP           = "gcs.sm_dump";
 #endif /* GCS_SM_DEBUG */
@@ -33,6 +36,8 @@ static const char* const GCS_PARAMS_MAX_PKT_SIZE_DEFAULT      = "64500";
 static ssize_t const GCS_PARAMS_RECV_Q_HARD_LIMIT_DEFAULT     = SSIZE_MAX;
 static const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT_DEFAULT = "0.25";
 static const char* const GCS_PARAMS_MAX_THROTTLE_DEFAULT      = "0.25";
+static const char* const GCS_PARAMS_MAX_BATCH_DEFAULT         = "1";
+static const char* const GCS_PARAMS_BATCH_WINDOW_DEFAULT      = "0";
 
 bool
 gcs_params_register(gu_config_t* conf)
@@ -61,6 +66,10 @@ gcs_params_register(gu_config_t* conf)
                           GCS_PARAMS_RECV_Q_SOFT_LIMIT_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_MAX_THROTTLE,
                           GCS_PARAMS_MAX_THROTTLE_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_MAX_BATCH,
+                          GCS_PARAMS_MAX_BATCH_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_BATCH_WINDOW,
+                          GCS_PARAMS_BATCH_WINDOW_DEFAULT);
 #ifdef GCS_SM_DEBUG
     ret |= gu_config_add (conf, GCS_PARAMS_SM_DUMP, "0");
 #endif /* GCS_SM_DEBUG */
@@ -192,6 +201,13 @@ gcs_params_init (struct gcs_params* params, gu_config_t* config)
     if ((ret = params_init_long (config, GCS_PARAMS_MAX_PKT_SIZE, 0,LONG_MAX,
                                  &params->max_packet_size))) return ret;
 
+    if ((ret = params_init_long (config, GCS_PARAMS_MAX_BATCH,
+                                 1, GCS_ACT_BATCH_MAX,
+                                 &params->max_batch))) return ret;
+
+    if ((ret = params_init_long (config, GCS_PARAMS_BATCH_WINDOW, 0, LONG_MAX,
+                                 &params->batch_window))) return ret;
+
     if ((ret = params_init_double (config, GCS_PARAMS_FC_FACTOR, 0.0, 1.0,
                                    &params->fc_resume_factor))) return ret;
 
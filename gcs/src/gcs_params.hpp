@@ -17,6 +17,8 @@ struct gcs_params
     long    fc_base_limit;
     long    max_packet_size;
     long    fc_debug;
+    long    max_batch;     // max actions packed into one message, 1 - off
+    long    batch_window;  // microseconds to wait for a batch to fill up
     bool    fc_master_slave;
     bool    sync_donor;
 };
@@ -30,6 +32,8 @@ extern const char* const GCS_PARAMS_MAX_PKT_SIZE;
 extern const char* const GCS_PARAMS_RECV_Q_HARD_LIMIT;
 extern const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT;
 extern const char* const GCS_PARAMS_MAX_THROTTLE;
+extern const char* const GCS_PARAMS_MAX_BATCH;
+extern const char* const GCS_PARAMS_BATCH_WINDOW;
 #ifdef GCS_SM_DEBUG
 extern const char* const GCS_PARAMS_SM_DUMP;
 #endif /* GCS_SM_DEBUG */
@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ *
+ * Slave queue implementation, see gcs_recv_q.hpp
+ *
+ * Positions in the queue are ever increasing 64-bit counters:
+ * [head, tail) are the items in the queue, consumers may take only positions
+ * below limit, which is set past the first barrier item in the queue.
+ * Item memory is split in rows which are allocated when producer enters them
+ * and freed by producer when all items in a row were taken.
+ */
+
+#include "gcs_recv_q.hpp"
+
+#include <deque>
+#include <cstring>
+
+/* Don't make rows less than 1K items */
+#define GCS_RECV_Q_MIN_ROW_POWER 10
+
+#define GCS_RECV_Q_NO_LIMIT GU_LLONG_MAX
+
+struct gcs_recv_q
+{
+    /* written by consumers */
+    long long head;          // next position to take
+    int       used_min;
+    char      pad1[64];
+
+    /* written by producer */
+    long long tail;          // next position to put
+    long long reclaim;       // first row which was not freed yet
+    long long q_len;         // sum of queue lengths at push_tail()
+    long long q_len_samples;
+    int       used_max;
+    char      pad2[64];
+
+    /* control */
+    long long limit;         // consumers can't take positions beyond it
+    long long clear_pos;     // positions below it are skipped by consumers
+    int       canceled;      // barrier item was taken
+    int       closed;
+    long      get_wait;      // consumers sleeping on get_cond
+    int       put_wait;      // somebody sleeping on put_cond
+
+    int       col_shift;
+    long long col_mask;
+    long long row_len;
+    long long row_mask;
+    long long length;
+    size_t    item_size;
+    size_t    row_size;
+
+    gu_mutex_t  lock;
+    gu_cond_t   get_cond;
+    gu_cond_t   put_cond;
+
+    std::deque<long long> barriers; // barrier positions past the limit
+
+    long*  released;         // per row counters of taken items
+    void** rows;
+};
+
+#define RECV_Q_ROW(q,x) (((x) >> (q)->col_shift) & (q)->row_mask)
+#define RECV_Q_COL(q,x) ((x) & (q)->col_mask)
+
+#define RECV_Q_LOCK(q)                                                  \
+    if (gu_unlikely (gu_mutex_lock (&(q)->lock))) {                     \
+        gu_fatal ("Failed to lock recv queue");                         \
+        abort();                                                        \
+    }
+
+#define RECV_Q_UNLOCK(q) gu_mutex_unlock (&(q)->lock)
+
+template <typename T> static inline T
+recv_q_get (const T* const ptr)
+{
+    T ret;
+    gu_atomic_get (ptr, &ret);
+    return ret;
+}
+
+template <typename T> static inline void
+recv_q_set (T* const ptr, T const val)
+{
+    gu_atomic_set (ptr, &val);
+}
+
+gcs_recv_q_t* gcs_recv_q_create (size_t const length, size_t const item_size)
+{
+    int       row_pwr   = GCS_RECV_Q_MIN_ROW_POWER;
+    long long row_len   = 1LL << row_pwr;
+    int       array_pwr = 1; // need at least 2 rows for alteration
+    long long array_len = 1LL << array_pwr;
+
+    if (0 == length || 0 == item_size) return NULL;
+
+    /* find the best ratio of width and height as gu_fifo does:
+     * the size of a row array must be equal to that of the row */
+    while (array_len * row_len < (long long)length) {
+        if (array_len * (long long)sizeof(void*) <
+            row_len * (long long)item_size) {
+            array_len = 1LL << ++array_pwr;
+        }
+        else {
+            row_len = 1LL << ++row_pwr;
+        }
+    }
+
+    unsigned long long const max_size(array_len * row_len * item_size);
+
+    if (max_size > gu_avphys_bytes()) {
+        gu_error ("Maximum recv queue size %llu exceeds available memory "
+                  "limit %llu", max_size, gu_avphys_bytes());
+        return NULL;
+    }
+
+    gcs_recv_q_t* const q(new gcs_recv_q_t());
+
+    q->rows     = static_cast<void**>(gu_calloc (array_len, sizeof(void*)));
+    q->released = static_cast<long*> (gu_calloc (array_len, sizeof(long)));
+
+    if (!q->rows || !q->released) {
+        gu_error ("Failed to allocate %lld rows for recv queue", array_len);
+        gu_free (q->rows);
+        gu_free (q->released);
+        delete q;
+        return NULL;
+    }
+
+    q->used_min  = 0;
+    q->head      = 0;
+    q->tail      = 0;
+    q->reclaim   = 0;
+    q->q_len     = 0;
+    q->q_len_samples = 0;
+    q->used_max  = 0;
+    q->limit     = GCS_RECV_Q_NO_LIMIT;
+    q->clear_pos = 0;
+    q->canceled  = 0;
+    q->closed    = 0;
+    q->get_wait  = 0;
+    q->put_wait  = 0;
+    q->col_shift = row_pwr;
+    q->col_mask  = row_len - 1;
+    q->row_len   = row_len;
+    q->row_mask  = array_len - 1;
+    q->length    = array_len * row_len;
+    q->item_size = item_size;
+    q->row_size  = row_len * item_size;
+
+    gu_mutex_init (&q->lock,     NULL);
+    gu_cond_init  (&q->get_cond, NULL);
+    gu_cond_init  (&q->put_cond, NULL);
+
+    gu_debug ("Created recv queue of %lld items of size %zu, rows: %lld",
+              q->length, item_size, array_len);
+
+    return q;
+}
+
+/* wakes up a consumer sleeping in gcs_recv_q_pop_head() */
+static inline void
+recv_q_wake_getter (gcs_recv_q_t* const q)
+{
+    if (recv_q_get(&q->get_wait) > 0) {
+        RECV_Q_LOCK(q);
+        gu_cond_signal (&q->get_cond);
+        RECV_Q_UNLOCK(q);
+    }
+}
+
+/* wakes up producer waiting for free space or destructor */
+static inline void
+recv_q_wake_putter (gcs_recv_q_t* const q)
+{
+    if (recv_q_get(&q->put_wait)) {
+        RECV_Q_LOCK(q);
+        gu_cond_broadcast (&q->put_cond);
+        RECV_Q_UNLOCK(q);
+    }
+}
+
+/* frees rows in which all items were taken, producer only */
+static void
+recv_q_reclaim (gcs_recv_q_t* const q)
+{
+    while (q->reclaim + q->row_len <= q->tail) {
+        long long const row(RECV_Q_ROW(q, q->reclaim));
+
+        if (recv_q_get(&q->released[row]) < q->row_len) break;
+
+        gu_free (q->rows[row]);
+        q->rows[row] = NULL;
+        recv_q_set (&q->released[row], 0L);
+        q->reclaim += q->row_len;
+    }
+}
+
+void* gcs_recv_q_get_tail (gcs_recv_q_t* const q)
+{
+    long long const pos(q->tail);
+    long long const row(RECV_Q_ROW(q, pos));
+
+    if (0 == RECV_Q_COL(q, pos)) {
+
+        recv_q_reclaim (q);
+
+        if (gu_unlikely(NULL != q->rows[row])) {
+            /* row is still used from the previous round - queue is full */
+            RECV_Q_LOCK(q);
+            while (!q->closed) {
+                recv_q_set (&q->put_wait, 1);
+                recv_q_reclaim (q);
+                if (NULL == q->rows[row]) break;
+                gu_cond_wait (&q->put_cond, &q->lock);
+            }
+            recv_q_set (&q->put_wait, 0);
+            RECV_Q_UNLOCK(q);
+        }
+
+        if (gu_unlikely(recv_q_get(&q->closed))) return NULL;
+
+        if (NULL == q->rows[row]) {
+            q->rows[row] = gu_malloc (q->row_size);
+            if (gu_unlikely(NULL == q->rows[row])) {
+                gu_error ("Failed to allocate %zu bytes for recv queue row",
+                          q->row_size);
+                return NULL;
+            }
+        }
+    }
+    else if (gu_unlikely(recv_q_get(&q->closed))) {
+        return NULL;
+    }
+
+    return (static_cast<char*>(q->rows[row]) +
+            RECV_Q_COL(q, pos) * q->item_size);
+}
+
+void gcs_recv_q_push_tail (gcs_recv_q_t* const q, bool const barrier)
+{
+    long long const pos(q->tail);
+
+    if (gu_unlikely(barrier)) {
+        RECV_Q_LOCK(q);
+        if (GCS_RECV_Q_NO_LIMIT == q->limit)
+            recv_q_set (&q->limit, pos + 1);
+        else
+            q->barriers.push_back(pos);
+        RECV_Q_UNLOCK(q);
+    }
+
+    long long const used(pos - recv_q_get(&q->head));
+
+    gu_atomic_fetch_and_add (&q->q_len, used);
+    gu_atomic_fetch_and_add (&q->q_len_samples, 1);
+    if (gu_unlikely(used + 1 > recv_q_get(&q->used_max))) {
+        recv_q_set (&q->used_max, int(used + 1));
+    }
+
+    /* publish the item */
+    recv_q_set (&q->tail, pos + 1);
+
+    recv_q_wake_getter (q);
+}
+
+void gcs_recv_q_clear (gcs_recv_q_t* const q)
+{
+    recv_q_set (&q->clear_pos, q->tail);
+}
+
+/* moves limit past the next barrier, must be called under lock */
+static inline void
+recv_q_next_barrier (gcs_recv_q_t* const q)
+{
+    if (q->barriers.empty()) {
+        recv_q_set (&q->limit, GCS_RECV_Q_NO_LIMIT);
+    }
+    else {
+        recv_q_set (&q->limit, q->barriers.front() + 1);
+        q->barriers.pop_front();
+    }
+}
+
+/* @return -EAGAIN if there is nothing to take */
+static int
+recv_q_try_pop (gcs_recv_q_t* const q, void* const item)
+{
+    while (true) {
+        if (recv_q_get(&q->canceled)) return -ECANCELED;
+
+        long long const h  (recv_q_get(&q->head));
+        long long const lim(recv_q_get(&q->limit));
+        long long const t  (recv_q_get(&q->tail));
+
+        /* barrier was just taken, cancel is on the way */
+        if (h >= lim) return -EAGAIN;
+
+        if (h >= t) return recv_q_get(&q->closed) ? -ENODATA : -EAGAIN;
+
+        if (!gu_atomic_bool_compare_and_swap (&q->head, h, h + 1)) continue;
+
+        /* position h is ours now */
+        long long const row(RECV_Q_ROW(q, h));
+        bool const barrier(h + 1 == recv_q_get(&q->limit));
+        bool const skip(h < recv_q_get(&q->clear_pos));
+
+        if (gu_likely(!skip)) {
+            ::memcpy (item, static_cast<const char*>(q->rows[row]) +
+                      RECV_Q_COL(q, h) * q->item_size, q->item_size);
+        }
+
+        gu_atomic_fetch_and_add (&q->released[row], 1);
+        recv_q_wake_putter (q);
+
+        if (gu_unlikely(barrier)) {
+            RECV_Q_LOCK(q);
+            if (skip)
+                recv_q_next_barrier (q);
+            else
+                recv_q_set (&q->canceled, 1);
+            gu_cond_broadcast (&q->get_cond);
+            RECV_Q_UNLOCK(q);
+        }
+
+        if (gu_unlikely(skip)) continue;
+
+        int const used(recv_q_get(&q->tail) - h - 1LL);
+        if (gu_unlikely(used < recv_q_get(&q->used_min))) {
+            recv_q_set (&q->used_min, used);
+        }
+
+        return 0;
+    }
+}
+
+/* whether consumer has to wait, must be called under lock */
+static inline bool
+recv_q_get_blocked (gcs_recv_q_t* const q)
+{
+    if (recv_q_get(&q->canceled)) return false;
+
+    long long const h(recv_q_get(&q->head));
+
+    return (h >= recv_q_get(&q->limit) ||
+            (h >= recv_q_get(&q->tail) && !recv_q_get(&q->closed)));
+}
+
+int gcs_recv_q_pop_head (gcs_recv_q_t* const q, void* const item)
+{
+    int ret;
+
+    while (-EAGAIN == (ret = recv_q_try_pop (q, item))) {
+        RECV_Q_LOCK(q);
+        gu_atomic_fetch_and_add (&q->get_wait, 1);
+        if (recv_q_get_blocked (q)) gu_cond_wait (&q->get_cond, &q->lock);
+        gu_atomic_fetch_and_sub (&q->get_wait, 1);
+        RECV_Q_UNLOCK(q);
+    }
+
+    return ret;
+}
+
+int gcs_recv_q_resume_gets (gcs_recv_q_t* const q)
+{
+    int ret;
+
+    RECV_Q_LOCK(q);
+
+    if (q->canceled) {
+        recv_q_next_barrier (q);
+        recv_q_set (&q->canceled, 0);
+        gu_cond_broadcast (&q->get_cond);
+        ret = 0;
+    }
+    else {
+        gu_error ("Attempt to resume recv queue gets which were not canceled");
+        ret = -EBADFD;
+    }
+
+    RECV_Q_UNLOCK(q);
+
+    return ret;
+}
+
+void gcs_recv_q_close (gcs_recv_q_t* const q)
+{
+    RECV_Q_LOCK(q);
+    recv_q_set (&q->closed, 1);
+    gu_cond_broadcast (&q->get_cond);
+    gu_cond_broadcast (&q->put_cond);
+    RECV_Q_UNLOCK(q);
+}
+
+void gcs_recv_q_open (gcs_recv_q_t* const q)
+{
+    RECV_Q_LOCK(q);
+    q->barriers.clear();
+    recv_q_set (&q->limit, GCS_RECV_Q_NO_LIMIT);
+    recv_q_set (&q->canceled, 0);
+    recv_q_set (&q->closed, 0);
+    RECV_Q_UNLOCK(q);
+}
+
+long gcs_recv_q_length (const gcs_recv_q_t* const q)
+{
+    return recv_q_get(&q->tail) - recv_q_get(&q->head);
+}
+
+long gcs_recv_q_max_length (const gcs_recv_q_t* const q)
+{
+    /* a row can be reused only when all its items were taken */
+    return q->length - q->row_len;
+}
+
+void gcs_recv_q_stats_get (gcs_recv_q_t* const q, int* const q_len,
+                           int* const q_len_max, int* const q_len_min,
+                           double* const q_len_avg)
+{
+    *q_len     = gcs_recv_q_length (q);
+    *q_len_max = recv_q_get(&q->used_max);
+    *q_len_min = recv_q_get(&q->used_min);
+
+    long long const len    (recv_q_get(&q->q_len));
+    long long const samples(recv_q_get(&q->q_len_samples));
+
+    if (len >= 0 && samples > 0) {
+        *q_len_avg = double(len) / samples;
+    }
+    else {
+        *q_len_avg = (len >= 0 && samples >= 0) ? 0.0 : -1.0;
+    }
+}
+
+void gcs_recv_q_stats_flush (gcs_recv_q_t* const q)
+{
+    int const used(gcs_recv_q_length (q));
+
+    RECV_Q_LOCK(q);
+    recv_q_set (&q->used_max, used);
+    recv_q_set (&q->used_min, used);
+    recv_q_set (&q->q_len, 0LL);
+    recv_q_set (&q->q_len_samples, 0LL);
+    RECV_Q_UNLOCK(q);
+}
+
+/* number of items which were put but not released by consumers yet */
+static long long
+recv_q_unreleased (const gcs_recv_q_t* const q)
+{
+    long long ret(recv_q_get(&q->tail) - q->reclaim);
+
+    for (long long i(0); i <= q->row_mask; ++i) {
+        ret -= recv_q_get(&q->released[i]);
+    }
+
+    return ret;
+}
+
+void gcs_recv_q_destroy (gcs_recv_q_t* const q)
+{
+    gcs_recv_q_close (q);
+
+    /* wait until all items are fetched */
+    RECV_Q_LOCK(q);
+    recv_q_set (&q->put_wait, 1);
+    while (recv_q_unreleased (q) > 0) {
+        gu_warn ("Waiting for %ld items to be fetched.", gcs_recv_q_length(q));
+        gu_cond_wait (&q->put_cond, &q->lock);
+    }
+    RECV_Q_UNLOCK(q);
+
+    for (long long i(0); i <= q->row_mask; ++i) gu_free (q->rows[i]);
+
+    gu_free (q->rows);
+    gu_free (q->released);
+
+    gu_cond_destroy  (&q->put_cond);
+    gu_cond_destroy  (&q->get_cond);
+    gu_mutex_destroy (&q->lock);
+
+    delete q;
+}
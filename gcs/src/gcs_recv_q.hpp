@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ *
+ * Slave queue "class" customized for particular purpose: a single producer
+ * (GCS receive thread) and several consumers (gcs_recv() callers).
+ *
+ * Producer and consumers don't take locks on the fast path: producer
+ * publishes items by advancing the tail, consumers claim them by advancing
+ * the head with CAS. Mutex and conditions are used only to sleep when
+ * the queue is empty (or full) and for rare control operations.
+ *
+ * Like gu_fifo it can be very long, taking up minimum space when there are
+ * few items in the queue: rows of items are allocated and freed by producer
+ * as needed.
+ *
+ * Barrier items (configuration changes) cancel consumers when taken: all
+ * subsequent gets fail with -ECANCELED until gcs_recv_q_resume_gets() is
+ * called.
+ */
+
+#ifndef _GCS_RECV_Q_H_
+#define _GCS_RECV_Q_H_
+
+#include <galerautils.h>
+
+typedef struct gcs_recv_q gcs_recv_q_t;
+
+/*! Creates queue of at least length items */
+gcs_recv_q_t* gcs_recv_q_create  (size_t length, size_t item_size);
+/*! Waits until all items are taken and destroys the queue */
+void          gcs_recv_q_destroy (gcs_recv_q_t* q);
+/*! Stops accepting new items, consumers get -ENODATA when queue is empty */
+void          gcs_recv_q_close   (gcs_recv_q_t* q);
+/*! (Re)opens queue and resumes gets */
+void          gcs_recv_q_open    (gcs_recv_q_t* q);
+
+/*! Returns pointer to the tail item, blocks if queue is full.
+ *  Returns NULL if queue is closed. Producer only. */
+void*         gcs_recv_q_get_tail  (gcs_recv_q_t* q);
+/*! Publishes the tail item. Producer only.
+ *  @param barrier whether taking this item should cancel gets */
+void          gcs_recv_q_push_tail (gcs_recv_q_t* q, bool barrier);
+/*! Makes consumers skip all items currently in the queue. Producer only. */
+void          gcs_recv_q_clear     (gcs_recv_q_t* q);
+
+/*! Copies the head item into item and removes it from the queue,
+ *  blocks if queue is empty.
+ *  @retval 0          success
+ *  @retval -ENODATA   queue closed and empty
+ *  @retval -ECANCELED gets were canceled by a barrier item */
+int           gcs_recv_q_pop_head  (gcs_recv_q_t* q, void* item);
+/*! Resumes gets canceled by a barrier item */
+int           gcs_recv_q_resume_gets (gcs_recv_q_t* q);
+
+/*! Returns how many items are in the queue (unprotected) */
+long          gcs_recv_q_length     (const gcs_recv_q_t* q);
+/*! Returns the maximum number of items allowed in the queue */
+long          gcs_recv_q_max_length (const gcs_recv_q_t* q);
+/*! Returns how many items were in the queue on average per push_tail() */
+void          gcs_recv_q_stats_get  (gcs_recv_q_t* q, int* q_len,
+                                     int* q_len_max, int* q_len_min,
+                                     double* q_len_avg);
+/*! Flushes stats counters */
+void          gcs_recv_q_stats_flush(gcs_recv_q_t* q);
+
+#endif /* _GCS_RECV_Q_H_ */
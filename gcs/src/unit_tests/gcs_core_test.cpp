@@ -38,6 +38,7 @@
 
 #define GCS_STATE_MSG_ACCESS
 #include "../gcs_core.hpp"
+#include "../gcs_act_proto.hpp"
 #include "../gcs_dummy.hpp"
 #include "../gcs_seqno.hpp"
 #include "../gcs_state_msg.hpp"
@@ -943,6 +944,63 @@ END_TEST
 #endif /* GCS_ALLOW_GH74 */
 
 
+// several actions packed into one are given consecutive seqnos
+START_TEST (gcs_core_test_batch)
+{
+    gu::Config config;
+    core_test_init (&config);
+    gcs_core_send_lock_step (Core, false);
+
+    long ret;
+    uint32_t const sizes[3] = {
+        htogl(sizeof(act1_str)), htogl(sizeof(act2_str)), htogl(sizeof(act3_str))
+    };
+    const struct gu_buf batch[] = {
+        { sizes, sizeof(sizes) },
+        act1[0], act2[0], act2[1], act3[0], act3[1], act3[2], act3[3]
+    };
+    size_t const batch_size(sizeof(sizes) + sizeof(act1_str) +
+                            sizeof(act2_str) + sizeof(act3_str));
+
+    ck_assert(gcs_core_group_protocol_version(Core) >= GCS_ACT_PROTO_BATCH);
+
+    ret = gcs_core_send_batch (Core, batch, batch_size, 3);
+    ck_assert_msg(ret == (long)batch_size, "Expected %zu, got %ld (%s)",
+                  batch_size, ret, strerror (-ret));
+
+    struct gcs_act_rcvd rcvd;
+    ret = gcs_core_recv (Core, &rcvd, GU_TIME_ETERNITY);
+    ck_assert_msg(ret == (long)batch_size, "Expected %zu, got %ld (%s)",
+                  batch_size, ret, strerror (-ret));
+    ck_assert(GCS_ACT_TORDERED == rcvd.act.type);
+    ck_assert(batch == rcvd.local);
+    ck_assert(3 == rcvd.batch);
+    ck_assert_msg(Seqno + 1 == rcvd.id, "expected seqno %lld, got %lld",
+                  (long long)(Seqno + 1), (long long)rcvd.id);
+
+    const char* const buf(static_cast<const char*>(rcvd.act.buf));
+    ck_assert(!memcmp(buf, sizes, sizeof(sizes)));
+    ck_assert(!strcmp(buf + sizeof(sizes), act1_str));
+    ck_assert(!strcmp(buf + sizeof(sizes) + sizeof(act1_str), act2_str));
+    ck_assert(!strcmp(buf + batch_size - sizeof(act3_str), act3_str));
+    free (const_cast<void*>(rcvd.act.buf));
+    Seqno += 3;
+
+    // next action continues after the batch
+    ret = gcs_core_send (Core, act1, sizeof(act1_str), GCS_ACT_TORDERED);
+    ck_assert(ret == sizeof(act1_str));
+    action_t act_r;
+    act_r.in = act1;
+    ck_assert(!CORE_RECV_ACT(&act_r, act1_str, sizeof(act1_str),
+                             GCS_ACT_TORDERED));
+    ck_assert(0 == rcvd.sender_idx);
+    free (act_r.out);
+
+    gcs_core_send_lock_step (Core, true);
+    core_test_cleanup ();
+}
+END_TEST
+
 #if 0 // requires multinode support from gcs_dummy
 START_TEST (gcs_core_test_foreign)
 {
@@ -971,6 +1029,7 @@ Suite *gcs_core_suite(void)
   if (skip == false) {
       tcase_add_test  (tcase, gcs_core_test_api);
       tcase_add_test  (tcase, gcs_core_test_own);
+      tcase_add_test  (tcase, gcs_core_test_batch);
 #ifdef GCS_ALLOW_GH74
       tcase_add_test  (tcase, gcs_core_test_gh74);
 #endif /* GCS_ALLOW_GH74 */
@@ -0,0 +1,174 @@
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+
+// $Id$
+
+#include <check.h>
+#include "gcs_recv_q_test.hpp"
+#include "../gcs_recv_q.hpp"
+
+#define RECV_Q_LENGTH 10
+
+static void
+recv_q_put (gcs_recv_q_t* q, long val, bool barrier)
+{
+    long* const item((long*)gcs_recv_q_get_tail (q));
+    ck_assert(NULL != item);
+    *item = val;
+    gcs_recv_q_push_tail (q, barrier);
+}
+
+START_TEST (gcs_recv_q_test)
+{
+    long item;
+
+    ck_assert(NULL == gcs_recv_q_create (0, sizeof(long)));
+    ck_assert(NULL == gcs_recv_q_create (RECV_Q_LENGTH, 0));
+
+    gcs_recv_q_t* const q(gcs_recv_q_create (RECV_Q_LENGTH, sizeof(long)));
+    ck_assert(NULL != q);
+    long const max(gcs_recv_q_max_length (q));
+    ck_assert(max >= RECV_Q_LENGTH);
+
+    gcs_recv_q_open (q);
+
+    // several rounds over the whole queue to reuse rows
+    long next_put(0), next_get(0);
+    for (int round(0); round < 10; ++round) {
+        while (next_put - next_get < max) recv_q_put (q, next_put++, false);
+        ck_assert(gcs_recv_q_length (q) == max);
+
+        for (long i(0); i < max / 3; ++i) {
+            ck_assert(0 == gcs_recv_q_pop_head (q, &item));
+            ck_assert_msg(item == next_get, "got %ld, expected %ld",
+                          item, next_get);
+            ++next_get;
+        }
+    }
+    while (next_get < next_put) {
+        ck_assert(0 == gcs_recv_q_pop_head (q, &item));
+        ck_assert(item == next_get++);
+    }
+    ck_assert(0 == gcs_recv_q_length (q));
+
+    // barrier cancels gets until resumed
+    ck_assert(-EBADFD == gcs_recv_q_resume_gets (q));
+    recv_q_put (q, 1, false);
+    recv_q_put (q, 2, true);
+    recv_q_put (q, 3, false);
+    recv_q_put (q, 4, true);
+    ck_assert(0 == gcs_recv_q_pop_head (q, &item) && 1 == item);
+    ck_assert(0 == gcs_recv_q_pop_head (q, &item) && 2 == item);
+    ck_assert(-ECANCELED == gcs_recv_q_pop_head (q, &item));
+    ck_assert(-ECANCELED == gcs_recv_q_pop_head (q, &item));
+    ck_assert(0 == gcs_recv_q_resume_gets (q));
+    ck_assert(0 == gcs_recv_q_pop_head (q, &item) && 3 == item);
+    ck_assert(0 == gcs_recv_q_pop_head (q, &item) && 4 == item);
+    ck_assert(-ECANCELED == gcs_recv_q_pop_head (q, &item));
+    ck_assert(0 == gcs_recv_q_resume_gets (q));
+
+    // cleared items are skipped, including barriers
+    recv_q_put (q, 5, false);
+    recv_q_put (q, 6, true);
+    gcs_recv_q_clear (q);
+    recv_q_put (q, 7, false);
+    ck_assert(0 == gcs_recv_q_pop_head (q, &item) && 7 == item);
+
+    // closed queue gives away the remaining items
+    recv_q_put (q, 8, false);
+    gcs_recv_q_close (q);
+    ck_assert(NULL == gcs_recv_q_get_tail (q));
+    ck_assert(0 == gcs_recv_q_pop_head (q, &item) && 8 == item);
+    ck_assert(-ENODATA == gcs_recv_q_pop_head (q, &item));
+
+    gcs_recv_q_destroy (q);
+}
+END_TEST
+
+#define RECV_Q_ITEMS     200000
+#define RECV_Q_BARRIER   1000
+#define RECV_Q_CONSUMERS 4
+
+struct recv_q_ctx
+{
+    gcs_recv_q_t* q;
+    long          barrier;  // barrier being processed, if any
+    long          received;
+    long long     sum;
+    bool          failed;
+};
+
+static void*
+recv_q_consumer (void* arg)
+{
+    struct recv_q_ctx* const ctx((struct recv_q_ctx*)arg);
+    long item;
+    int  ret;
+
+    while (-ENODATA != (ret = gcs_recv_q_pop_head (ctx->q, &item))) {
+        if (-ECANCELED == ret) {
+            usleep (100);
+            continue;
+        }
+
+        long barrier;
+        gu_atomic_get (&ctx->barrier, &barrier);
+        if (barrier >= 0 && item > barrier) ctx->failed = true;
+
+        gu_atomic_fetch_and_add (&ctx->received, 1);
+        gu_atomic_fetch_and_add (&ctx->sum, item);
+
+        if (0 == item % RECV_Q_BARRIER) {
+            gu_atomic_set (&ctx->barrier, &item);
+            usleep (100); // let others try
+            long const none(-1);
+            gu_atomic_set (&ctx->barrier, &none);
+            if (gcs_recv_q_resume_gets (ctx->q)) ctx->failed = true;
+        }
+    }
+
+    return NULL;
+}
+
+START_TEST (gcs_recv_q_mt_test)
+{
+    struct recv_q_ctx ctx =
+        { gcs_recv_q_create (1 << 12, sizeof(long)), -1, 0, 0, false };
+    ck_assert(NULL != ctx.q);
+
+    gcs_recv_q_open (ctx.q);
+
+    gu_thread_t thds[RECV_Q_CONSUMERS];
+    for (int i(0); i < RECV_Q_CONSUMERS; ++i) {
+        ck_assert(0 == gu_thread_create (&thds[i], NULL, recv_q_consumer, &ctx));
+    }
+
+    long long sum(0);
+    for (long i(1); i <= RECV_Q_ITEMS; ++i) {
+        recv_q_put (ctx.q, i, 0 == i % RECV_Q_BARRIER);
+        sum += i;
+    }
+
+    gcs_recv_q_close (ctx.q);
+
+    for (int i(0); i < RECV_Q_CONSUMERS; ++i) gu_thread_join (thds[i], NULL);
+
+    ck_assert(!ctx.failed);
+    ck_assert_msg(RECV_Q_ITEMS == ctx.received, "received %ld items",
+                  ctx.received);
+    ck_assert(sum == ctx.sum);
+
+    gcs_recv_q_destroy (ctx.q);
+}
+END_TEST
+
+Suite *gcs_recv_q_suite(void)
+{
+  Suite *s  = suite_create("GCS receive queue");
+  TCase *tc = tcase_create("gcs_recv_q");
+
+  suite_add_tcase (s, tc);
+  tcase_add_test  (tc, gcs_recv_q_test);
+  tcase_add_test  (tc, gcs_recv_q_mt_test);
+  tcase_set_timeout(tc, 60);
+  return s;
+}
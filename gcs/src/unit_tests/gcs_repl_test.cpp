@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ *
+ * $Id$
+ */
+
+/*
+ * @file
+ *
+ * Defines unit tests for asynchronous replication with gcs_replv_async().
+ * Actions go through the whole GCS connection to a single node group of the
+ * dummy backend, the application side is modeled by a thread which receives
+ * and releases everything delivered to the slave queue.
+ */
+
+#include "../gcs.hpp"
+#include "../gcs_core.hpp"
+#include "../gcs_comp_msg.hpp"
+#include "../gcs_dummy.hpp"
+
+#include <galerautils.h>
+#include "gu_config.hpp"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gcs_repl_test.hpp"
+
+static gcs_conn_t* Conn = NULL;
+
+/* what the application has received so far */
+static struct repl_test_app
+{
+    gu_mutex_t  mtx;
+    gu_cond_t   cond;
+    gu_thread_t thread;
+    bool        synced; // SYNC action received
+    bool        left;   // self-leave configuration received
+} App;
+
+static void*
+repl_test_recv_thread (void* arg)
+{
+    struct gcs_action act;
+
+    while (gcs_recv (Conn, &act) > 0)
+    {
+        gu_mutex_lock (&App.mtx);
+
+        switch (act.type)
+        {
+        case GCS_ACT_CONF:
+        {
+            const gcs_act_conf_t* const conf
+                (static_cast<const gcs_act_conf_t*>(act.buf));
+            App.left = (conf->conf_id < 0 && 0 == conf->memb_num);
+            gcs_resume_recv (Conn);
+            break;
+        }
+        case GCS_ACT_SYNC:
+            App.synced = true;
+            break;
+        default:
+            break;
+        }
+
+        gu_cond_signal (&App.cond);
+        gu_mutex_unlock (&App.mtx);
+
+        free (const_cast<void*>(act.buf));
+    }
+
+    return NULL;
+}
+
+/* opens a single node group and waits until the node is synced */
+static void
+repl_test_open (gu::Config& config)
+{
+    long ret;
+
+    ck_assert(!gcs_register_params (reinterpret_cast<gu_config_t*>(&config)));
+
+    Conn = gcs_create (reinterpret_cast<gu_config_t*>(&config), NULL,
+                       "repl_test", "aaa.bbb.ccc.ddd:xxxx", 0, 0);
+    ck_assert(NULL != Conn);
+
+    gu_mutex_init (&App.mtx, NULL);
+    gu_cond_init  (&App.cond, NULL);
+    App.synced = false;
+    App.left   = false;
+
+    ret = gcs_open (Conn, "repl_test", "dummy://", true);
+    ck_assert_msg(0 == ret, "gcs_open(): %ld (%s)", ret, strerror(-ret));
+
+    ck_assert(0 == gu_thread_create (&App.thread, NULL, repl_test_recv_thread,
+                                     NULL));
+
+    gu_mutex_lock (&App.mtx);
+    while (!App.synced) gu_cond_wait (&App.cond, &App.mtx);
+    gu_mutex_unlock (&App.mtx);
+}
+
+static void
+repl_test_close ()
+{
+    long const ret(gcs_close (Conn));
+    ck_assert_msg(0 == ret, "gcs_close(): %ld (%s)", ret, strerror(-ret));
+
+    gu_thread_join (App.thread, NULL);
+}
+
+static void
+repl_test_destroy ()
+{
+    long const ret(gcs_destroy (Conn));
+    ck_assert_msg(0 == ret, "gcs_destroy(): %ld (%s)", ret, strerror(-ret));
+    Conn = NULL;
+
+    gu_cond_destroy  (&App.cond);
+    gu_mutex_destroy (&App.mtx);
+}
+
+/* completion callback context */
+struct repl_test_cb
+{
+    gu_mutex_t mtx;
+    gu_cond_t  cond;
+    long       calls;
+    long       ret;
+};
+
+static void
+repl_test_cb_init (struct repl_test_cb* cb)
+{
+    gu_mutex_init (&cb->mtx, NULL);
+    gu_cond_init  (&cb->cond, NULL);
+    cb->calls = 0;
+    cb->ret   = 0;
+}
+
+static void
+repl_test_cb_destroy (struct repl_test_cb* cb)
+{
+    gu_cond_destroy  (&cb->cond);
+    gu_mutex_destroy (&cb->mtx);
+}
+
+static void
+repl_test_cb_func (void* ctx, struct gcs_action* act, long ret)
+{
+    struct repl_test_cb* const cb(static_cast<struct repl_test_cb*>(ctx));
+
+    gu_mutex_lock (&cb->mtx);
+    cb->calls++;
+    cb->ret = ret;
+    gu_cond_signal (&cb->cond);
+    gu_mutex_unlock (&cb->mtx);
+}
+
+/* waits for the completion callback, returns the code it was called with */
+static long
+repl_test_cb_wait (struct repl_test_cb* cb)
+{
+    gu_mutex_lock (&cb->mtx);
+    while (0 == cb->calls) gu_cond_wait (&cb->cond, &cb->mtx);
+    long const ret(cb->ret);
+    gu_mutex_unlock (&cb->mtx);
+
+    return ret;
+}
+
+static const char act_str[] = "async action";
+static const struct gu_buf act_buf[1] = {
+    { act_str, sizeof(act_str) }
+};
+
+// callback is called with the action delivered
+START_TEST (gcs_repl_test_async)
+{
+    gu::Config config;
+    repl_test_open (config);
+
+    struct repl_test_cb cb;
+    repl_test_cb_init (&cb);
+
+    struct gcs_action act;
+    act.buf  = NULL;
+    act.size = sizeof(act_str);
+    act.type = GCS_ACT_TORDERED;
+
+    long ret = gcs_replv_async (Conn, act_buf, &act, repl_test_cb_func, &cb,
+                                false);
+    ck_assert_msg(ret == act.size, "gcs_replv_async(): %ld (%s)",
+                  ret, strerror(-ret));
+
+    ret = repl_test_cb_wait (&cb);
+    ck_assert_msg(ret == act.size, "Expected %zd, got %ld (%s)",
+                  act.size, ret, strerror(-ret));
+    ck_assert(act.seqno_g > 0);
+    ck_assert(act.seqno_l > 0);
+    ck_assert(NULL != act.buf);
+    ck_assert(!memcmp (act.buf, act_str, sizeof(act_str)));
+    free (const_cast<void*>(act.buf));
+
+    repl_test_close ();
+    repl_test_destroy ();
+
+    ck_assert(1 == cb.calls);
+    repl_test_cb_destroy (&cb);
+}
+END_TEST
+
+// callback gets the error code the group delivered the action with
+START_TEST (gcs_repl_test_async_error)
+{
+    gu::Config config;
+    repl_test_open (config);
+
+    struct repl_test_cb cb;
+    repl_test_cb_init (&cb);
+
+    /* state transfer request from a synced node is canceled by the group */
+    static const char req_str[] = "\0sst"; // any donor
+    const struct gu_buf req_buf = { req_str, sizeof(req_str) };
+
+    struct gcs_action act;
+    act.buf  = NULL;
+    act.size = sizeof(req_str);
+    act.type = GCS_ACT_STATE_REQ;
+
+    long ret = gcs_replv_async (Conn, &req_buf, &act, repl_test_cb_func, &cb,
+                                false);
+    ck_assert_msg(ret == act.size, "gcs_replv_async(): %ld (%s)",
+                  ret, strerror(-ret));
+
+    ret = repl_test_cb_wait (&cb);
+    ck_assert_msg(-ECANCELED == ret, "Expected %d, got %ld (%s)",
+                  -ECANCELED, ret, strerror(-ret));
+    ck_assert(GCS_SEQNO_ILL == act.seqno_g);
+    ck_assert(NULL == act.buf); // delivered buffer released
+
+    repl_test_close ();
+    repl_test_destroy ();
+
+    ck_assert(1 == cb.calls);
+    repl_test_cb_destroy (&cb);
+}
+END_TEST
+
+// callback is called by gcs_close() for the action which was not delivered
+START_TEST (gcs_repl_test_async_close)
+{
+    gu::Config config;
+    repl_test_open (config);
+
+    gcs_core_t*    const core(gcs_get_core (Conn));
+    gcs_backend_t* const backend(gcs_core_get_backend (core));
+
+    struct repl_test_cb cb;
+    repl_test_cb_init (&cb);
+
+    /* hold self-leave in the receive thread until the action is sent,
+     * so that the action follows it and is never delivered */
+    gcs_core_recv_lock_step (core, true);
+
+    gcs_comp_msg_t* const leave(gcs_comp_msg_leave (0));
+    ck_assert(NULL != leave);
+    long ret = gcs_dummy_inject_msg (backend, leave, gcs_comp_msg_size (leave),
+                                     GCS_MSG_COMPONENT, GCS_SENDER_NONE);
+    ck_assert_msg(ret > 0, "gcs_dummy_inject_msg(): %ld (%s)",
+                  ret, strerror(-ret));
+    gcs_comp_msg_delete (leave);
+
+    struct gcs_action act;
+    act.buf  = NULL;
+    act.size = sizeof(act_str);
+    act.type = GCS_ACT_TORDERED;
+
+    ret = gcs_replv_async (Conn, act_buf, &act, repl_test_cb_func, &cb, false);
+    ck_assert_msg(ret == act.size, "gcs_replv_async(): %ld (%s)",
+                  ret, strerror(-ret));
+
+    ck_assert(gcs_core_recv_step (core, 10000) > 0);
+    gcs_core_recv_lock_step (core, false);
+
+    gu_mutex_lock (&App.mtx);
+    while (!App.left) gu_cond_wait (&App.cond, &App.mtx);
+    gu_mutex_unlock (&App.mtx);
+
+    ck_assert(0 == cb.calls); // still in flight
+
+    repl_test_close ();
+
+    ck_assert(1 == cb.calls);
+    ck_assert_msg(-ENOTCONN == cb.ret, "Expected %d, got %ld (%s)",
+                  -ENOTCONN, cb.ret, strerror(-cb.ret));
+    ck_assert(GCS_SEQNO_ILL == act.seqno_g);
+    ck_assert(NULL == act.buf);
+
+    /* backend was left open by the injected self-leave, close it and
+     * drain the messages which were never received */
+    ck_assert(0 == backend->close (backend));
+
+    char           msg_buf[1024];
+    gcs_recv_msg_t msg(msg_buf, sizeof(msg_buf), 0, 0, GCS_MSG_ERROR);
+    while (backend->recv (backend, &msg, GU_TIME_ETERNITY) > 0) {}
+
+    repl_test_destroy ();
+
+    repl_test_cb_destroy (&cb);
+}
+END_TEST
+
+Suite *gcs_repl_suite(void)
+{
+    Suite *suite = suite_create("GCS asynchronous replication");
+    TCase *tcase = tcase_create("gcs_repl");
+
+    suite_add_tcase (suite, tcase);
+    tcase_set_timeout(tcase, 60);
+    tcase_add_test  (tcase, gcs_repl_test_async);
+    tcase_add_test  (tcase, gcs_repl_test_async_error);
+    tcase_add_test  (tcase, gcs_repl_test_async_close);
+
+    return suite;
+}
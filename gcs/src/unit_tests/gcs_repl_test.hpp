@@ -0,0 +1,12 @@
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+
+// $Id$
+
+#ifndef __gcs_repl_test__
+#define __gcs_repl_test__
+
+#include <check.h>
+
+Suite *gcs_repl_suite(void);
+
+#endif /* __gcs_repl_test__ */
@@ -14,6 +14,7 @@
 #include "gcs_sm_test.hpp"
 #include "gcs_state_msg_test.hpp"
 #include "gcs_fifo_test.hpp"
+#include "gcs_recv_q_test.hpp"
 #include "gcs_proto_test.hpp"
 #include "gcs_defrag_test.hpp"
 #include "gcs_node_test.hpp"
@@ -22,6 +23,7 @@
 #include "gcs_backend_test.hpp"
 #include "gcs_core_test.hpp"
 #include "gcs_fc_test.hpp"
+#include "gcs_repl_test.hpp"
 
 typedef Suite *(*suite_creator_t)(void);
 
@@ -31,6 +33,7 @@ static suite_creator_t suites[] =
 	gcs_send_monitor_suite,
 	gcs_state_msg_suite,
 	gcs_fifo_suite,
+	gcs_recv_q_suite,
 	gcs_proto_suite,
 	gcs_defrag_suite,
 	gcs_node_suite,
@@ -39,6 +42,7 @@ static suite_creator_t suites[] =
 	gcs_backend_suite,
 	gcs_core_suite,
 	gcs_fc_suite,
+	gcs_repl_suite,
 	NULL
     };
 